@@ -0,0 +1,136 @@
+#include <net/dns_cache.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+///
+/// \brief The ZipfianNames class draws names w/ the i-th most popular one drawn w/ a weight of 1/i^exponent.
+///
+class ZipfianNames
+{
+    std::vector<double> cdf;
+
+public:
+    ZipfianNames(std::size_t names_number, double exponent)
+        : cdf(names_number)
+    {
+        double sum{ 0.0 };
+        for (std::size_t i{ 0 }; i < names_number; ++i)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            this->cdf[i] = sum;
+        }
+
+        for (auto& value : this->cdf)
+        { value /= sum; }
+    }
+
+    template <typename Rng>
+    auto operator () (Rng& rng) const -> std::size_t
+    {
+        auto const point{ std::uniform_real_distribution<double>{ 0.0, 1.0 }(rng) };
+        auto const it{ std::lower_bound(this->cdf.begin(), this->cdf.end(), point) };
+        return std::min<std::size_t>(static_cast<std::size_t>(it - this->cdf.begin()), this->cdf.size() - 1);
+    }
+
+}; // ZipfianNames
+
+///
+/// \brief The Trace struct is a sequence of queried names: `scan_share` of them are one-off names, coming in
+/// bursts, the rest are Zipfian.
+///
+struct Trace
+{
+    std::vector<std::string> names;
+};
+
+auto generateTrace(
+    std::size_t requests_number,
+    std::size_t universe_size,
+    double      exponent,
+    double      scan_share,
+    std::size_t scan_burst
+) -> Trace
+{
+    Trace trace;
+    trace.names.reserve(requests_number);
+
+    ZipfianNames const zipfian{ universe_size, exponent };
+    std::mt19937_64 rng{ 42 };
+    std::bernoulli_distribution start_scan{ scan_share / static_cast<double>(scan_burst) };
+    std::size_t scanned{ 0 };
+
+    while (trace.names.size() < requests_number)
+    {
+        if (start_scan(rng))
+        {
+            for (std::size_t i{ 0 }; (i < scan_burst) and (trace.names.size() < requests_number); ++i)
+            { trace.names.push_back("scan" + std::to_string(scanned++) + ".flood.bench.domain"); }
+
+            continue;
+        }
+
+        trace.names.push_back("name" + std::to_string(zipfian(rng)) + ".bench.domain");
+    }
+
+    return trace;
+}
+
+///
+/// \return The hit ratio of a cache that's filled on the misses, the way a resolver uses it.
+///
+auto replay(Trace const& trace, std::size_t capacity, net::DNSCache::Admission admission) -> double
+{
+    net::DNSCache dns_cache{ capacity, 1, admission };
+    std::size_t hits{ 0 };
+
+    for (auto const& name : trace.names)
+    {
+        if (dns_cache.resolveRaw(name).has_value())
+        { ++hits; }
+        else
+        { dns_cache.update(name, net::IPV4Raw{ 0x01'01'01'01 }); }
+    }
+
+    return static_cast<double>(hits) / static_cast<double>(trace.names.size());
+}
+
+} // anonymous
+
+///
+/// Usage: bench_admission_hit_ratio [capacity] [requests] [universe] [exponent]
+///
+/// Replays Zipfian traces mixed w/ growing shares of one-off scan bursts, w/o and w/ the TinyLFU admission.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const capacity{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 10'000 };
+    std::size_t const requests{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 2'000'000 };
+    std::size_t const universe{ (3 < argc) ? std::strtoull(argv[3], nullptr, 10) : 1'000'000 };
+    double const exponent{ (4 < argc) ? std::strtod(argv[4], nullptr) : 0.9 };
+
+    std::cout << std::setw(12) << "scan share"
+              << std::setw(12) << "LRU"
+              << std::setw(12) << "TinyLFU" << '\n';
+
+    for (auto const scan_share : { 0.0, 0.1, 0.3, 0.5 })
+    {
+        auto const trace{ generateTrace(requests, universe, exponent, scan_share, 4 * capacity) };
+
+        std::cout << std::setw(12) << std::fixed << std::setprecision(2) << scan_share
+                  << std::setw(12) << std::setprecision(4)
+                  << replay(trace, capacity, net::DNSCache::Admission::ALWAYS)
+                  << std::setw(12)
+                  << replay(trace, capacity, net::DNSCache::Admission::TINY_LFU) << '\n';
+    }
+}
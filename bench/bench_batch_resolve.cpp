@@ -0,0 +1,124 @@
+#include <net/dns_cache.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+auto generateBenchNames(std::size_t names_number) -> std::vector<net::FQDN>
+{
+    std::vector<net::FQDN> names;
+    names.reserve(names_number);
+
+    for (std::size_t i{ 0 }; i < names_number; ++i)
+    { names.emplace_back("subd" + std::to_string(i) + ".subd0.subd0.bench.domain"); }
+
+    return names;
+}
+
+///
+/// \return `lookups` random picks of the `names`: the batches are their consecutive slices.
+///
+auto generateQueries(std::vector<net::FQDN> const& names, std::size_t lookups) -> std::vector<net::FQDN>
+{
+    std::vector<net::FQDN> queries;
+    queries.reserve(lookups);
+
+    std::mt19937_64 rng{ 42 };
+    std::uniform_int_distribution<std::size_t> pick{ 0, names.size() - 1 };
+    for (std::size_t i{ 0 }; i < lookups; ++i)
+    { queries.push_back(names[pick(rng)]); }
+
+    return queries;
+}
+
+template <typename Body>
+auto nsPerName(std::size_t names_number, Body&& body) -> double
+{
+    auto const start{ std::chrono::steady_clock::now() };
+    body();
+    auto const elapsed{ std::chrono::steady_clock::now() - start };
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(names_number);
+}
+
+} // anonymous
+
+///
+/// Usage: bench_batch_resolve [entries] [lookups] [batch]
+///
+/// Compares resolving (and updating) batches of random cached names w/ resolveBatch (updateBatch) against
+/// as many single resolveRaw (update) calls. The index is the one the library's built w/.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const entries{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 1'000'000 };
+    std::size_t const lookups{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 4'000'000 };
+    std::size_t const batch{ (3 < argc) ? std::strtoull(argv[3], nullptr, 10) : 64 };
+
+    auto const names{ generateBenchNames(entries) };
+    auto const queries{ generateQueries(names, lookups - (lookups % batch)) };
+    auto const names_number{ queries.size() };
+
+    net::DNSCache dns_cache{ entries };
+    for (std::size_t i{ 0 }; i < names.size(); ++i)
+    { dns_cache.update(names[i], static_cast<net::IPV4Raw>(i)); }
+
+    std::uint64_t checksum{ 0 };
+
+    auto const single_resolve_ns{
+        nsPerName(names_number, [&] {
+            for (auto const& name : queries)
+            { checksum += dns_cache.resolveRaw(name).value_or(0); }
+        })
+    };
+
+    std::vector<std::optional<net::IPV4Raw>> resolved(batch);
+    auto const batch_resolve_ns{
+        nsPerName(names_number, [&] {
+            for (std::size_t offset{ 0 }; offset < names_number; offset += batch)
+            {
+                core::Span<net::FQDN const> const names_batch{ queries.data() + offset, batch };
+                dns_cache.resolveBatch(names_batch, resolved);
+                for (auto const& ip : resolved)
+                { checksum += ip.value_or(0); }
+            }
+        })
+    };
+
+    std::vector<net::IPV4Raw> const raw_ips(batch, 0x01'01'01'01);
+    auto const single_update_ns{
+        nsPerName(names_number, [&] {
+            for (auto const& name : queries)
+            { dns_cache.update(name, raw_ips.front()); }
+        })
+    };
+
+    auto const batch_update_ns{
+        nsPerName(names_number, [&] {
+            for (std::size_t offset{ 0 }; offset < names_number; offset += batch)
+            {
+                core::Span<net::FQDN const> const names_batch{ queries.data() + offset, batch };
+                dns_cache.updateBatch(names_batch, raw_ips);
+            }
+        })
+    };
+
+    if (0 == checksum)
+    { std::cerr << "warning: nothing resolved\n"; }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "entries:        " << entries << ", batches of " << batch << '\n'
+              << "resolveRaw:     " << single_resolve_ns << " ns/name\n"
+              << "resolveBatch:   " << batch_resolve_ns << " ns/name\n"
+              << "update:         " << single_update_ns << " ns/name\n"
+              << "updateBatch:    " << batch_update_ns << " ns/name\n";
+}
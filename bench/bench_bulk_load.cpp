@@ -0,0 +1,85 @@
+#include <net/dns_cache.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+template <typename Body>
+auto seconds(Body&& body) -> double
+{
+    auto const start{ std::chrono::steady_clock::now() };
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto address(std::size_t i) -> std::string
+{
+    return "10." + std::to_string((i >> 16) & 0xFF) + "." + std::to_string((i >> 8) & 0xFF) + "."
+         + std::to_string(i & 0xFF);
+}
+
+} // anonymous
+
+///
+/// Usage: bench_bulk_load [entries] [shards] [path]
+///
+/// Writes a hosts file, then seeds a cache from it line by line w/ update() and once more w/ bulkLoad().
+/// The file's in the page cache by then for both.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const entries{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 1'000'000 };
+    std::size_t const shards{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 1 };
+    std::string const path{ (3 < argc) ? argv[3] : "bench_bulk_load.hosts" };
+
+    {
+        std::ofstream file{ path };
+        for (std::size_t i{ 0 }; i < entries; ++i)
+        { file << address(i) << " subd" << i << ".subd0.subd0.bench.domain\n"; }
+    }
+
+    std::size_t updated{ 0 };
+    double update_s{ 0.0 };
+    {
+        net::DNSCache dns_cache{ entries, shards };
+        update_s = seconds([&]
+                           {
+                               std::ifstream file{ path };
+                               std::string ip;
+                               std::string fqdn;
+                               while (file >> ip >> fqdn)
+                               {
+                                   dns_cache.update(fqdn, ip);
+                                   ++updated;
+                               }
+                           });
+    }
+
+    std::size_t loaded{ 0 };
+    double load_s{ 0.0 };
+    {
+        net::DNSCache dns_cache{ entries, shards };
+        load_s = seconds([&] { loaded = dns_cache.bulkLoad(path); });
+    }
+
+    std::remove(path.c_str());
+
+    if ((updated != entries) or (loaded != entries))
+    { std::cerr << "warning: updated " << updated << ", loaded " << loaded << " of " << entries << '\n'; }
+
+    auto const perEntry{ [&] (double s) { return s * 1e9 / static_cast<double>(entries); } };
+    std::cout << std::fixed << std::setprecision(3)
+              << "entries:  " << entries << ", shards: " << shards << '\n'
+              << "update(): " << update_s << " s (" << std::setprecision(1) << perEntry(update_s) << " ns/entry)\n"
+              << std::setprecision(3)
+              << "bulkLoad: " << load_s << " s (" << std::setprecision(1) << perEntry(load_s) << " ns/entry)\n";
+}
@@ -0,0 +1,360 @@
+#include <net/dns_cache.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+///
+/// \brief The BenchConfig struct is the suite's knobs, all settable as `--name=value`.
+///
+struct BenchConfig
+{
+    std::size_t capacity{ 100'000 };
+    std::size_t names{ 400'000 };           // The universe the workloads draw from.
+    std::size_t shards{ 16 };
+    std::size_t max_threads{ std::max<std::size_t>(1, std::thread::hardware_concurrency()) };
+    std::size_t ops_per_thread{ 1'000'000 };
+    double      read_ratio{ 0.9 };
+    double      zipf_exponent{ 0.99 };
+    double      scan_share{ 0.3 };          // Of the scan workload's ops.
+    std::string workload{ "all" };          // uniform, zipfian, scan or all.
+    std::string admission{ "always" };      // always or tiny_lfu.
+    bool        l1{ false };                // The thread-local L1 in front of the resolves.
+};
+
+auto parseConfig(int argc, char const* argv[]) -> BenchConfig
+{
+    BenchConfig config{};
+    for (int i{ 1 }; i < argc; ++i)
+    {
+        std::string_view const arg{ argv[i] };
+        auto const separator{ arg.find('=') };
+        if ((0 != arg.rfind("--", 0)) or (std::string_view::npos == separator))
+        { throw std::invalid_argument{ "Expected --name=value, got: " + std::string{ arg } }; }
+
+        auto const name{ arg.substr(2, separator - 2) };
+        std::string const value{ arg.substr(separator + 1) };
+
+        if ("capacity" == name)
+        { config.capacity = std::stoull(value); }
+        else if ("names" == name)
+        { config.names = std::stoull(value); }
+        else if ("shards" == name)
+        { config.shards = std::stoull(value); }
+        else if ("threads" == name)
+        { config.max_threads = std::stoull(value); }
+        else if ("ops" == name)
+        { config.ops_per_thread = std::stoull(value); }
+        else if ("read-ratio" == name)
+        { config.read_ratio = std::stod(value); }
+        else if ("zipf" == name)
+        { config.zipf_exponent = std::stod(value); }
+        else if ("scan-share" == name)
+        { config.scan_share = std::stod(value); }
+        else if ("workload" == name)
+        { config.workload = value; }
+        else if ("admission" == name)
+        { config.admission = value; }
+        else if ("l1" == name)
+        {
+            if (("on" != value) and ("off" != value))
+            { throw std::invalid_argument{ "Expected --l1=on|off, got: " + value }; }
+
+            config.l1 = ("on" == value);
+        }
+        else
+        { throw std::invalid_argument{ "Unknown option: " + std::string{ name } }; }
+    }
+
+    if (("all" != config.workload) and ("uniform" != config.workload) and ("zipfian" != config.workload) and
+        ("scan" != config.workload))
+    { throw std::invalid_argument{ "Unknown workload: " + config.workload }; }
+
+    if (("always" != config.admission) and ("tiny_lfu" != config.admission))
+    { throw std::invalid_argument{ "Unknown admission: " + config.admission }; }
+
+    if ((0 == config.names) or (0 == config.ops_per_thread))
+    { throw std::invalid_argument{ "Nothing to run!" }; }
+
+    auto const min_shard_capacity{
+        (("tiny_lfu" == config.admission) ? 2 : 1) * net::DNSCache::minViableCapacity()
+    };
+    if ((0 == config.shards) or ((config.capacity / config.shards) < min_shard_capacity))
+    { throw std::invalid_argument{ "Too many shards for the capacity!" }; }
+
+    return config;
+}
+
+auto benchName(std::size_t i) -> net::FQDN
+{ return "subd" + std::to_string(i) + ".bench.domain"; }
+
+///
+/// \brief The ZipfianNames class draws names w/ the i-th most popular one drawn w/ a weight of 1/i^exponent.
+///
+class ZipfianNames
+{
+    std::vector<double> cdf;
+
+public:
+    ZipfianNames(std::size_t names_number, double exponent)
+        : cdf(names_number)
+    {
+        double sum{ 0.0 };
+        for (std::size_t i{ 0 }; i < names_number; ++i)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            this->cdf[i] = sum;
+        }
+
+        for (auto& value : this->cdf)
+        { value /= sum; }
+    }
+
+    template <typename Rng>
+    auto operator () (Rng& rng) const -> std::size_t
+    {
+        auto const point{ std::uniform_real_distribution<double>{ 0.0, 1.0 }(rng) };
+        auto const it{ std::lower_bound(this->cdf.begin(), this->cdf.end(), point) };
+        return std::min<std::size_t>(static_cast<std::size_t>(it - this->cdf.begin()), this->cdf.size() - 1);
+    }
+
+}; // ZipfianNames
+
+///
+/// \brief The Op struct is a pre-generated operation: the drawing is kept out of the timed loop.
+///
+struct Op
+{
+    net::FQDN fqdn;
+    bool      is_read{};
+};
+
+///
+/// \return A thread's ops. The scan workload is the Zipfian one w/ `scan_share` of one-off names coming in
+/// bursts of the cache's capacity.
+///
+auto generateOps(BenchConfig const& config, std::string const& workload, std::size_t thread_index)
+    -> std::vector<Op>
+{
+    std::vector<Op> ops;
+    ops.reserve(config.ops_per_thread);
+
+    std::mt19937_64 rng{ 42 + thread_index };
+    std::bernoulli_distribution is_read{ config.read_ratio };
+    std::uniform_int_distribution<std::size_t> uniform{ 0, config.names - 1 };
+    ZipfianNames const zipfian{ config.names, config.zipf_exponent };
+
+    auto const scan_burst{ std::max<std::size_t>(1, config.capacity) };
+    std::bernoulli_distribution start_scan{ ("scan" == workload) ? (config.scan_share / scan_burst) : 0.0 };
+    std::size_t scanned{ 0 };
+
+    while (ops.size() < config.ops_per_thread)
+    {
+        if (start_scan(rng))
+        {
+            for (std::size_t i{ 0 }; (i < scan_burst) and (ops.size() < config.ops_per_thread); ++i)
+            {
+                auto fqdn{ "scan" + std::to_string(thread_index) + "-" + std::to_string(scanned++) };
+                ops.push_back(Op{ std::move(fqdn.append(".flood.bench.domain")), is_read(rng) });
+            }
+
+            continue;
+        }
+
+        auto const index{ ("uniform" == workload) ? uniform(rng) : zipfian(rng) };
+        ops.push_back(Op{ benchName(index), is_read(rng) });
+    }
+
+    return ops;
+}
+
+struct RunResult
+{
+    double        ops_per_second{};
+    double        hit_ratio{};
+    std::uint64_t p50_ns{};
+    std::uint64_t p99_ns{};
+    std::uint64_t p999_ns{};
+};
+
+auto percentile(std::vector<std::uint32_t>& latencies, double rank) -> std::uint64_t
+{
+    if (latencies.empty())
+    { return 0; }
+
+    auto const nth{ std::min(latencies.size() - 1, static_cast<std::size_t>(rank * latencies.size())) };
+    std::nth_element(latencies.begin(), latencies.begin() + nth, latencies.end());
+    return latencies[nth];
+}
+
+///
+/// \brief run replays every thread's ops on a cache prefilled w/ the most popular names, timing each op.
+///
+auto run(BenchConfig const& config, std::vector<std::vector<Op>> const& ops, std::size_t threads_number)
+    -> RunResult
+{
+    net::DNSCache dns_cache{
+        config.capacity,
+        config.shards,
+        ("tiny_lfu" == config.admission) ? net::DNSCache::Admission::TINY_LFU : net::DNSCache::Admission::ALWAYS
+    };
+    dns_cache.enableL1(config.l1);
+
+    // Just as many as fit, so the order only matters to TINY_LFU: its window ends up w/ the last ones.
+    for (std::size_t i{ 0 }; i < std::min(config.capacity, config.names); ++i)
+    { dns_cache.update(benchName(i), net::IPV4Raw{ 0x01'01'01'01 }); }
+
+    std::atomic<bool>                       go{ false };
+    std::vector<std::vector<std::uint32_t>> latencies(threads_number);
+    std::vector<std::size_t>                hits(threads_number, 0);
+    std::vector<std::size_t>                reads(threads_number, 0);
+    std::vector<std::thread>                threads;
+    threads.reserve(threads_number);
+
+    for (std::size_t t{ 0 }; t < threads_number; ++t)
+    {
+        threads.emplace_back(
+            [&, t]
+            {
+                auto& thread_latencies{ latencies[t] };
+                thread_latencies.reserve(ops[t].size());
+                std::size_t thread_hits{ 0 };
+                std::size_t thread_reads{ 0 };
+
+                while (not go.load(std::memory_order_acquire))
+                { std::this_thread::yield(); }
+
+                for (auto const& op : ops[t])
+                {
+                    auto const start{ std::chrono::steady_clock::now() };
+                    if (op.is_read)
+                    {
+                        ++thread_reads;
+                        thread_hits += (dns_cache.resolveRaw(op.fqdn).has_value() ? 1 : 0);
+                    }
+                    else
+                    { dns_cache.update(op.fqdn, net::IPV4Raw{ 0x02'02'02'02 }); }
+                    auto const elapsed{ std::chrono::steady_clock::now() - start };
+
+                    thread_latencies.push_back(static_cast<std::uint32_t>(
+                        std::min<std::int64_t>(std::chrono::nanoseconds{ elapsed }.count(), UINT32_MAX)));
+                }
+
+                // Only now: the neighbouring threads' counters share the lines.
+                hits[t]  = thread_hits;
+                reads[t] = thread_reads;
+            } // lambda
+        );
+    }
+
+    auto const start{ std::chrono::steady_clock::now() };
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads)
+    { thread.join(); }
+    auto const elapsed{ std::chrono::steady_clock::now() - start };
+
+    std::vector<std::uint32_t> all_latencies;
+    for (auto& thread_latencies : latencies)
+    { all_latencies.insert(all_latencies.end(), thread_latencies.begin(), thread_latencies.end()); }
+
+    auto const total_hits{ std::accumulate(hits.begin(), hits.end(), std::size_t{ 0 }) };
+    auto const total_reads{ std::accumulate(reads.begin(), reads.end(), std::size_t{ 0 }) };
+
+    auto const seconds{ std::chrono::duration<double>(elapsed).count() };
+
+    RunResult result{};
+    result.ops_per_second = static_cast<double>(all_latencies.size()) / seconds;
+    result.hit_ratio      = (0 == total_reads) ? 0.0 : (static_cast<double>(total_hits) / total_reads);
+    result.p50_ns         = percentile(all_latencies, 0.5);
+    result.p99_ns         = percentile(all_latencies, 0.99);
+    result.p999_ns        = percentile(all_latencies, 0.999);
+    return result;
+}
+
+} // anonymous
+
+///
+/// Usage: bench_dns_cache [--capacity=N] [--names=N] [--shards=N] [--threads=N] [--ops=N] [--read-ratio=R]
+///                        [--zipf=S] [--scan-share=R] [--workload=uniform|zipfian|scan|all]
+///                        [--admission=always|tiny_lfu] [--l1=on|off]
+///
+/// Runs the workloads w/ 1, 2, 4, ... up to `threads` threads, each doing `ops` reads and writes, and prints
+/// one JSON document: the config and a result per workload and threads number (ops/s over all the threads,
+/// the latency percentiles of single ops and the reads' hit ratio).
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    BenchConfig config{};
+    try
+    { config = parseConfig(argc, argv); }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> workloads{ "uniform", "zipfian", "scan" };
+    if ("all" != config.workload)
+    { workloads = { config.workload }; }
+
+    std::vector<std::size_t> threads_numbers;
+    for (std::size_t threads_number{ 1 }; threads_number < config.max_threads; threads_number *= 2)
+    { threads_numbers.push_back(threads_number); }
+    threads_numbers.push_back(std::max<std::size_t>(1, config.max_threads));
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"config\": {"
+         << "\"capacity\": " << config.capacity
+         << ", \"names\": " << config.names
+         << ", \"shards\": " << config.shards
+         << ", \"ops_per_thread\": " << config.ops_per_thread
+         << ", \"read_ratio\": " << config.read_ratio
+         << ", \"zipf\": " << config.zipf_exponent
+         << ", \"scan_share\": " << config.scan_share
+         << ", \"admission\": \"" << config.admission << "\""
+         << ", \"l1\": " << (config.l1 ? "true" : "false")
+         << "},\n"
+         << "  \"results\": [";
+
+    auto first{ true };
+    for (auto const& workload : workloads)
+    {
+        std::vector<std::vector<Op>> ops;
+        for (std::size_t t{ 0 }; t < threads_numbers.back(); ++t)
+        { ops.push_back(generateOps(config, workload, t)); }
+
+        for (auto const threads_number : threads_numbers)
+        {
+            auto const result{ run(config, ops, threads_number) };
+
+            json << (first ? "\n" : ",\n")
+                 << "    {\"workload\": \"" << workload << "\""
+                 << ", \"threads\": " << threads_number
+                 << ", \"ops_per_sec\": " << static_cast<std::uint64_t>(result.ops_per_second)
+                 << ", \"hit_ratio\": " << result.hit_ratio
+                 << ", \"latency_ns\": {\"p50\": " << result.p50_ns
+                 << ", \"p99\": " << result.p99_ns
+                 << ", \"p999\": " << result.p999_ns << "}}";
+            first = false;
+        }
+    }
+
+    json << "\n  ]\n}\n";
+    std::cout << json.str();
+}
@@ -0,0 +1,100 @@
+#include <core/flat_map.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+template <typename IndexKind>
+struct BenchNode
+    : public core::FlatMap<std::string, std::uint32_t, BenchNode<IndexKind>, IndexKind>::NodeTrait
+{
+    using NodeKeyReference = std::string const&;
+
+    operator NodeKeyReference () const noexcept(true)
+    { return this->first; }
+
+}; // BenchNode
+
+auto generateBenchKeys(std::size_t keys_number) -> std::vector<std::string>
+{
+    std::vector<std::string> keys;
+    keys.reserve(keys_number);
+
+    for (std::size_t i{ 0 }; i < keys_number; ++i)
+    { keys.emplace_back("subd" + std::to_string(i) + ".subd0.subd0.bench.domain"); }
+
+    return keys;
+}
+
+///
+/// \return Mean nanoseconds per random lookup in an index filled w/ all the `keys`.
+///
+template <typename IndexKind>
+auto benchLookups(std::vector<std::string> const& keys, std::size_t lookups_number) -> double
+{
+    using Node = BenchNode<IndexKind>;
+    using Map  = core::FlatMap<std::string, std::uint32_t, Node, IndexKind>;
+
+    auto storage{ std::make_unique<Node[]>(keys.size()) };
+    std::size_t allocated{ 0 };
+
+    Map map{ keys.size() };
+    map.setAllocateCallback([&] () -> Node* { return &storage[allocated++]; });
+
+    for (std::size_t i{ 0 }; i < keys.size(); ++i)
+    { map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i)); }
+
+    std::vector<std::size_t> order(lookups_number);
+    std::mt19937_64 rng{ 42 };
+    std::uniform_int_distribution<std::size_t> pick{ 0, keys.size() - 1 };
+    for (auto& index : order)
+    { index = pick(rng); }
+
+    std::uint64_t checksum{ 0 };
+    auto const start{ std::chrono::steady_clock::now() };
+    for (auto const index : order)
+    {
+        if (auto const node{ map.findOptimistic(keys[index]) };
+            nullptr != node)
+        { checksum += node->second; }
+    }
+    auto const elapsed{ std::chrono::steady_clock::now() - start };
+
+    if (0 == checksum)
+    { std::cerr << "warning: nothing found\n"; }
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(lookups_number);
+}
+
+} // anonymous
+
+///
+/// Usage: bench_flat_map_index [entries] [lookups]
+///
+/// Compares the random lookup latency of core::FlatLLRBMap and core::FlatHashMap.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const entries{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 1'000'000 };
+    std::size_t const lookups{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 5'000'000 };
+
+    auto const keys{ generateBenchKeys(entries) };
+
+    auto const ordered_ns{ benchLookups<core::OrderedIndex>(keys, lookups) };
+    auto const hashed_ns{ benchLookups<core::HashedIndex>(keys, lookups) };
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "entries:        " << entries << '\n'
+              << "FlatLLRBMap:    " << ordered_ns << " ns/lookup\n"
+              << "FlatHashMap:    " << hashed_ns << " ns/lookup\n"
+              << "hashed/ordered: " << std::setprecision(3) << (hashed_ns / ordered_ns) << '\n';
+}
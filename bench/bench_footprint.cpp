@@ -0,0 +1,68 @@
+#include <net/dns_cache.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+auto generateBenchNames(std::size_t names_number) -> std::vector<net::FQDN>
+{
+    std::vector<net::FQDN> names;
+    names.reserve(names_number);
+
+    for (std::size_t i{ 0 }; i < names_number; ++i)
+    { names.emplace_back("subd" + std::to_string(i) + ".subd0.subd0.bench.domain"); }
+
+    return names;
+}
+
+} // anonymous
+
+///
+/// Usage: bench_footprint [entries] [resolves]
+///
+/// Fills a cache and reports what its entries take: the node's bytes, its links' share and the bytes per
+/// entry, nodes and index tables included, along w/ the random resolves' time. The links are picked at
+/// build time: the other ones are measured by rebuilding the library w/ DNS_CACHE_COMPACT_LINKS flipped
+/// (and DNS_CACHE_HASHED_INDEX, for the index w/o the links of its own).
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const entries{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 1'000'000 };
+    std::size_t const resolves{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 5'000'000 };
+
+    auto const names{ generateBenchNames(entries) };
+    net::DNSCache dns_cache{ entries };
+    for (std::size_t i{ 0 }; i < names.size(); ++i)
+    { dns_cache.update(names[i], static_cast<net::IPV4Raw>(i)); }
+
+    std::vector<std::size_t> order(resolves);
+    std::mt19937_64 rng{ 42 };
+    std::uniform_int_distribution<std::size_t> pick{ 0, names.size() - 1 };
+    for (auto& index : order)
+    { index = pick(rng); }
+
+    std::uint64_t checksum{ 0 };
+    auto const start{ std::chrono::steady_clock::now() };
+    for (auto const index : order)
+    { checksum += dns_cache.resolveRaw(names[index]).value_or(0); }
+    auto const elapsed{ std::chrono::steady_clock::now() - start };
+
+    auto const footprint{ dns_cache.footprint() };
+    auto const bytes_per_entry{ static_cast<double>(footprint.bytes) / static_cast<double>(dns_cache.maxSize()) };
+    constexpr double GIB{ 1024.0 * 1024.0 * 1024.0 };
+
+    std::cout << std::fixed << std::setprecision(1) << "entries: " << entries << ", nodes: " << footprint.nodes
+              << "\nnode: " << footprint.node_bytes << " bytes, links: " << footprint.link_bytes
+              << " bytes\nper entry: " << bytes_per_entry << " bytes, entries/GiB: " << (GIB / bytes_per_entry)
+              << "\nresolve: "
+              << (std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(order.size()))
+              << " ns (checksum " << checksum << ")\n";
+}
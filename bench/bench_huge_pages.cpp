@@ -0,0 +1,181 @@
+#include <net/dns_cache.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+} // extern "C"
+
+namespace
+{
+
+auto generateBenchNames(std::size_t names_number) -> std::vector<net::FQDN>
+{
+    std::vector<net::FQDN> names;
+    names.reserve(names_number);
+
+    for (std::size_t i{ 0 }; i < names_number; ++i)
+    { names.emplace_back("subd" + std::to_string(i) + ".subd0.subd0.bench.domain"); }
+
+    return names;
+}
+
+///
+/// \brief The TLBMisses class counts the calling thread's dTLB load misses, if perf lets it.
+///
+class TLBMisses
+{
+private:
+    int fd{ -1 };
+
+public:
+    TLBMisses() noexcept(true)
+    {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HW_CACHE;
+        attr.config         = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+
+        this->fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~TLBMisses() noexcept(true)
+    {
+        if (0 <= this->fd)
+        { ::close(this->fd); }
+    }
+
+    TLBMisses& operator = (TLBMisses const&) = delete;
+    TLBMisses(TLBMisses const&)              = delete;
+
+    auto start() noexcept(true) -> void
+    {
+        if (0 <= this->fd)
+        {
+            (void)::ioctl(this->fd, PERF_EVENT_IOC_RESET, 0);
+            (void)::ioctl(this->fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    ///
+    /// \return The misses since start(), nothing if they can't be counted here (e.g. in a VM or a container).
+    ///
+    auto stop() noexcept(true) -> std::optional<std::uint64_t>
+    {
+        std::uint64_t count{};
+        if ((0 > this->fd) or (0 != ::ioctl(this->fd, PERF_EVENT_IOC_DISABLE, 0)) or
+            (sizeof(count) != ::read(this->fd, &count, sizeof(count))))
+        { return std::nullopt; }
+
+        return count;
+    }
+
+}; // TLBMisses
+
+auto nameOf(core::HugePages const huge_pages) -> char const*
+{
+    switch (huge_pages)
+    {
+        case core::HugePages::NONE:
+        { return "none"; }
+
+        case core::HugePages::TRANSPARENT:
+        { return "transparent"; }
+
+        case core::HugePages::EXPLICIT:
+        { return "explicit"; }
+    }
+
+    return "?";
+}
+
+auto report(
+    core::HugePages const           huge_pages,
+    core::NumaPlacement const       numa,
+    std::vector<net::FQDN> const&   names,
+    std::vector<std::size_t> const& order
+) -> void
+{
+    net::DNSCache dns_cache{ names.size(), 1, net::DNSCache::Admission::ALWAYS, 0,
+                             core::PageOptions{ huge_pages, numa, 0 } };
+
+    for (std::size_t i{ 0 }; i < names.size(); ++i)
+    { dns_cache.update(names[i], static_cast<net::IPV4Raw>(i)); }
+
+    TLBMisses tlb_misses{};
+    std::uint64_t checksum{ 0 };
+
+    tlb_misses.start();
+    auto const start{ std::chrono::steady_clock::now() };
+    for (auto const index : order)
+    { checksum += dns_cache.resolveRaw(names[index]).value_or(0); }
+    auto const elapsed{ std::chrono::steady_clock::now() - start };
+    auto const misses{ tlb_misses.stop() };
+
+    std::cout << "asked for " << std::setw(11) << nameOf(huge_pages) << ", got " << std::setw(11)
+              << nameOf(dns_cache.hugePages()) << ": "
+              << (std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(order.size()))
+              << " ns/resolve, dTLB misses/resolve: ";
+
+    if (misses.has_value())
+    { std::cout << (static_cast<double>(*misses) / static_cast<double>(order.size())); }
+    else
+    { std::cout << "n/a"; }
+
+    std::cout << " (checksum " << checksum << ")\n";
+}
+
+} // anonymous
+
+///
+/// Usage: bench_huge_pages [entries] [resolves] [numa: first-touch|interleave|node]
+///
+/// Compares random resolves over a cache big enough for the TLB not to cover its nodes, w/ the nodes on
+/// the base pages, on the transparent huge pages and on the reserved ones (vm.nr_hugepages; what isn't
+/// to be had falls back, the "got" column says what it's come to). The dTLB misses are counted by perf,
+/// where it's allowed (perf_event_paranoid).
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const entries{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 1'000'000 };
+    std::size_t const resolves{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 5'000'000 };
+    std::string const numa_name{ (3 < argc) ? argv[3] : "first-touch" };
+
+    auto const numa{
+        ("interleave" == numa_name) ? core::NumaPlacement::INTERLEAVE :
+        ("node" == numa_name)       ? core::NumaPlacement::NODE : core::NumaPlacement::FIRST_TOUCH
+    };
+
+    auto const names{ generateBenchNames(entries) };
+
+    std::vector<std::size_t> order(resolves);
+    std::mt19937_64 rng{ 42 };
+    std::uniform_int_distribution<std::size_t> pick{ 0, names.size() - 1 };
+    for (auto& index : order)
+    { index = pick(rng); }
+
+    std::cout << std::fixed << std::setprecision(1) << "entries: " << entries << ", NUMA nodes: "
+              << core::numaNodesNumber() << ", placement: " << numa_name << '\n';
+
+    using core::HugePages;
+    for (auto const huge_pages : { HugePages::NONE, HugePages::TRANSPARENT, HugePages::EXPLICIT })
+    { report(huge_pages, numa, names, order); }
+}
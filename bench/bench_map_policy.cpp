@@ -0,0 +1,199 @@
+#include <core/flat_map.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+template <typename IndexKind>
+struct BenchNode
+    : public core::FlatMap<std::string, std::uint32_t, BenchNode<IndexKind>, IndexKind>::NodeTrait
+{
+    using NodeKeyReference = std::string const&;
+
+    bool          used{ false };
+    std::uint32_t touches{ 0 }; // What a replacement policy's promotion would do, more or less.
+
+    operator NodeKeyReference () const noexcept(true)
+    { return this->first; }
+
+}; // BenchNode
+
+///
+/// \brief The Ring struct is the nodes' owner: it reuses them round robin, evicting the key a node held.
+///
+template <typename IndexKind, typename Map>
+struct Ring
+{
+    using Node = BenchNode<IndexKind>;
+
+    std::unique_ptr<Node[]> storage;
+    std::size_t             capacity;
+    std::size_t             next{ 0 };
+    Map*                    map{};
+
+    explicit Ring(std::size_t const capacity)
+        : storage{ std::make_unique<Node[]>(capacity) }
+        , capacity{ capacity }
+    {}
+
+    auto allocate() -> Node*
+    {
+        auto node{ &(this->storage[this->next++ % this->capacity]) };
+        if (node->used)
+        { (void)this->map->erase(node->first); }
+
+        return node;
+    }
+
+    auto touch(Node* node, bool const created) -> core::CreateOrUpdateStatus
+    {
+        node->used = node->used or created;
+        ++node->touches;
+        return core::CreateOrUpdateStatus::SUCCESS;
+    }
+
+}; // Ring
+
+///
+/// \brief The StaticPolicy struct is the ring wired at compile time.
+///
+template <typename IndexKind, typename Map>
+struct StaticPolicy
+{
+    using Node = BenchNode<IndexKind>;
+
+    Ring<IndexKind, Map>* ring{};
+
+    auto allocate() -> Node*
+    { return this->ring->allocate(); }
+
+    auto onCreate(Node* node) -> core::CreateOrUpdateStatus
+    { return this->ring->touch(node, true); }
+
+    auto onUpdate(Node* node) -> core::CreateOrUpdateStatus
+    { return this->ring->touch(node, false); }
+
+}; // StaticPolicy
+
+template <typename IndexKind>
+struct StaticMap
+{
+    using Node   = BenchNode<IndexKind>;
+    using Policy = StaticPolicy<IndexKind, StaticMap>;
+    using Map    = core::FlatMap<std::string, std::uint32_t, Node, IndexKind, Policy>;
+
+    Map map;
+
+    StaticMap(std::size_t const capacity, Ring<IndexKind, StaticMap>& ring)
+        : map{ capacity, Policy{ &ring } }
+    {}
+
+    auto erase(std::string const& key) -> bool
+    { return this->map.erase(key); }
+
+}; // StaticMap
+
+template <typename IndexKind>
+struct CallbackMap
+{
+    using Node = BenchNode<IndexKind>;
+    using Map  = core::FlatMap<std::string, std::uint32_t, Node, IndexKind>;
+
+    Map map;
+
+    CallbackMap(std::size_t const capacity, Ring<IndexKind, CallbackMap>& ring)
+        : map{ capacity }
+    {
+        this->map.setAllocateCallback([&ring] () -> Node* { return ring.allocate(); });
+        this->map.setCreateCallback([&ring] (Node* node) { return ring.touch(node, true); });
+        this->map.setUpdateCallback([&ring] (Node* node) { return ring.touch(node, false); });
+    }
+
+    auto erase(std::string const& key) -> bool
+    { return this->map.erase(key); }
+
+}; // CallbackMap
+
+auto generateBenchKeys(std::size_t keys_number) -> std::vector<std::string>
+{
+    std::vector<std::string> keys;
+    keys.reserve(keys_number);
+
+    for (std::size_t i{ 0 }; i < keys_number; ++i)
+    { keys.emplace_back("subd" + std::to_string(i) + ".bench.domain"); }
+
+    return keys;
+}
+
+///
+/// \return Mean nanoseconds per insertOrUpdate(): `keys` twice the capacity, picked at random, so about half
+/// the calls update a key and the rest evict one to insert theirs.
+///
+template <typename IndexKind, template <typename> class Wiring>
+auto benchUpdates(std::vector<std::string> const& keys, std::size_t const ops_number) -> double
+{
+    using Owner = Wiring<IndexKind>;
+
+    auto const capacity{ keys.size() / 2 };
+    Ring<IndexKind, Owner> ring{ capacity };
+    Owner owner{ capacity, ring };
+    ring.map = &owner;
+
+    for (std::size_t i{ 0 }; i < capacity; ++i)
+    { owner.map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i)); }
+
+    std::vector<std::size_t> order(ops_number);
+    std::mt19937_64 rng{ 42 };
+    std::uniform_int_distribution<std::size_t> pick{ 0, keys.size() - 1 };
+    for (auto& index : order)
+    { index = pick(rng); }
+
+    auto const start{ std::chrono::steady_clock::now() };
+    for (auto const index : order)
+    { owner.map.insertOrUpdate(keys[index], static_cast<std::uint32_t>(index)); }
+    auto const elapsed{ std::chrono::steady_clock::now() - start };
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(ops_number);
+}
+
+template <typename IndexKind>
+auto report(char const* name, std::vector<std::string> const& keys, std::size_t const ops_number) -> void
+{
+    auto const callback_ns{ benchUpdates<IndexKind, CallbackMap>(keys, ops_number) };
+    auto const static_ns{ benchUpdates<IndexKind, StaticMap>(keys, ops_number) };
+
+    std::cout << name << ":\n"
+              << "  CallbackPolicy: " << callback_ns << " ns/insertOrUpdate\n"
+              << "  static policy:  " << static_ns << " ns/insertOrUpdate\n"
+              << "  static/callback: " << std::setprecision(3) << (static_ns / callback_ns) << std::setprecision(1)
+              << '\n';
+}
+
+} // anonymous
+
+///
+/// Usage: bench_map_policy [entries] [ops]
+///
+/// Compares insertOrUpdate() through core::CallbackPolicy, the run time adapter, w/ a policy wired at
+/// compile time, for both index kinds. The owner's work is the same either way: a node ring that evicts.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const entries{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 100'000 };
+    std::size_t const ops{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 5'000'000 };
+
+    auto const keys{ generateBenchKeys(2 * entries) };
+
+    std::cout << std::fixed << std::setprecision(1) << "entries: " << entries << '\n';
+    report<core::OrderedIndex>("FlatLLRBMap", keys, ops);
+    report<core::HashedIndex>("FlatHashMap", keys, ops);
+}
@@ -0,0 +1,156 @@
+#include <net/dns_cache.hpp>
+#include <net/util.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using BenchCnt = std::vector<std::pair<net::FQDN, net::IP>>;
+
+auto generateBenchData(std::size_t bench_cnt_size) -> BenchCnt
+{
+    BenchCnt generated;
+    generated.resize(bench_cnt_size);
+
+    std::vector<net::IPV4Raw> raw_ips;
+    raw_ips.resize(bench_cnt_size);
+
+    std::iota(std::begin(raw_ips), std::end(raw_ips), 0x01'01'01'01);
+
+    for (std::size_t i{ 0 }; i < bench_cnt_size; ++i)
+    {
+        auto ip{ net::IPV4RawToStr(raw_ips[i]).value_or("0.0.0.0") };
+        generated[i] = { "subd" + std::to_string(i) + ".bench.domain", ip };
+    }
+
+    return generated;
+}
+
+///
+/// \brief runResolves hammers `dns_cache` w/ resolves from `threads_number` threads.
+/// \param with_writer adds a thread that keeps re-updating the names while the readers run.
+/// \return Resolves per second summed over all the reading threads.
+///
+auto runResolves(
+    net::DNSCache&  dns_cache,
+    BenchCnt const& bench_data,
+    std::size_t     threads_number,
+    std::size_t     resolves_per_thread,
+    bool            with_writer = false
+) -> double
+{
+    std::atomic<bool>        go{ false };
+    std::atomic<bool>        done{ false };
+    std::atomic<std::size_t> found{ 0 };
+    std::vector<std::thread> threads;
+    threads.reserve(threads_number);
+
+    for (std::size_t t{ 0 }; t < threads_number; ++t)
+    {
+        threads.emplace_back(
+            [&, t]
+            {
+                std::mt19937_64 rng{ t + 1 };
+                std::uniform_int_distribution<std::size_t> pick{ 0, bench_data.size() - 1 };
+                std::size_t local_found{ 0 };
+
+                while (not go.load(std::memory_order_acquire))
+                { std::this_thread::yield(); }
+
+                for (std::size_t i{ 0 }; i < resolves_per_thread; ++i)
+                { local_found += (dns_cache.resolve(bench_data[pick(rng)].first).empty() ? 0 : 1); }
+
+                found.fetch_add(local_found, std::memory_order_relaxed);
+            } // lambda
+        );
+    }
+
+    std::thread writer{};
+    if (with_writer)
+    {
+        writer = std::thread{
+            [&]
+            {
+                for (std::size_t i{ 0 }; not done.load(std::memory_order_relaxed); ++i)
+                {
+                    auto const& [fqdn, ip]{ bench_data[i % bench_data.size()] };
+                    dns_cache.update(fqdn, ip);
+                }
+            } // lambda
+        };
+    }
+
+    auto const start{ std::chrono::steady_clock::now() };
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads)
+    { thread.join(); }
+    auto const elapsed{ std::chrono::steady_clock::now() - start };
+
+    done.store(true, std::memory_order_relaxed);
+    if (writer.joinable())
+    { writer.join(); }
+
+    if (found.load() != (threads_number * resolves_per_thread))
+    { std::cerr << "warning: " << found.load() << " hits only\n"; }
+
+    auto const seconds{ std::chrono::duration<double>(elapsed).count() };
+    return static_cast<double>(threads_number * resolves_per_thread) / seconds;
+}
+
+} // anonymous
+
+///
+/// Usage: bench_resolve_scaling [capacity] [max_threads] [resolves_per_thread]
+///
+/// Fills the cache w/ `capacity` names and then measures the resolve throughput for 1..max_threads
+/// threads: w/ a single shard, w/ 4 shards per thread (16 at least), and w/ the latter while a writer
+/// keeps updating the names.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const capacity{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : (1u << 16) };
+    std::size_t const max_threads{
+        (2 < argc) ? std::strtoull(argv[2], nullptr, 10)
+                   : std::max<std::size_t>(1, std::thread::hardware_concurrency())
+    };
+    std::size_t const resolves_per_thread{ (3 < argc) ? std::strtoull(argv[3], nullptr, 10) : 1'000'000 };
+
+    auto const bench_data{ generateBenchData(capacity) };
+
+    std::cout << std::setw(8) << "threads"
+              << std::setw(16) << "1 shard ops/s"
+              << std::setw(16) << "N shards ops/s"
+              << std::setw(24) << "N shards+writer ops/s" << '\n';
+
+    for (std::size_t threads_number{ 1 }; threads_number <= max_threads; threads_number *= 2)
+    {
+        // Twice the data size, so no shard has to evict because of an uneven hash spread.
+        net::DNSCache single{ 2 * capacity, 1 };
+        net::DNSCache sharded{ 2 * capacity, std::max<std::size_t>(threads_number * 4, 16) };
+
+        for (auto const& [fqdn, ip] : bench_data)
+        {
+            single.update(fqdn, ip);
+            sharded.update(fqdn, ip);
+        }
+
+        std::cout << std::setw(8) << threads_number
+                  << std::setw(16) << std::fixed << std::setprecision(0)
+                  << runResolves(single, bench_data, threads_number, resolves_per_thread)
+                  << std::setw(16)
+                  << runResolves(sharded, bench_data, threads_number, resolves_per_thread)
+                  << std::setw(24)
+                  << runResolves(sharded, bench_data, threads_number, resolves_per_thread, true) << '\n';
+    }
+}
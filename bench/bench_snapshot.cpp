@@ -0,0 +1,66 @@
+#include <net/dns_cache.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+template <typename Body>
+auto seconds(Body&& body) -> double
+{
+    auto const start{ std::chrono::steady_clock::now() };
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous
+
+///
+/// Usage: bench_snapshot [entries] [shards] [path]
+///
+/// Fills a cache, saves a snapshot of it and loads the snapshot into a new cache of the same shape: the
+/// load's the warm restart. The file's in the page cache by then, as it is right after a deploy's save.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const entries{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 10'000'000 };
+    std::size_t const shards{ (2 < argc) ? std::strtoull(argv[2], nullptr, 10) : 1 };
+    std::string const path{ (3 < argc) ? argv[3] : "bench_snapshot.bin" };
+
+    std::size_t restored{ 0 };
+    double save_s{ 0.0 };
+    double load_s{ 0.0 };
+    {
+        net::DNSCache dns_cache{ entries, shards };
+        for (std::size_t i{ 0 }; i < entries; ++i)
+        {
+            dns_cache.update("subd" + std::to_string(i) + ".subd0.subd0.bench.domain",
+                             static_cast<net::IPV4Raw>(i),
+                             std::chrono::hours{ 1 });
+        }
+
+        save_s = seconds([&] { dns_cache.saveSnapshot(path); });
+    }
+
+    {
+        net::DNSCache dns_cache{ entries, shards };
+        load_s = seconds([&] { restored = dns_cache.loadSnapshot(path); });
+
+        if (restored != entries)
+        { std::cerr << "warning: restored " << restored << " of " << entries << '\n'; }
+    }
+
+    std::remove(path.c_str());
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "entries:  " << entries << ", shards: " << shards << '\n'
+              << "save:     " << save_s << " s\n"
+              << "load:     " << load_s << " s ("
+              << std::setprecision(1) << (load_s * 1e9 / static_cast<double>(entries)) << " ns/entry)\n";
+}
@@ -0,0 +1,67 @@
+#include <net/dns_cache.hpp>
+#include <net/util.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::atomic<std::size_t> allocations_number{ 0 };
+
+} // anonymous
+
+auto operator new (std::size_t size) -> void*
+{
+    allocations_number.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr{ std::malloc((0 == size) ? 1 : size) })
+    { return ptr; }
+
+    throw std::bad_alloc{};
+}
+
+auto operator delete (void* ptr) noexcept(true) -> void
+{ std::free(ptr); }
+
+auto operator delete (void* ptr, std::size_t) noexcept(true) -> void
+{ std::free(ptr); }
+
+///
+/// Usage: bench_update_allocations [capacity]
+///
+/// Counts the heap allocations per DNSCache::update in the steady state: the cache is full and every
+/// update of a new name evicts an old one. The names are longer than any small string optimization.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::size_t const capacity{ (1 < argc) ? std::strtoull(argv[1], nullptr, 10) : 100'000 };
+    std::size_t const names_number{ 4 * capacity };
+
+    std::vector<std::pair<net::FQDN, net::IP>> names;
+    names.reserve(names_number);
+    for (std::size_t i{ 0 }; i < names_number; ++i)
+    {
+        names.emplace_back(
+            "subd" + std::to_string(i) + ".some-rather-long-label.bench.domain",
+            net::IPV4RawToStr(static_cast<net::IPV4Raw>(0x01'01'01'01 + i)).value_or("0.0.0.0")
+        );
+    }
+
+    net::DNSCache dns_cache{ capacity };
+    for (std::size_t i{ 0 }; i < capacity; ++i)
+    { dns_cache.update(names[i].first, names[i].second); }
+
+    auto const allocations_before{ allocations_number.load() };
+    for (std::size_t i{ capacity }; i < names_number; ++i)
+    { dns_cache.update(names[i].first, names[i].second); }
+    auto const allocations{ allocations_number.load() - allocations_before };
+
+    auto const updates{ names_number - capacity };
+    std::cout << "updates:                " << updates << '\n'
+              << "allocations:            " << allocations << '\n'
+              << "allocations per update: " << (static_cast<double>(allocations) / updates) << '\n';
+}
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "core/links.hpp"
+#include "core/span.hpp"
+#include "core/types.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+namespace core
+{
+
+///
+/// \name core::Clock
+/// \brief The Clock class is the CLOCK replacement policy, a drop-in alternative to core::Ladder.
+/// \details The nodes are on a ring w/ a hand pointing at the next victim candidate. Neither a hit nor an
+/// update moves a node, both only set its reference bit w/ a relaxed store; the hand sweeps past the
+/// referenced nodes, clearing their bits, only when a victim is released. So the links are only written by
+/// inserting and releasing.
+///
+/// The ring is linked, not an array, so a node can move from one Clock to another (as between the
+/// admission window and the main part of the cache).
+/// \tparam Links is what the nodes link each other w/, see core::PointerLinks.
+///
+template <typename Node, typename Links = PointerLinks<Node>>
+class Clock
+{
+public: // Types:
+    class NodeTrait
+    {
+        typename Links::Link      next_clock_item{ Links::NONE };
+        typename Links::Link      prev_clock_item{ Links::NONE };
+        mutable std::atomic<bool> referenced{ false };
+
+        friend Clock<Node, Links>;
+    };
+
+    struct ToTop {};
+    struct OneUp {};
+    struct ToBottom {};
+
+    enum class PromotingStatus : std::uint8_t
+    {
+        SUCCESS,
+        NON_PROMOTABLE, // Not used, there's no top to reach: kept for the Ladder's interface.
+        ERROR,
+    };
+
+    enum class DemotingStatus : std::uint8_t
+    {
+        SUCCESS,
+        NON_DEMOTABLE, // Already under the hand
+        ERROR
+    };
+
+public: // Constants:
+    inline static constexpr ToTop TO_TOP{};
+    inline static constexpr OneUp ONE_UP{};
+    inline static constexpr ToBottom TO_BOTTOM{};
+    inline static constexpr core::Capacity MINIMAL_VIABLE_CAPACITY{ 3 };
+
+private: // Constants:
+    inline static constexpr Size RELINK_PREFETCH_DISTANCE{ 16 };
+
+private: // Fields:
+    Capacity       capacity{};
+    Links          links;
+    Node*          hand{};
+
+public: // RAII:
+    Clock(Node* storage, Capacity capacity, Links links = Links{}) noexcept(false)
+        : capacity{ capacity }
+        , links{ links }
+        , hand{ storage }
+    {
+        if ((nullptr == this->hand) or (MINIMAL_VIABLE_CAPACITY > this->capacity))
+        { throw std::logic_error("BadArgs"); }
+
+        for (Capacity i{ 0 }; i < capacity; ++i)
+        {
+            this->setNext(storage + i, storage + ((i + 1) % capacity));
+            this->setPrev(storage + i, storage + ((i + capacity - 1) % capacity));
+        }
+    }
+
+public: // Methods:
+    [[nodiscard]]
+    auto maxSize() noexcept(true) -> Capacity
+    { return this->capacity; }
+
+    ///
+    /// \brief reference marks a hit. Safe to call w/o the writer's lock: it's a relaxed store, if any.
+    ///
+    static auto reference(Node const* node) noexcept(true) -> void
+    {
+        // Don't dirty the line if it's already marked.
+        if (not node->referenced.load(std::memory_order_relaxed))
+        { node->referenced.store(true, std::memory_order_relaxed); }
+    }
+
+    ///
+    /// \brief releaseBottom sweeps the hand to the first unreferenced node, then unlinks and returns it.
+    ///
+    [[nodiscard]]
+    auto releaseBottom() noexcept(false) -> Node*
+    {
+        if (nullptr == this->hand)
+        { throw std::runtime_error{ "Bad clock hand!" }; }
+
+        // Bounded, as the readers may keep marking the nodes again meanwhile.
+        for (Capacity swept{ 0 };
+             (swept < this->capacity) and this->hand->referenced.load(std::memory_order_relaxed);
+             ++swept)
+        {
+            this->hand->referenced.store(false, std::memory_order_relaxed);
+            this->hand = this->next(this->hand);
+        }
+
+        auto free_node{ this->hand };
+        this->unlink(free_node);
+        free_node->referenced.store(false, std::memory_order_relaxed);
+        return free_node;
+    }
+
+    ///
+    /// \brief forEachFromBottom calls `visit` w/ every node on the ring, from the hand on: the order they'd be
+    /// released in if none were referenced.
+    ///
+    template <typename Visit>
+    auto forEachFromBottom(Visit&& visit) const noexcept(false) -> void
+    {
+        if (nullptr == this->hand)
+        { return; }
+
+        auto node{ this->hand };
+        do
+        {
+            visit(node);
+            node = this->next(node);
+        } while (node != this->hand);
+    }
+
+    ///
+    /// \brief extend puts more nodes on the ring, under the hand: they're the next to be released, `nodes[0]`
+    /// first. The ring's as many nodes longer.
+    ///
+    auto extend(Span<Node* const> nodes) noexcept(true) -> void
+    {
+        for (auto const node : nodes)
+        {
+            node->referenced.store(false, std::memory_order_relaxed);
+            this->linkBehindHand(node);
+        }
+
+        if (not nodes.empty())
+        { this->hand = nodes[0]; }
+
+        this->capacity += nodes.size();
+    }
+
+    ///
+    /// \brief shed is releaseBottom() for good: the ring's a node shorter.
+    ///
+    [[nodiscard]]
+    auto shed() noexcept(false) -> Node*
+    {
+        auto const node{ this->releaseBottom() };
+        --this->capacity;
+        return node;
+    }
+
+    ///
+    /// \brief replace puts `to`, which isn't on the ring, in the place of `from`, which is; `from` is unlinked.
+    ///
+    auto replace(Node* from, Node* to) noexcept(true) -> void
+    {
+        if (auto const next{ this->next(from) };
+            next == from)
+        {
+            this->setNext(to, to);
+            this->setPrev(to, to);
+        }
+        else
+        {
+            auto const prev{ this->prev(from) };
+            this->setNext(to, next);
+            this->setPrev(to, prev);
+            this->setNext(prev, to);
+            this->setPrev(next, to);
+        }
+
+        to->referenced.store(from->referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        if (from == this->hand)
+        { this->hand = to; }
+
+        this->setNext(from, nullptr);
+        this->setPrev(from, nullptr);
+        from->referenced.store(false, std::memory_order_relaxed);
+    }
+
+    ///
+    /// \brief relink puts the ring's nodes in the given order from the hand on, all their marks cleared.
+    /// \details For bulk loads: the nodes only get written, never read. `nodes` has to be all of the ring's.
+    ///
+    auto relink(Span<Node* const> nodes) noexcept(true) -> void
+    {
+        // The last node closes the ring, behind the first.
+        auto behind{ nodes.empty() ? nullptr : nodes[nodes.size() - 1] };
+        for (Size i{ 0 }; i < nodes.size(); ++i)
+        {
+            // The nodes are anywhere in the storage: their lines are asked for well ahead.
+            if ((i + RELINK_PREFETCH_DISTANCE) < nodes.size())
+            { prefetchForWrite(nodes[i + RELINK_PREFETCH_DISTANCE]); }
+
+            auto const node{ nodes[i] };
+            this->setPrev(node, behind);
+            this->setNext(behind, node);
+            node->referenced.store(false, std::memory_order_relaxed);
+
+            behind = node;
+        }
+
+        this->hand = nodes.empty() ? nullptr : nodes[0];
+    }
+
+    ///
+    /// \brief demote puts the node under the hand, so it's the next one to be released.
+    ///
+    [[nodiscard]]
+    auto demote(Node* demotee, ToBottom const&) noexcept(true) -> DemotingStatus
+    {
+        if (nullptr == demotee)
+        { return DemotingStatus::ERROR; }
+
+        demotee->referenced.store(false, std::memory_order_relaxed);
+
+        if (demotee == this->hand)
+        { return DemotingStatus::NON_DEMOTABLE; }
+
+        if (nullptr != this->next(demotee))
+        { this->unlink(demotee); }
+
+        this->linkBehindHand(demotee);
+        this->hand = demotee;
+
+        return DemotingStatus::SUCCESS;
+    }
+
+    ///
+    /// \brief promote inserts the node right behind the hand: the last place the hand gets to.
+    ///
+    [[nodiscard]]
+    auto promote(Node* promotee, ToTop const&) noexcept(true) -> PromotingStatus
+    {
+        if (nullptr == promotee)
+        { return PromotingStatus::ERROR; }
+
+        if (nullptr != this->next(promotee))
+        { this->unlink(promotee); }
+
+        this->linkBehindHand(promotee);
+
+        return PromotingStatus::SUCCESS;
+    }
+
+    ///
+    /// \brief promote marks the node referenced, it stays where it is.
+    ///
+    [[nodiscard]]
+    auto promote(Node* promotee, OneUp const&) noexcept(true) -> PromotingStatus
+    {
+        if ((nullptr == promotee) or (nullptr == this->next(promotee)))
+        { return PromotingStatus::ERROR; } // Not on the ring.
+
+        reference(promotee);
+
+        return PromotingStatus::SUCCESS;
+    }
+
+private: // Helpers:
+    auto unlink(Node* node) noexcept(true) -> void
+    {
+        auto const next{ this->next(node) };
+        if (next == node)
+        { this->hand = nullptr; }
+        else
+        {
+            auto const prev{ this->prev(node) };
+            this->setNext(prev, next);
+            this->setPrev(next, prev);
+
+            if (node == this->hand)
+            { this->hand = next; }
+        }
+
+        this->setNext(node, nullptr);
+        this->setPrev(node, nullptr);
+    }
+
+    auto linkBehindHand(Node* node) noexcept(true) -> void
+    {
+        if (nullptr == this->hand)
+        {
+            this->setNext(node, node);
+            this->setPrev(node, node);
+            this->hand = node;
+            return;
+        }
+
+        auto const behind{ this->prev(this->hand) };
+        this->setNext(node, this->hand);
+        this->setPrev(node, behind);
+        this->setNext(behind, node);
+        this->setPrev(this->hand, node);
+    }
+
+private: // Links:
+    auto next(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->next_clock_item); }
+
+    auto prev(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->prev_clock_item); }
+
+    auto setNext(Node* node, Node const* next) const noexcept(true) -> void
+    { node->next_clock_item = this->links.linkOf(next); }
+
+    auto setPrev(Node* node, Node const* prev) const noexcept(true) -> void
+    { node->prev_clock_item = this->links.linkOf(prev); }
+
+}; // Clock
+
+} // core
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+namespace core
+{
+
+///
+/// \name core::EpochDomain
+/// \brief The EpochDomain class is an epoch-based reclamation scheme for lock-free readers.
+/// \details Readers pin the current epoch for the time they may hold pointers into shared storage.
+/// A writer that has unlinked some storage stamps it w/ retireStamp() and may reuse it once isSafe()
+/// says every reader that could have seen it is gone, or after forcing that w/ synchronize().
+///
+/// Readers are counted in per-parity counters, striped over the threads, so entering is a single
+/// uncontended atomic increment. A grace period flips the parity twice, waiting for the readers of the
+/// old parity to drain each time: two flips, so a reader that sampled the epoch right before the first
+/// flip is still waited for.
+///
+/// Writers (the ones calling synchronize()) are expected to be serialized by the caller.
+///
+class EpochDomain
+{
+public: // Types:
+    using Epoch = std::uint64_t;
+
+private: // Types:
+    struct alignas(CACHE_LINE_SIZE) ReadersStripe
+    {
+        std::array<std::atomic<std::int64_t>, 2> readers{};
+    };
+
+public: // Types:
+    ///
+    /// \brief The Guard class pins the epoch for its lifetime. Movable, so it can be handed out w/ a result.
+    ///
+    class Guard
+    {
+        std::atomic<std::int64_t>* readers{};
+
+    public:
+        explicit Guard(EpochDomain& domain) noexcept(true)
+        {
+            auto& stripe{ domain.stripes[threadStripe()] };
+            auto const epoch{ domain.epoch.load(std::memory_order_relaxed) };
+            this->readers = &(stripe.readers[epoch & 0b1]);
+            this->readers->fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        Guard(Guard&& other) noexcept(true)
+            : readers{ std::exchange(other.readers, nullptr) }
+        {}
+
+        ~Guard() noexcept(true)
+        {
+            if (nullptr != this->readers)
+            { this->readers->fetch_sub(1, std::memory_order_release); }
+        }
+
+        Guard& operator = (Guard const&) = delete;
+        Guard& operator = (Guard&&)      = delete;
+        Guard(Guard const&)              = delete;
+
+    }; // Guard
+
+private: // Constants:
+    inline static constexpr Size STRIPES_NUMBER{ 32 };
+    inline static constexpr Epoch GRACE_PERIOD_FLIPS{ 2 };
+
+private: // Fields:
+    std::array<ReadersStripe, STRIPES_NUMBER> stripes{};
+    alignas(CACHE_LINE_SIZE) std::atomic<Epoch> epoch{ GRACE_PERIOD_FLIPS };
+
+    static auto threadStripe() noexcept(true) -> Size
+    {
+        static std::atomic<Size> next_stripe{ 0 };
+        thread_local Size const stripe{ next_stripe.fetch_add(1, std::memory_order_relaxed) % STRIPES_NUMBER };
+        return stripe;
+    }
+
+    auto flip() noexcept(true) -> void
+    {
+        auto const old_epoch{ this->epoch.fetch_add(1, std::memory_order_seq_cst) };
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        for (auto& stripe : this->stripes)
+        {
+            while (0 != stripe.readers[old_epoch & 0b1].load(std::memory_order_seq_cst))
+            { std::this_thread::yield(); }
+        }
+    }
+
+public: // Methods:
+    [[nodiscard]]
+    auto enter() noexcept(true) -> Guard
+    { return Guard{ *this }; }
+
+    ///
+    /// \return The stamp for the storage that's just been unlinked.
+    ///
+    [[nodiscard]]
+    auto retireStamp() const noexcept(true) -> Epoch
+    { return this->epoch.load(std::memory_order_relaxed); }
+
+    ///
+    /// \return true if no reader can still see the storage retired w/ `retired_at`.
+    ///
+    [[nodiscard]]
+    auto isSafe(Epoch const retired_at) const noexcept(true) -> bool
+    { return (this->epoch.load(std::memory_order_relaxed) >= (retired_at + GRACE_PERIOD_FLIPS)); }
+
+    ///
+    /// \brief tryAdvance moves the epoch on if no reader is left from before the previous advance.
+    /// \details The non-blocking alternative to synchronize(): a writer calling it now and then makes
+    /// what it has retired safe over time, w/o ever waiting for a reader.
+    /// \return true if the epoch has moved on.
+    ///
+    auto tryAdvance() noexcept(true) -> bool
+    {
+        auto const epoch{ this->epoch.load(std::memory_order_relaxed) };
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // The previous epoch's parity is the next one's: once it drains, it can be reused.
+        for (auto& stripe : this->stripes)
+        {
+            if (0 != stripe.readers[(epoch + 1) & 0b1].load(std::memory_order_seq_cst))
+            { return false; }
+        }
+
+        this->epoch.store(epoch + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    ///
+    /// \brief synchronize waits for a full grace period: everything retired before the call is safe after it.
+    ///
+    auto synchronize() noexcept(true) -> void
+    {
+        for (Epoch i{ 0 }; i < GRACE_PERIOD_FLIPS; ++i)
+        { this->flip(); }
+    }
+
+}; // EpochDomain
+
+} // core
@@ -0,0 +1,735 @@
+#pragma once
+
+#include "core/map_policy.hpp"
+#include "core/seq_lock.hpp"
+#include "core/span.hpp"
+#include "core/types.hpp"
+
+#include <array>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#   include <emmintrin.h>
+#endif
+
+namespace core
+{
+
+///
+/// \name core::FlatHashMap
+/// \brief The FlatHashMap class is a Swiss-table-style index over externally owned nodes.
+/// \details Same contract as core::FlatLLRBMap: the nodes live in the owner's slab and are handed out by
+/// the policy (see core::CallbackPolicy), the table only stores links to them. The table is open addressed in groups of
+/// 16 slots; every slot has a 1-byte control tag (empty, deleted, or 7 bits of the key's hash), and a
+/// group's tags are matched at once (w/ SSE2 when available).
+///
+/// The table is sized for the capacity, it only grows w/ reserve(). Tombstones are cleared by rehashing into
+/// a second, preallocated table of the same size. A grown table's filled incrementally: the mutators migrate
+/// a few groups of the previous one each, and the lookups probe both meanwhile. The tables lock-free readers
+/// may be looking at are only freed by reclaimRetired(), once the owner says no reader's left.
+///
+template <
+    typename KeyType,
+    typename ValueType,
+    typename Node,
+    typename Hash   = std::hash<KeyType>,
+    typename Policy = CallbackPolicy<Node>
+>
+class FlatHashMap
+{
+private: // Types:
+    using HashValue = std::size_t;
+    using Tag       = std::int8_t;
+    using BitMask   = std::uint32_t;
+
+    inline static constexpr Size GROUP_WIDTH{ 16 };
+
+    struct alignas(GROUP_WIDTH) Group
+    {
+        std::array<Tag, GROUP_WIDTH>   tags;
+        std::array<Node*, GROUP_WIDTH> slots;
+
+        auto match(Tag const tag) const noexcept(true) -> BitMask
+        {
+#if defined(__SSE2__)
+            auto const group{ _mm_load_si128(reinterpret_cast<__m128i const*>(this->tags.data())) };
+            return static_cast<BitMask>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), group)));
+#else
+            BitMask mask{ 0 };
+            for (Size i{ 0 }; i < GROUP_WIDTH; ++i)
+            { mask |= ((this->tags[i] == tag) ? (BitMask{ 1 } << i) : 0); }
+            return mask;
+#endif
+        }
+
+        auto matchEmpty() const noexcept(true) -> BitMask
+        { return this->match(EMPTY); }
+
+        ///
+        /// \brief matchFree matches both the empty and the deleted slots: the only negative tags.
+        ///
+        auto matchFree() const noexcept(true) -> BitMask
+        {
+#if defined(__SSE2__)
+            auto const group{ _mm_load_si128(reinterpret_cast<__m128i const*>(this->tags.data())) };
+            return static_cast<BitMask>(_mm_movemask_epi8(group));
+#else
+            BitMask mask{ 0 };
+            for (Size i{ 0 }; i < GROUP_WIDTH; ++i)
+            { mask |= ((0 > this->tags[i]) ? (BitMask{ 1 } << i) : 0); }
+            return mask;
+#endif
+        }
+
+        auto clear() noexcept(true) -> void
+        {
+            this->tags.fill(EMPTY);
+            this->slots.fill(nullptr);
+        }
+    };
+
+    ///
+    /// \brief The Table struct is the groups w/ their number: a reader gets both w/ the one pointer.
+    ///
+    struct Table
+    {
+        std::unique_ptr<Group[]> groups;
+        Size                     mask; // The groups' number less one, a power of two.
+
+        explicit Table(Size const groups_number) noexcept(false)
+            : groups{ std::make_unique<Group[]>(groups_number) }
+            , mask{ groups_number - 1 }
+        { this->clear(); }
+
+        auto clear() noexcept(true) -> void
+        {
+            for (Size i{ 0 }; i <= this->mask; ++i)
+            { this->groups[i].clear(); }
+        }
+
+        auto maxLoad() const noexcept(true) -> Size
+        { return ((this->mask + 1) * GROUP_WIDTH * 7) / 8; }
+    };
+
+    struct Position
+    {
+        Group* group{};
+        Size   slot{};
+    };
+
+private: // Constants:
+    inline static constexpr Tag EMPTY{ static_cast<Tag>(0b1000'0000) };
+    inline static constexpr Tag DELETED{ static_cast<Tag>(0b1111'1110) };
+
+    // The previous table's groups a mutator migrates: a couple of thousand slots, a few microseconds.
+    inline static constexpr Size MIGRATION_GROUPS{ 128 };
+
+public: // Types:
+    struct Sorted {};
+
+public: // Constants:
+    inline static constexpr Size BATCH_WIDTH{ 64 }; // findOptimisticBatch()'s keys in flight.
+    inline static constexpr Sorted SORTED{};
+
+public: // Types:
+    class NodeTrait
+    {
+        using key_type    = KeyType;
+        using mapped_type = ValueType;
+
+        HashValue hash{};
+
+        // Whatever the policy: the node types don't depend on it.
+        template <typename, typename, typename, typename, typename>
+        friend class FlatHashMap;
+
+    public: // Fields:
+        mapped_type second;
+        key_type    first; // Last: an inline key may be much longer than the rest.
+
+    }; // NodeTrait
+
+    using CreateOrUpdateStatus = core::CreateOrUpdateStatus;
+
+private: // Fields:
+    std::unique_ptr<Table>              tables[2]{};      // The active one and its spare.
+    Table*                              active_table{};
+    std::unique_ptr<Table>              previous_table{}; // Being migrated from, after reserve() has grown.
+    Table*                              draining_table{}; // The readers' view of it: null once it's migrated.
+    Size                                migrated_groups{};
+    std::vector<std::unique_ptr<Table>> retired_tables{};
+    Size                                growth_left{};
+    core::Size                          nodes_number{};
+    core::Capacity                      capacity{};
+    Policy                              policy;
+
+public:
+    FlatHashMap(core::Capacity const capacity, Policy policy = Policy{}) noexcept(false)
+        : capacity{ capacity }
+        , policy{ std::move(policy) }
+    {
+        auto const groups{ groupsFor(capacity) };
+        for (auto& table : this->tables)
+        { table = std::make_unique<Table>(groups); }
+
+        this->active_table = this->tables[0].get();
+        this->growth_left  = this->active_table->maxLoad();
+    }
+
+    auto size() const noexcept(true) -> core::Size
+    { return this->nodes_number; };
+
+    auto maxSize() const noexcept(true) -> core::Size
+    { return this->capacity; };
+
+    auto createNode(KeyType const& key, ValueType const& value) noexcept(false) -> Node*
+    {
+        if (auto new_node{ this->policy.allocate() };
+            nullptr != new_node)
+        {
+            new_node->first  = key;
+            new_node->second = value;
+
+            if (CreateOrUpdateStatus::FATAL_ERROR == this->policy.onCreate(new_node))
+            { throw std::runtime_error{"Fatal error in the create callback!"}; }
+
+            ++this->nodes_number;
+            return new_node;
+        }
+
+        throw std::bad_alloc{};
+    }
+
+    auto insertOrUpdate(KeyType const& key, ValueType const& value) -> void
+    {
+        this->migrate(MIGRATION_GROUPS);
+
+        auto const hash{ Hash{}(key) };
+        if (auto const position{ this->find(key, hash) };
+            nullptr != position.group)
+        {
+            auto node{ position.group->slots[position.slot] };
+            node->second = value;
+            (void)this->policy.onUpdate(node);
+        }
+        else
+        {
+            // Allocating may evict (and erase) another node, so the slot is picked after it.
+            auto new_node{ this->createNode(key, value) };
+            new_node->hash = hash;
+            this->link(new_node);
+        }
+    }
+
+    ///
+    /// \brief erase unlinks the node holding `key` from the table. The node's storage is left to the owner.
+    /// \return true if there was such a node.
+    ///
+    auto erase(KeyType const& key) noexcept(true) -> bool
+    {
+        this->migrate(MIGRATION_GROUPS);
+
+        auto const position{ this->find(key, Hash{}(key)) };
+        if (nullptr == position.group)
+        { return false; }
+
+        // A probe stops at the first group w/ an empty slot, so if this group has one, no probe has ever
+        // gone past it and the slot can become empty again. Otherwise it has to be a tombstone. The previous
+        // table's slots are only ever tombstones: it isn't probed for free ones any more.
+        if ((0 != position.group->matchEmpty()) and this->isActive(position.group))
+        {
+            position.group->tags[position.slot] = EMPTY;
+            ++this->growth_left;
+        }
+        else
+        { position.group->tags[position.slot] = DELETED; }
+
+        position.group->slots[position.slot] = nullptr;
+        --this->nodes_number;
+        return true;
+    }
+
+    ///
+    /// \brief findOptimistic is the lookup for readers that don't hold the writer's lock.
+    /// \details It never writes and never probes more than all the groups, so it terminates even if the
+    /// table is being modified concurrently. The result means something only if the caller then validates
+    /// that no writer has intervened (see core::SeqLock), and the node's storage must be kept alive by
+    /// the caller (see core::EpochDomain). Like find(), it takes any `LookupKey`.
+    ///
+    template <typename LookupKey = KeyType>
+    auto findOptimistic(LookupKey const& key) const noexcept(true) -> Node const*
+    {
+        auto const hash{ Hash{}(key) };
+        if (auto const node{ this->findOptimistic(key, hash, core::racyLoad(this->active_table)) };
+            nullptr != node)
+        { return node; }
+
+        auto const draining{ core::racyLoad(this->draining_table) };
+        return (nullptr != draining) ? this->findOptimistic(key, hash, draining) : nullptr;
+    }
+
+    ///
+    /// \brief findOptimisticBatch is findOptimistic for many keys at once: `found[i]` gets the node of `keys[i]`.
+    /// \details The lookups go in stages over up to BATCH_WIDTH keys: hash all and prefetch their groups,
+    /// then prefetch the matching slots, then the nodes they link, and only then compare the keys. So the
+    /// cache misses of all the keys overlap instead of adding up. Same contract as findOptimistic.
+    ///
+    auto findOptimisticBatch(
+        core::Span<KeyType const> keys,
+        core::Span<Node const*>   found
+    ) const noexcept(true) -> void
+    {
+        auto const table{ core::racyLoad(this->active_table) };
+        auto const draining{ core::racyLoad(this->draining_table) };
+        auto const groups{ table->groups.get() };
+
+        std::array<HashValue, BATCH_WIDTH> hashes;
+        for (Size offset{ 0 }; offset < keys.size(); offset += BATCH_WIDTH)
+        {
+            auto const width{ std::min(keys.size() - offset, BATCH_WIDTH) };
+
+            for (Size i{ 0 }; i < width; ++i)
+            {
+                hashes[i] = Hash{}(keys[offset + i]);
+                core::prefetch(&(groups[groupOf(hashes[i]) & table->mask]));
+            }
+
+            // Only the first candidate of the first group: that's where a present key usually is.
+            for (Size i{ 0 }; i < width; ++i)
+            {
+                auto const& group{ groups[groupOf(hashes[i]) & table->mask] };
+                if (auto const matches{ group.match(tagOf(hashes[i])) };
+                    0 != matches)
+                { core::prefetch(&(group.slots[lowestBit(matches)])); }
+            }
+
+            for (Size i{ 0 }; i < width; ++i)
+            {
+                auto const& group{ groups[groupOf(hashes[i]) & table->mask] };
+                if (auto const matches{ group.match(tagOf(hashes[i])) };
+                    0 != matches)
+                {
+                    if (auto const node{ core::racyLoad(group.slots[lowestBit(matches)]) };
+                        nullptr != node)
+                    { core::prefetch(&(node->first)); }
+                }
+            }
+
+            // The previous table's only probed for what's still missing: it's emptied as the writes go on.
+            for (Size i{ 0 }; i < width; ++i)
+            {
+                found[offset + i] = this->findOptimistic(keys[offset + i], hashes[i], table);
+                if ((nullptr == found[offset + i]) and (nullptr != draining))
+                { found[offset + i] = this->findOptimistic(keys[offset + i], hashes[i], draining); }
+            }
+        }
+    }
+
+    ///
+    /// \brief forEach calls `visit` w/ every node, in no particular order.
+    ///
+    template <typename Visit>
+    auto forEach(Visit&& visit) const noexcept(false) -> void
+    {
+        for (auto const table : { this->active_table, this->draining_table })
+        {
+            for (Size i{ 0 }; (nullptr != table) and (i <= table->mask); ++i)
+            {
+                for (Size slot{ 0 }; slot < GROUP_WIDTH; ++slot)
+                {
+                    if (0 <= table->groups[i].tags[slot])
+                    { visit(static_cast<Node const*>(table->groups[i].slots[slot])); }
+                }
+            }
+        }
+    }
+
+    ///
+    /// \brief rebuild replaces the whole table w/ the `nodes`, whose keys and values are set already.
+    /// \details Meant for filling an empty map in bulk: any order, a probe for a free slot per node and no
+    /// key comparisons. The keys have to be unique and fit the capacity, and the callbacks aren't called.
+    ///
+    auto rebuild(core::Span<Node* const> nodes) noexcept(true) -> void
+    { this->rebuild(nodes, SORTED); }
+
+    ///
+    /// \brief rebuild w/ the nodes sorted by key: core::FlatLLRBMap's interface, the order doesn't matter here.
+    ///
+    auto rebuild(core::Span<Node* const> nodes, Sorted const&) noexcept(true) -> void
+    {
+        this->retirePrevious();
+        this->active_table->clear();
+
+        this->growth_left  = this->active_table->maxLoad();
+        this->nodes_number = nodes.size();
+
+        for (auto const node : nodes)
+        {
+            node->hash = Hash{}(node->first);
+            this->link(node);
+        }
+    }
+
+    ///
+    /// \brief reserve makes room for `capacity` nodes. A bigger table's allocated if it takes one, the nodes are
+    /// migrated to it over the next inserts and erases (see the class' details); it never shrinks.
+    /// \details A migration that's still going on is finished first.
+    /// \throws std::bad_alloc if the table can't be allocated: then nothing's changed.
+    ///
+    auto reserve(core::Capacity const capacity) noexcept(false) -> void
+    {
+        auto const groups{ groupsFor(capacity) };
+        if (groups <= (this->active_table->mask + 1))
+        {
+            this->capacity = capacity;
+            return;
+        }
+
+        auto active{ std::make_unique<Table>(groups) };
+        auto spare{ std::make_unique<Table>(groups) };
+        // The previous one's, the spare and, later, the new previous one: retiring never allocates.
+        this->retired_tables.reserve(this->retired_tables.size() + 3);
+
+        this->migrate(std::numeric_limits<Size>::max());
+
+        // The spare may have been the active one until the last rehash: readers may still be in it, too.
+        auto const active_index{ (this->active_table == this->tables[0].get()) ? 0 : 1 };
+        this->previous_table = std::move(this->tables[active_index]);
+        this->retired_tables.push_back(std::move(this->tables[1 - active_index]));
+
+        this->tables[0]       = std::move(active);
+        this->tables[1]       = std::move(spare);
+        this->active_table    = this->tables[0].get();
+        this->draining_table  = this->previous_table.get();
+        this->migrated_groups = 0;
+        this->growth_left     = this->active_table->maxLoad();
+        this->capacity        = capacity;
+    }
+
+    ///
+    /// \return The bytes of the tables, the spare and the one being migrated from included: what the index
+    /// takes besides the nodes.
+    ///
+    [[nodiscard]]
+    auto tableBytes() const noexcept(true) -> Size
+    {
+        auto bytes{ Size{ 0 } };
+        for (auto const table : { this->tables[0].get(), this->tables[1].get(), this->previous_table.get() })
+        { bytes += (nullptr != table) ? ((table->mask + 1) * sizeof(Group)) : 0; }
+
+        return bytes;
+    }
+
+    ///
+    /// \return true while there's a previous table left to migrate from.
+    ///
+    [[nodiscard]]
+    auto isMigrating() const noexcept(true) -> bool
+    { return (nullptr != this->draining_table); }
+
+    ///
+    /// \brief reclaimRetired frees the tables nobody probes any more, if there are any: after `synchronize()`
+    /// has made sure no reader's left in them (see core::EpochDomain).
+    ///
+    template <typename Synchronize>
+    auto reclaimRetired(Synchronize&& synchronize) noexcept(true) -> void
+    {
+        if (this->retired_tables.empty())
+        { return; }
+
+        synchronize();
+        this->retired_tables.clear();
+    }
+
+    ///
+    /// \brief replace puts `to` in the place of `from`, which holds the same key: for moving an entry to
+    /// another node. `to`'s key and value are set already, `from`'s left to the owner.
+    /// \return false if `from` isn't in the map.
+    ///
+    auto replace(Node const* from, Node* to) noexcept(true) -> bool
+    {
+        auto const position{ this->find(from->first, from->hash) };
+        if ((nullptr == position.group) or (from != position.group->slots[position.slot]))
+        { return false; }
+
+        to->hash                             = from->hash;
+        position.group->slots[position.slot] = to;
+        return true;
+    }
+
+    ///
+    /// \brief find is the lookup for the writer's side: neither a hit nor a miss allocates or throws.
+    /// \tparam LookupKey is the key type, or one that compares equal to the keys and that `Hash` takes as
+    /// well, hashing it the same, e.g. std::string_view: no key has to be made to look one up.
+    /// \return The node holding `key`, or null.
+    ///
+    template <typename LookupKey>
+    auto find(LookupKey const& key) noexcept(true) -> Node*
+    {
+        auto const position{ this->find(key, Hash{}(key)) };
+        return (nullptr != position.group) ? position.group->slots[position.slot] : nullptr;
+    }
+
+    template <typename LookupKey>
+    auto find(LookupKey const& key) const noexcept(true) -> Node const*
+    {
+        auto const position{ this->find(key, Hash{}(key)) };
+        return (nullptr != position.group) ? position.group->slots[position.slot] : nullptr;
+    }
+
+    ///
+    /// \throws std::out_of_range on a miss: find() is the one for where misses are common.
+    ///
+    auto at(KeyType const& key) noexcept(false) -> ValueType&
+    {
+        if (auto const position{ this->find(key, Hash{}(key)) };
+            nullptr != position.group)
+        { return position.group->slots[position.slot]->second; }
+
+        throw std::out_of_range{""};
+    }
+
+    auto getPolicy() noexcept(true) -> Policy&
+    { return this->policy; }
+
+    ///
+    /// \name The callbacks' setters: there only w/ the CallbackPolicy.
+    ///
+    template <typename P = Policy>
+    auto setAllocateCallback(typename P::AllocateCallback allocate_cb) noexcept(true) -> void
+    { this->policy.setAllocateCallback(std::move(allocate_cb)); }
+
+    template <typename P = Policy>
+    auto setCreateCallback(typename P::AccessCallback create_cb) noexcept(true) -> void
+    { this->policy.setCreateCallback(std::move(create_cb)); }
+
+    template <typename P = Policy>
+    auto setUpdateCallback(typename P::AccessCallback update_cb) noexcept(true) -> void
+    { this->policy.setUpdateCallback(std::move(update_cb)); }
+
+    template <typename P = Policy>
+    auto setUseCallback(typename P::AccessCallback use_cb) noexcept(true) -> void
+    { this->policy.setUseCallback(std::move(use_cb)); }
+
+private: // Probing:
+    ///
+    /// \brief keyEquals compares the strings as views: the keys may only be explicitly made from them.
+    ///
+    template <typename LookupKey>
+    static auto keyEquals(KeyType const& node_key, LookupKey const& key) noexcept(true) -> bool
+    {
+        if constexpr (std::is_convertible_v<KeyType const&, std::string_view> and
+                      std::is_convertible_v<LookupKey const&, std::string_view>)
+        { return (static_cast<std::string_view>(node_key) == static_cast<std::string_view>(key)); }
+        else
+        { return (node_key == key); }
+    }
+
+    template <typename LookupKey>
+    auto findOptimistic(
+        LookupKey const&   key,
+        HashValue const    hash,
+        Table const* const table
+    ) const noexcept(true) -> Node const*
+    {
+        auto const tag{ tagOf(hash) };
+
+        auto index{ groupOf(hash) & table->mask };
+        for (Size probe{ 0 }; probe <= table->mask; ++probe)
+        {
+            auto const& group{ table->groups[index] };
+            for (auto matches{ group.match(tag) }; 0 != matches; matches &= (matches - 1))
+            {
+                auto const node{ core::racyLoad(group.slots[lowestBit(matches)]) };
+                if ((nullptr != node) and keyEquals(node->first, key))
+                { return node; }
+            }
+
+            if (0 != group.matchEmpty())
+            { break; }
+
+            index = (index + probe + 1) & table->mask;
+        }
+
+        return nullptr;
+    }
+
+    static auto tagOf(HashValue const hash) noexcept(true) -> Tag
+    { return static_cast<Tag>(hash & 0b0111'1111); }
+
+    static auto groupOf(HashValue const hash) noexcept(true) -> Size
+    { return (hash >> 7); }
+
+    static auto lowestBit(BitMask const mask) noexcept(true) -> Size
+    { return static_cast<Size>(__builtin_ctz(mask)); }
+
+    ///
+    /// \return The groups for `capacity` nodes at the max load factor of 7/8, a power of two.
+    ///
+    static auto groupsFor(core::Capacity const capacity) noexcept(true) -> Size
+    {
+        auto const min_slots{ (capacity * 8 + 6) / 7 };
+        Size groups{ 1 };
+        while ((groups * GROUP_WIDTH) < min_slots)
+        { groups <<= 1; }
+
+        return groups;
+    }
+
+    auto isActive(Group const* const group) const noexcept(true) -> bool
+    {
+        auto const groups{ this->active_table->groups.get() };
+        return ((groups <= group) and (group <= (groups + this->active_table->mask)));
+    }
+
+    ///
+    /// \return The key's slot in the active table, or in the previous one while it's being migrated from.
+    ///
+    template <typename LookupKey>
+    auto find(LookupKey const& key, HashValue const hash) const noexcept(true) -> Position
+    {
+        if (auto const position{ this->find(key, hash, *(this->active_table)) };
+            (nullptr != position.group) or (nullptr == this->draining_table))
+        { return position; }
+
+        return this->find(key, hash, *(this->draining_table));
+    }
+
+    template <typename LookupKey>
+    auto find(LookupKey const& key, HashValue const hash, Table const& table) const noexcept(true) -> Position
+    {
+        auto const tag{ tagOf(hash) };
+
+        auto index{ groupOf(hash) & table.mask };
+        for (Size probe{ 0 }; probe <= table.mask; ++probe)
+        {
+            auto& group{ table.groups[index] };
+            for (auto matches{ group.match(tag) }; 0 != matches; matches &= (matches - 1))
+            {
+                auto const slot{ lowestBit(matches) };
+                if ((hash == group.slots[slot]->hash) and keyEquals(group.slots[slot]->first, key))
+                { return Position{ &group, slot }; }
+            }
+
+            if (0 != group.matchEmpty())
+            { break; }
+
+            index = (index + probe + 1) & table.mask;
+        }
+
+        return Position{};
+    }
+
+    ///
+    /// \return The first empty or deleted slot on the hash's probe sequence in `table`.
+    ///
+    static auto findFree(Table& table, HashValue const hash) noexcept(true) -> Position
+    {
+        auto index{ groupOf(hash) & table.mask };
+        for (Size probe{ 0 }; ; ++probe)
+        {
+            if (auto const free{ table.groups[index].matchFree() };
+                0 != free)
+            { return Position{ &(table.groups[index]), lowestBit(free) }; }
+
+            index = (index + probe + 1) & table.mask;
+        }
+    }
+
+    auto link(Node* node) noexcept(true) -> void
+    {
+        auto position{ findFree(*(this->active_table), node->hash) };
+        if ((0 == this->growth_left) and (EMPTY == position.group->tags[position.slot]))
+        {
+            this->rehash();
+            position = findFree(*(this->active_table), node->hash);
+        }
+
+        if (EMPTY == position.group->tags[position.slot])
+        { --this->growth_left; }
+
+        position.group->slots[position.slot] = node;
+        position.group->tags[position.slot]  = tagOf(node->hash);
+    }
+
+    ///
+    /// \brief rehash moves everything to the spare table, dropping the tombstones on the way.
+    ///
+    auto rehash() noexcept(true) -> void
+    {
+        auto const source{ this->active_table };
+        auto const target{ (source == this->tables[0].get()) ? this->tables[1].get() : this->tables[0].get() };
+
+        target->clear();
+
+        // Not nodes_number: the nodes still in the previous table stay there.
+        Size moved{ 0 };
+        for (Size i{ 0 }; i <= source->mask; ++i)
+        {
+            for (Size slot{ 0 }; slot < GROUP_WIDTH; ++slot)
+            {
+                if (0 <= source->groups[i].tags[slot])
+                {
+                    auto const node{ source->groups[i].slots[slot] };
+                    auto const position{ findFree(*target, node->hash) };
+                    position.group->slots[position.slot] = node;
+                    position.group->tags[position.slot]  = tagOf(node->hash);
+                    ++moved;
+                }
+            }
+        }
+
+        this->active_table = target;
+        this->growth_left  = target->maxLoad() - moved;
+    }
+
+    ///
+    /// \brief migrate moves the nodes of up to `groups` of the previous table's groups to the active one.
+    /// \details Their slots become tombstones, so the probes for the nodes that are left still get past them.
+    /// Once it's empty, the previous table's retired.
+    ///
+    auto migrate(Size groups) noexcept(true) -> void
+    {
+        if (nullptr == this->draining_table)
+        { return; }
+
+        auto& source{ *(this->draining_table) };
+        for (; (0 != groups) and (this->migrated_groups <= source.mask); --groups, ++this->migrated_groups)
+        {
+            auto& group{ source.groups[this->migrated_groups] };
+            for (Size slot{ 0 }; slot < GROUP_WIDTH; ++slot)
+            {
+                if (0 <= group.tags[slot])
+                {
+                    auto const node{ group.slots[slot] };
+                    group.tags[slot]  = DELETED;
+                    group.slots[slot] = nullptr;
+                    this->link(node);
+                }
+            }
+        }
+
+        if (source.mask < this->migrated_groups)
+        { this->retirePrevious(); }
+    }
+
+    auto retirePrevious() noexcept(true) -> void
+    {
+        if (nullptr == this->previous_table)
+        { return; }
+
+        this->draining_table = nullptr;
+        this->retired_tables.push_back(std::move(this->previous_table));
+    }
+
+}; // FlatHashMap
+
+} // core
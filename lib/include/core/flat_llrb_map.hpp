@@ -1,16 +1,32 @@
 #pragma once
 
+#include "core/links.hpp"
+#include "core/map_policy.hpp"
+#include "core/seq_lock.hpp"
+#include "core/span.hpp"
 #include "core/types.hpp"
 
-#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace core
 {
 
+///
+/// \name core::FlatLLRBMap
+/// \brief The FlatLLRBMap class is a left-leaning red-black tree over externally owned nodes.
+/// \tparam Policy hands out the nodes and is told about them, see core::CallbackPolicy.
+/// \tparam Links is what the nodes link each other w/, see core::PointerLinks.
+///
 template <
     typename KeyType,
     typename ValueType,
-    typename Node
+    typename Node,
+    typename Policy = CallbackPolicy<Node>,
+    typename Links  = PointerLinks<Node>
 >
 class FlatLLRBMap
 {
@@ -33,6 +49,9 @@ private: // Types:
 
         auto setBlack() noexcept(true) -> void
         { this->is_red = BIN_FALSE; }
+
+        auto flip() noexcept(true) -> void
+        { this->is_red ^= BIN_TRUE; }
     };
 
 private: // Constants:
@@ -45,30 +64,39 @@ public: // Types:
         using key_type    = KeyType;
         using mapped_type = ValueType;
 
-        Node* left{};
-        Node* parent{};
-        Node* right{};
+        typename Links::Link left{ Links::NONE };
+        typename Links::Link right{ Links::NONE };
 
         Flags flags{};
 
-        friend FlatLLRBMap<KeyType, ValueType, Node>;
+        // Whatever the policy: the node types don't depend on it.
+        template <typename, typename, typename, typename, typename>
+        friend class FlatLLRBMap;
 
     public: // Fields:
-        key_type    first;
         mapped_type second;
+        key_type    first; // Last: an inline key may be much longer than the rest.
 
     }; // NodeTrait
 
+    struct Sorted {};
+
+public: // Constants:
+    inline static constexpr Size BATCH_WIDTH{ 64 }; // findOptimisticBatch()'s keys in flight: a bit per key.
+    inline static constexpr Sorted SORTED{};
+
 public:
-    FlatLLRBMap(core::Capacity const capacity) noexcept(true)
+    FlatLLRBMap(core::Capacity const capacity, Policy policy = Policy{}, Links links = Links{}) noexcept(true)
         : capacity{ capacity }
+        , policy{ std::move(policy) }
+        , links{ links }
     {}
 
     auto size() const noexcept(true) -> core::Size
     { return this->nodes_number; };
 
     auto maxSize() const noexcept(true) -> core::Size
-    { return this->nodes_number; };
+    { return this->capacity; };
 
     enum class CmpResult : std::uint8_t
     { EQ, LT, GT };
@@ -82,45 +110,41 @@ public:
     >
     inline static auto cmp(LHSType const& lhs, RHSType const& rhs) -> CmpResult
     {
-        CmpResult cmp_result{ CmpResult::EQ };
-
         if constexpr (LHS2RHS)
+        { return cmpSame(static_cast<RHSType const&>(lhs), rhs); }
+        else
+        { return cmpSame(lhs, static_cast<LHSType const&>(rhs)); }
+    }
+
+private:
+    template <typename Type>
+    inline static auto cmpSame(Type const& lhs, Type const& rhs) -> CmpResult
+    {
+        // One pass over the bytes instead of == followed by <.
+        if constexpr (std::is_convertible_v<Type const&, std::string_view>)
         {
-            cmp_result = (
-                (static_cast<RHSType const&>(lhs) == rhs)
-                    ? CmpResult::EQ
-                    : ((static_cast<RHSType const&>(lhs) < rhs)
-                        ? CmpResult::LT
-                        : CmpResult::GT)
-            );
-        }
-        else if constexpr (RHS2LHS)
-        {
-            cmp_result = (
-                (lhs == static_cast<LHSType const&>(rhs))
-                ? CmpResult::EQ
-                : ((lhs < static_cast<LHSType const&>(rhs))
-                    ? CmpResult::LT
-                    : CmpResult::GT)
-            );
+            auto const cmp_result{
+                static_cast<std::string_view>(lhs).compare(static_cast<std::string_view>(rhs))
+            };
+            return (0 == cmp_result) ? CmpResult::EQ : ((0 > cmp_result) ? CmpResult::LT : CmpResult::GT);
         }
-
-        return cmp_result;
+        else
+        { return (lhs == rhs) ? CmpResult::EQ : ((lhs < rhs) ? CmpResult::LT : CmpResult::GT); }
     }
 
+public:
     auto createNode(KeyType const& key, ValueType const& value) noexcept(false) -> Node*
     {
-        if (not this->allocate_cb)
-        { throw std::bad_alloc{}; }
-
-        if (auto new_node{ this->allocate_cb() };
+        if (auto new_node{ this->policy.allocate() };
             nullptr != new_node)
         {
+            this->setLeft(new_node, nullptr);
+            this->setRight(new_node, nullptr);
+            new_node->flags.setRed();
             new_node->first  = key;
             new_node->second = value;
             
-            if (this->create_cb and
-                (CreateOrUpdateStatus::FATAL_ERROR == this->create_cb(new_node)))
+            if (CreateOrUpdateStatus::FATAL_ERROR == this->policy.onCreate(new_node))
             { throw std::runtime_error{"Fatal error in the create callback!"}; }
 
             ++this->nodes_number;
@@ -130,19 +154,24 @@ public:
         throw std::bad_alloc{};
     }
 
-    using ExistingOrCandidateType = std::pair<Node**, bool>;
+    using Link                    = typename Links::Link;
+    using ExistingOrCandidateType = std::pair<Link*, bool>;
 
+    ///
+    /// \return The link to the node holding `key` and true, or the link a new one would go to and false.
+    ///
     auto findExistingOrCandidate(KeyType const& key) noexcept(true) -> ExistingOrCandidateType
     {
-        auto node_ptr_it{ &(this->search_tree_root) };
+        auto link_it{ &(this->search_tree_root) };
         auto existing{ false };
 
-        while ((nullptr != *node_ptr_it) and (not existing))
+        for (auto node{ this->links.nodeOf(*link_it) }; (nullptr != node) and (not existing);
+             node = this->links.nodeOf(*link_it))
         {
-            switch (cmp(key, **node_ptr_it))
+            switch (cmp(key, *node))
             {
                 case CmpResult::LT:
-                { node_ptr_it = &((**node_ptr_it).left); }
+                { link_it = &(node->left); }
                 break;
 
                 case CmpResult::EQ:
@@ -150,85 +179,614 @@ public:
                 break;
 
                 case CmpResult::GT:
-                { node_ptr_it = &((**node_ptr_it).right); }
+                { link_it = &(node->right); }
                 break;
             }
         }
 
-        return ExistingOrCandidateType{ node_ptr_it, existing };
+        return ExistingOrCandidateType{ link_it, existing };
     }
 
+    ///
+    /// \return The node `link` links to, null for none: for following findExistingOrCandidate()'s.
+    ///
+    auto nodeOf(Link const link) const noexcept(true) -> Node*
+    { return this->links.nodeOf(link); }
+
     auto insertOrUpdate(KeyType const& key, ValueType const& value) -> void
     {
         auto existing_or_candidate{ this->findExistingOrCandidate(key) };
         if (true == existing_or_candidate.second)
         {
-            if ((nullptr != existing_or_candidate.first) and
-                (nullptr != *existing_or_candidate.first))
+            if (auto node{ this->links.nodeOf(*existing_or_candidate.first) };
+                nullptr != node)
             {
-                auto node{ *existing_or_candidate.first };
                 node->second = value;
-                if (this->update_cb)
-                { this->update_cb(node); }
+                (void)this->policy.onUpdate(node);
             }
             else
             { throw std::runtime_error{ "Bad element!" }; }
         }
         else
         {
-            if (this->size() == this->maxSize())
+            // Allocating may evict (and erase) another node, so it goes before the descent.
+            auto new_node{ this->createNode(key, value) };
+            auto const root{ this->insert(this->root(), new_node) };
+            root->flags.setBlack();
+            this->setRoot(root);
+        }
+    }
+
+    ///
+    /// \brief erase unlinks the node holding `key` from the tree. The node's storage is left to the owner.
+    /// \return true if there was such a node.
+    ///
+    auto erase(KeyType const& key) noexcept(true) -> bool
+    {
+        if (not this->findExistingOrCandidate(key).second)
+        { return false; }
+
+        auto root{ this->root() };
+        if (not this->isRed(this->leftOf(root)) and not this->isRed(this->rightOf(root)))
+        { root->flags.setRed(); }
+
+        root = this->erase(root, key);
+        if (nullptr != root)
+        { root->flags.setBlack(); }
+
+        this->setRoot(root);
+
+        --this->nodes_number;
+        return true;
+    }
+
+    ///
+    /// \return The number of nodes on the longest root-to-leaf path. Linear, meant for diagnostics only.
+    ///
+    auto depth() const noexcept(true) -> core::Size
+    { return this->depth(this->root()); }
+
+    ///
+    /// \brief findOptimistic is the lookup for readers that don't hold the writer's lock.
+    /// \details It never writes and never takes more than `capacity` steps, so it terminates even if the tree
+    /// is being restructured concurrently. The result means something only if the caller then validates
+    /// that no writer has intervened (see core::SeqLock), and the node's storage must be kept alive by
+    /// the caller (see core::EpochDomain). Like find(), it takes any `LookupKey`.
+    ///
+    template <typename LookupKey = KeyType>
+    auto findOptimistic(LookupKey const& key) const noexcept(true) -> Node const*
+    {
+        Node const* node{ this->links.nodeOf(core::racyLoad(this->search_tree_root)) };
+        auto const max_steps{ core::racyLoad(this->capacity) };
+        for (core::Size steps{ 0 }; (nullptr != node) and (steps <= max_steps); ++steps)
+        {
+            switch (cmp(key, node->first))
+            {
+                case CmpResult::LT:
+                { node = this->links.nodeOf(core::racyLoad(node->left)); }
+                break;
+
+                case CmpResult::EQ:
+                { return node; }
+
+                case CmpResult::GT:
+                { node = this->links.nodeOf(core::racyLoad(node->right)); }
+                break;
+            }
+        }
+
+        return nullptr;
+    }
+
+    ///
+    /// \brief findOptimisticBatch is findOptimistic for many keys at once: `found[i]` gets the node of `keys[i]`.
+    /// \details The descents are interleaved, a step of each in turn, and every next node is prefetched, so a
+    /// key's cache miss is overlapped w/ the steps of the others instead of stalling the walk. Up to
+    /// BATCH_WIDTH keys are in flight, more are looked up in rounds. Same contract as findOptimistic.
+    ///
+    auto findOptimisticBatch(
+        core::Span<KeyType const> keys,
+        core::Span<Node const*>   found
+    ) const noexcept(true) -> void
+    {
+        for (Size offset{ 0 }; offset < keys.size(); offset += BATCH_WIDTH)
+        {
+            auto const width{ std::min(keys.size() - offset, BATCH_WIDTH) };
+            this->findOptimisticRound(keys.subspan(offset, width), found.subspan(offset, width));
+        }
+    }
+
+    ///
+    /// \brief forEach calls `visit` w/ every node, in the key order.
+    ///
+    template <typename Visit>
+    auto forEach(Visit&& visit) const noexcept(false) -> void
+    { this->forEach(this->root(), visit); }
+
+    ///
+    /// \brief rebuild replaces the whole tree w/ the `nodes`, whose keys and values are set already.
+    /// \details Meant for filling an empty map in bulk: the nodes are sorted by key first, unless they come
+    /// sorted, then the tree is built bottom-up in one pass, as a perfectly balanced 2-3 tree. The keys have
+    /// to be unique, and the callbacks aren't called.
+    ///
+    auto rebuild(core::Span<Node*> nodes) noexcept(true) -> void
+    {
+        auto const by_key{
+            [] (Node const* lhs, Node const* rhs) -> bool
+            { return (CmpResult::LT == cmp(lhs->first, *rhs)); }
+        };
+
+        if (not std::is_sorted(nodes.begin(), nodes.end(), by_key))
+        { std::sort(nodes.begin(), nodes.end(), by_key); }
+
+        this->rebuild(core::Span<Node* const>{ nodes.data(), nodes.size() }, SORTED);
+    }
+
+    ///
+    /// \brief rebuild w/ the nodes the caller knows to be sorted by key already: it doesn't even check.
+    ///
+    auto rebuild(core::Span<Node* const> nodes, Sorted const&) noexcept(true) -> void
+    {
+        // The lowest tree that holds them all: a 2-3 tree of black height h holds up to 3^h - 1 nodes.
+        core::Size max_nodes{ 0 };
+        while (max_nodes < nodes.size())
+        { max_nodes = (max_nodes * 3) + 2; }
+
+        auto const root{ this->build(nodes.data(), nodes.size(), max_nodes) };
+        if (nullptr != root)
+        { root->flags.setBlack(); }
+
+        this->setRoot(root);
+
+        this->nodes_number = nodes.size();
+    }
+
+    ///
+    /// \brief find is the lookup for the writer's side: neither a hit nor a miss allocates or throws.
+    /// \tparam LookupKey is the key type, or one it compares w/ and converts to or from, e.g. std::string_view:
+    /// no key has to be made to look one up.
+    /// \return The node holding `key`, or null.
+    ///
+    template <typename LookupKey>
+    auto find(LookupKey const& key) noexcept(true) -> Node*
+    { return const_cast<Node*>(std::as_const(*this).find(key)); }
+
+    template <typename LookupKey>
+    auto find(LookupKey const& key) const noexcept(true) -> Node const*
+    {
+        Node const* node{ this->root() };
+        while (nullptr != node)
+        {
+            switch (cmp(key, node->first))
             {
-                // TODO remove
+                case CmpResult::LT:
+                { node = this->leftOf(node); }
+                break;
+
+                case CmpResult::EQ:
+                { return node; }
+
+                case CmpResult::GT:
+                { node = this->rightOf(node); }
+                break;
             }
+        }
+
+        return nullptr;
+    }
+
+    ///
+    /// \return The node holding the least key that isn't less than `key`, or null if there's none. Takes any
+    /// `LookupKey`, like find().
+    ///
+    template <typename LookupKey>
+    auto lowerBound(LookupKey const& key) noexcept(true) -> Node*
+    { return const_cast<Node*>(std::as_const(*this).lowerBound(key)); }
 
-            if (nullptr != existing_or_candidate.first)
-            { *existing_or_candidate.first = this->createNode(key, value); }
+    template <typename LookupKey>
+    auto lowerBound(LookupKey const& key) const noexcept(true) -> Node const*
+    {
+        Node const* bound{};
+        for (Node const* node{ this->root() }; nullptr != node; )
+        {
+            if (CmpResult::LT == cmp(node->first, key))
+            { node = this->rightOf(node); }
+            else
+            {
+                bound = node;
+                node  = this->leftOf(node);
+            }
         }
+
+        return bound;
     }
 
+    ///
+    /// \throws std::out_of_range on a miss: find() is the one for where misses are common.
+    ///
     auto at(KeyType const& key) noexcept(false) -> ValueType&
     {
-        auto existing_or_candidate{ this->findExistingOrCandidate(key) };
-        if (auto ptr{ existing_or_candidate.first };
-            (true == existing_or_candidate.second) and (nullptr != ptr) and (nullptr != *ptr))
-        { return (**ptr).second; }
+        if (auto const node{ this->find(key) };
+            nullptr != node)
+        { return node->second; }
 
         throw std::out_of_range{""};
     }
 
-public:
-    enum class CreateOrUpdateStatus : std::uint8_t
+    ///
+    /// \brief reserve makes room for `capacity` nodes: core::FlatHashMap's interface, the tree only counts them.
+    ///
+    auto reserve(core::Capacity const capacity) noexcept(true) -> void
+    { this->capacity = capacity; }
+
+    ///
+    /// \brief tableBytes is core::FlatHashMap's interface: the tree has no table, its links are in the nodes.
+    ///
+    [[nodiscard]]
+    auto tableBytes() const noexcept(true) -> core::Size
+    { return 0; }
+
+    ///
+    /// \brief reclaimRetired is core::FlatHashMap's interface: the tree has no tables to retire.
+    ///
+    template <typename Synchronize>
+    auto reclaimRetired(Synchronize&&) noexcept(true) -> void
+    {}
+
+    ///
+    /// \brief replace puts `to` in the place of `from`, which holds the same key: for moving an entry to
+    /// another node. `to`'s key and value are set already, `from`'s left to the owner.
+    /// \return false if `from` isn't in the tree.
+    ///
+    auto replace(Node const* from, Node* to) noexcept(true) -> bool
     {
-        SUCCESS,    // Welp, all's good!
-        ERROR,      // It's possible to live on w/ this kind of error.
-        FATAL_ERROR // Complite FUBAR!
+        auto const existing_or_candidate{ this->findExistingOrCandidate(from->first) };
+        if ((not existing_or_candidate.second) or (from != this->links.nodeOf(*existing_or_candidate.first)))
+        { return false; }
+
+        to->left  = from->left;
+        to->right = from->right;
+        to->flags = from->flags;
+
+        *existing_or_candidate.first = this->links.linkOf(to);
+        return true;
+    }
 
-    }; // CreateOrUpdateStatus
+private: // Lookup:
+    static auto prefetchNode(Node const* node) noexcept(true) -> void
+    {
+        // The links and the key are usually on different lines: the key is the node's last field.
+        core::prefetch(&(node->left));
+        core::prefetch(&(node->first));
+    }
+
+    auto findOptimisticRound(
+        core::Span<KeyType const> keys,
+        core::Span<Node const*>   found
+    ) const noexcept(true) -> void
+    {
+        auto const root{ this->links.nodeOf(core::racyLoad(this->search_tree_root)) };
+        for (auto& cursor : found)
+        { cursor = root; }
+
+        if ((nullptr == root) or keys.empty())
+        { return; }
+
+        prefetchNode(root);
+
+        // The cursors are kept in `found`: a key leaves the flight on its node or on a dead end.
+        auto in_flight{ (BATCH_WIDTH == keys.size()) ? ~std::uint64_t{ 0 }
+                                                     : ((std::uint64_t{ 1 } << keys.size()) - 1) };
+        auto const max_steps{ core::racyLoad(this->capacity) };
+        for (core::Size steps{ 0 }; (0 != in_flight) and (steps <= max_steps); ++steps)
+        {
+            for (auto pending{ in_flight }; 0 != pending; pending &= (pending - 1))
+            {
+                auto const i{ static_cast<Size>(__builtin_ctzll(pending)) };
+                auto const node{ found[i] };
+
+                Node const* next{};
+                switch (cmp(keys[i], *node))
+                {
+                    case CmpResult::LT:
+                    { next = this->links.nodeOf(core::racyLoad(node->left)); }
+                    break;
+
+                    case CmpResult::EQ:
+                    {
+                        in_flight &= ~(std::uint64_t{ 1 } << i);
+                        continue;
+                    }
+
+                    case CmpResult::GT:
+                    { next = this->links.nodeOf(core::racyLoad(node->right)); }
+                    break;
+                }
+
+                found[i] = next;
+                if (nullptr == next)
+                { in_flight &= ~(std::uint64_t{ 1 } << i); }
+                else
+                { prefetchNode(next); }
+            }
+        }
+
+        // Out of steps: the tree's being restructured under us, the caller's validation fails anyway.
+        for (; 0 != in_flight; in_flight &= (in_flight - 1))
+        { found[static_cast<Size>(__builtin_ctzll(in_flight))] = nullptr; }
+    }
+
+private: // Bulk:
+    template <typename Visit>
+    auto forEach(Node const* node, Visit& visit) const noexcept(false) -> void
+    {
+        for (; nullptr != node; node = this->rightOf(node))
+        {
+            this->forEach(this->leftOf(node), visit);
+            visit(node);
+        }
+    }
+
+    ///
+    /// \brief build links the sorted `nodes` into a 2-3 tree whose leaves are all at the same black depth.
+    /// \param max_nodes is what a tree of that black height holds: 3^h - 1, so each subtree holds
+    /// (max_nodes - 2) / 3. A 3-node is the red left child of a black node.
+    /// \return The root of the subtree, black.
+    ///
+    auto build(Node* const* nodes, core::Size count, core::Size max_nodes) const noexcept(true) -> Node*
+    {
+        if (0 == count)
+        { return nullptr; }
+
+        auto const child_max{ (max_nodes - 2) / 3 };
+
+        // A 2-node if two subtrees hold the rest, a 3-node otherwise: the rest is spread over three.
+        if ((count - 1) <= (2 * child_max))
+        {
+            auto const left{ (count - 1) / 2 };
+            return this->link(nodes[left], this->build(nodes, left, child_max),
+                              this->build(nodes + left + 1, count - 1 - left, child_max), false);
+        }
+
+        auto const rest{ count - 2 };
+        auto const left{ (rest / 3) + (((rest % 3) > 0) ? 1 : 0) };
+        auto const middle{ (rest / 3) + (((rest % 3) > 1) ? 1 : 0) };
+        auto const right{ rest - left - middle };
+
+        auto const red{ this->link(nodes[left], this->build(nodes, left, child_max),
+                                   this->build(nodes + left + 1, middle, child_max), true) };
+        return this->link(nodes[left + 1 + middle], red,
+                          this->build(nodes + left + 2 + middle, right, child_max), false);
+    }
+
+    auto link(Node* node, Node const* left, Node const* right, bool const red) const noexcept(true) -> Node*
+    {
+        this->setLeft(node, left);
+        this->setRight(node, right);
+        if (red)
+        { node->flags.setRed(); }
+        else
+        { node->flags.setBlack(); }
+
+        return node;
+    }
+
+private: // Links:
+    auto root() const noexcept(true) -> Node*
+    { return this->links.nodeOf(this->search_tree_root); }
+
+    auto setRoot(Node const* root) noexcept(true) -> void
+    { this->search_tree_root = this->links.linkOf(root); }
+
+    auto leftOf(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->left); }
+
+    auto rightOf(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->right); }
+
+    auto setLeft(Node* node, Node const* left) const noexcept(true) -> void
+    { node->left = this->links.linkOf(left); }
+
+    auto setRight(Node* node, Node const* right) const noexcept(true) -> void
+    { node->right = this->links.linkOf(right); }
+
+private: // Balancing:
+    static auto isRed(Node const* node) noexcept(true) -> bool
+    { return ((nullptr != node) and node->flags.isRed()); }
+
+    auto depth(Node const* node) const noexcept(true) -> core::Size
+    {
+        if (nullptr == node)
+        { return 0; }
+
+        return 1 + std::max(this->depth(this->leftOf(node)), this->depth(this->rightOf(node)));
+    }
+
+    auto rotateLeft(Node* node) const noexcept(true) -> Node*
+    {
+        auto pivot{ this->rightOf(node) };
+        node->right  = pivot->left;
+        this->setLeft(pivot, node);
+        pivot->flags = node->flags;
+        node->flags.setRed();
+        return pivot;
+    }
+
+    auto rotateRight(Node* node) const noexcept(true) -> Node*
+    {
+        auto pivot{ this->leftOf(node) };
+        node->left   = pivot->right;
+        this->setRight(pivot, node);
+        pivot->flags = node->flags;
+        node->flags.setRed();
+        return pivot;
+    }
+
+    auto flipColors(Node* node) const noexcept(true) -> void
+    {
+        node->flags.flip();
+        this->leftOf(node)->flags.flip();
+        this->rightOf(node)->flags.flip();
+    }
+
+    ///
+    /// \brief fixUp restores the left-leaning invariants on the way up.
+    ///
+    auto fixUp(Node* node) const noexcept(true) -> Node*
+    {
+        if (isRed(this->rightOf(node)) and not isRed(this->leftOf(node)))
+        { node = this->rotateLeft(node); }
+
+        if (isRed(this->leftOf(node)) and isRed(this->leftOf(this->leftOf(node))))
+        { node = this->rotateRight(node); }
+
+        if (isRed(this->leftOf(node)) and isRed(this->rightOf(node)))
+        { this->flipColors(node); }
+
+        return node;
+    }
+
+    auto moveRedLeft(Node* node) const noexcept(true) -> Node*
+    {
+        this->flipColors(node);
+        if (isRed(this->leftOf(this->rightOf(node))))
+        {
+            this->setRight(node, this->rotateRight(this->rightOf(node)));
+            node = this->rotateLeft(node);
+            this->flipColors(node);
+        }
+
+        return node;
+    }
+
+    auto moveRedRight(Node* node) const noexcept(true) -> Node*
+    {
+        this->flipColors(node);
+        if (isRed(this->leftOf(this->leftOf(node))))
+        {
+            node = this->rotateRight(node);
+            this->flipColors(node);
+        }
+
+        return node;
+    }
+
+    ///
+    /// \brief insert links `new_node` (known not to be in the tree) into the subtree.
+    /// \return The new root of the subtree.
+    ///
+    auto insert(Node* node, Node* new_node) const noexcept(true) -> Node*
+    {
+        if (nullptr == node)
+        { return new_node; }
+
+        if (CmpResult::LT == cmp(new_node->first, *node))
+        { this->setLeft(node, this->insert(this->leftOf(node), new_node)); }
+        else
+        { this->setRight(node, this->insert(this->rightOf(node), new_node)); }
+
+        return this->fixUp(node);
+    }
+
+    ///
+    /// \brief eraseMin unlinks the subtree's minimum, which is left in `*min_node`.
+    /// \return The new root of the subtree.
+    ///
+    auto eraseMin(Node* node, Node** min_node) const noexcept(true) -> Node*
+    {
+        if (nullptr == this->leftOf(node))
+        {
+            *min_node = node;
+            return nullptr;
+        }
+
+        if (not isRed(this->leftOf(node)) and not isRed(this->leftOf(this->leftOf(node))))
+        { node = this->moveRedLeft(node); }
+
+        this->setLeft(node, this->eraseMin(this->leftOf(node), min_node));
+        return this->fixUp(node);
+    }
+
+    ///
+    /// \brief erase unlinks the node w/ `key` (known to be in the subtree).
+    /// \details Nodes are slab slots that others (e.g. the ladder) point to, so instead of moving the successor's
+    /// key and value into the erased node, the successor node itself takes the erased node's place.
+    /// \return The new root of the subtree.
+    ///
+    auto erase(Node* node, KeyType const& key) const noexcept(true) -> Node*
+    {
+        if (CmpResult::LT == cmp(key, *node))
+        {
+            if (not isRed(this->leftOf(node)) and not isRed(this->leftOf(this->leftOf(node))))
+            { node = this->moveRedLeft(node); }
+
+            this->setLeft(node, this->erase(this->leftOf(node), key));
+        }
+        else
+        {
+            if (isRed(this->leftOf(node)))
+            { node = this->rotateRight(node); }
+
+            if ((CmpResult::EQ == cmp(key, *node)) and (nullptr == this->rightOf(node)))
+            {
+                this->setLeft(node, nullptr);
+                return nullptr;
+            }
+
+            if (not isRed(this->rightOf(node)) and not isRed(this->leftOf(this->rightOf(node))))
+            { node = this->moveRedRight(node); }
+
+            if (CmpResult::EQ == cmp(key, *node))
+            {
+                Node* successor{};
+                auto right{ this->eraseMin(this->rightOf(node), &successor) };
+
+                successor->left  = node->left;
+                this->setRight(successor, right);
+                successor->flags = node->flags;
+
+                this->setLeft(node, nullptr);
+                this->setRight(node, nullptr);
+                node = successor;
+            }
+            else
+            { this->setRight(node, this->erase(this->rightOf(node), key)); }
+        }
+
+        return this->fixUp(node);
+    }
 
 public:
-    using AllocateCallback = std::function<Node* ()>;
-    using AccessCallback   = std::function<CreateOrUpdateStatus (Node*)>;
+    using CreateOrUpdateStatus = core::CreateOrUpdateStatus;
+
+    auto getPolicy() noexcept(true) -> Policy&
+    { return this->policy; }
 
-    auto setAllocateCallback(AllocateCallback allocate_cb) noexcept(true) -> void
-    { this->allocate_cb = std::move(allocate_cb); }
+    ///
+    /// \name The callbacks' setters: there only w/ the CallbackPolicy.
+    ///
+    template <typename P = Policy>
+    auto setAllocateCallback(typename P::AllocateCallback allocate_cb) noexcept(true) -> void
+    { this->policy.setAllocateCallback(std::move(allocate_cb)); }
 
-    auto setCreateCallback(AccessCallback create_cb) noexcept(true) -> void
-    { this->create_cb = std::move(create_cb); }
+    template <typename P = Policy>
+    auto setCreateCallback(typename P::AccessCallback create_cb) noexcept(true) -> void
+    { this->policy.setCreateCallback(std::move(create_cb)); }
 
-    auto setUpdateCallback(AccessCallback update_cb) noexcept(true) -> void
-    { this->update_cb = std::move(update_cb); }
+    template <typename P = Policy>
+    auto setUpdateCallback(typename P::AccessCallback update_cb) noexcept(true) -> void
+    { this->policy.setUpdateCallback(std::move(update_cb)); }
 
-    auto setUseCallback(AccessCallback use_cb) noexcept(true) -> void
-    { this->use_cb = std::move(use_cb); }
+    template <typename P = Policy>
+    auto setUseCallback(typename P::AccessCallback use_cb) noexcept(true) -> void
+    { this->policy.setUseCallback(std::move(use_cb)); }
 
 private: // Fields:
-    Node*                search_tree_root{};
+    Link                 search_tree_root{ Links::NONE };
     core::Size           nodes_number{};
-    core::Capacity const capacity{};
-    AllocateCallback     allocate_cb{};
-    AccessCallback       create_cb{};
-    AccessCallback       update_cb{};
-    AccessCallback       use_cb{};
+    core::Capacity       capacity{};
+    Policy               policy;
+    Links                links;
 
 }; // FlatLLRBMap
 
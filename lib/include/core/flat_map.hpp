@@ -1,11 +1,57 @@
 #pragma once
 
+#include "flat_hash_map.hpp"
 #include "flat_llrb_map.hpp"
+#include "links.hpp"
+#include "map_policy.hpp"
+
+#include <functional>
 
 namespace core
 {
 
-template <typename KeyType, typename ValueType, typename NodeType>
-using FlatMap = FlatLLRBMap<KeyType, ValueType, NodeType>;
+///
+/// \brief Index kinds for core::FlatMap.
+///
+struct OrderedIndex {}; // core::FlatLLRBMap: keys are kept sorted.
+struct HashedIndex {};  // core::FlatHashMap: no order, O(1) lookups.
+
+namespace detail
+{
+
+template <typename IndexKind>
+struct FlatMapSelector;
+
+template <>
+struct FlatMapSelector<OrderedIndex>
+{
+    template <typename KeyType, typename ValueType, typename NodeType, typename Policy, typename Links>
+    using Map = FlatLLRBMap<KeyType, ValueType, NodeType, Policy, Links>;
+};
+
+// The table holds the links to the nodes, the nodes none: the Links are of no use.
+template <>
+struct FlatMapSelector<HashedIndex>
+{
+    template <typename KeyType, typename ValueType, typename NodeType, typename Policy, typename>
+    using Map = FlatHashMap<KeyType, ValueType, NodeType, std::hash<KeyType>, Policy>;
+};
+
+} // detail
+
+///
+/// \brief FlatMap is the index of the kind asked for; the nodes' NodeTrait is the same whatever the `Policy`.
+/// \tparam Links is what an ordered index' nodes link each other w/, see core::PointerLinks.
+///
+template <
+    typename KeyType,
+    typename ValueType,
+    typename NodeType,
+    typename IndexKind = OrderedIndex,
+    typename Policy    = CallbackPolicy<NodeType>,
+    typename Links     = PointerLinks<NodeType>
+>
+using FlatMap =
+    typename detail::FlatMapSelector<IndexKind>::template Map<KeyType, ValueType, NodeType, Policy, Links>;
 
 } // core
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace core
+{
+
+///
+/// \name core::FrequencySketch
+/// \brief The FrequencySketch class estimates how often a key has been seen: a count-min sketch of 4-bit
+/// counters, 16 per word.
+/// \details A key has a counter in each of the 4 rows, its estimate is the smallest of them. Once there
+/// have been 10 increments per tracked key, all the counters are halved, so the past fades out.
+///
+/// It's shared by the lock-free readers: the counters are relaxed atomics, and an increment only writes
+/// if a counter isn't saturated yet, so the hot keys' words stay clean. Losing an increment to a racing
+/// aging is fine for an estimate.
+///
+class FrequencySketch
+{
+private: // Constants:
+    inline static constexpr Size          ROWS_NUMBER{ 4 };
+    inline static constexpr Size          COUNTER_BITS{ 4 };
+    inline static constexpr std::uint64_t COUNTER_MAX{ (1u << COUNTER_BITS) - 1 };
+    inline static constexpr Size          SAMPLE_FACTOR{ 10 };
+    inline static constexpr std::uint64_t AGING_MASK{ 0x7777'7777'7777'7777ull };
+
+    inline static constexpr std::array<std::uint64_t, ROWS_NUMBER> ROW_SEEDS{
+        0x9E37'79B9'7F4A'7C15ull,
+        0xC2B2'AE3D'27D4'EB4Full,
+        0x1656'67B1'9E37'79F9ull,
+        0xFF51'AFD7'ED55'8CCDull
+    };
+
+private: // Fields:
+    Size                                          words_mask{};
+    Size                                          sample_size{};
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words{};
+    std::atomic<Size>                             additions{ 0 };
+
+public: // RAII:
+    ///
+    /// \param capacity is the number of keys worth tracking: about a word per key.
+    ///
+    explicit FrequencySketch(Capacity const capacity) noexcept(false)
+        : sample_size{ SAMPLE_FACTOR * std::max<Capacity>(capacity, 1) }
+    {
+        Size words_number{ 16 };
+        while (words_number < capacity)
+        { words_number <<= 1; }
+
+        this->words_mask = words_number - 1;
+        this->words      = std::make_unique<std::atomic<std::uint64_t>[]>(words_number);
+        for (Size i{ 0 }; i < words_number; ++i)
+        { this->words[i].store(0, std::memory_order_relaxed); }
+    }
+
+    FrequencySketch& operator = (FrequencySketch const&) = delete;
+    FrequencySketch(FrequencySketch const&)              = delete;
+
+public: // Methods:
+    auto increment(std::uint64_t const hash) noexcept(true) -> void
+    {
+        bool incremented{ false };
+        for (Size row{ 0 }; row < ROWS_NUMBER; ++row)
+        {
+            auto const [word, shift]{ this->counterOf(hash, row) };
+
+            auto value{ word.load(std::memory_order_relaxed) };
+            while ((COUNTER_MAX > ((value >> shift) & COUNTER_MAX)) and
+                   not word.compare_exchange_weak(value, value + (std::uint64_t{ 1 } << shift),
+                                                  std::memory_order_relaxed))
+            {}
+
+            incremented = (incremented or (COUNTER_MAX > ((value >> shift) & COUNTER_MAX)));
+        }
+
+        if (incremented)
+        {
+            auto const additions{ this->additions.fetch_add(1, std::memory_order_relaxed) + 1 };
+            if (this->sample_size <= additions)
+            { this->age(additions); }
+        }
+    }
+
+    [[nodiscard]]
+    auto estimate(std::uint64_t const hash) const noexcept(true) -> std::uint8_t
+    {
+        auto frequency{ COUNTER_MAX };
+        for (Size row{ 0 }; row < ROWS_NUMBER; ++row)
+        {
+            auto const [word, shift]{ this->counterOf(hash, row) };
+            frequency = std::min(frequency, (word.load(std::memory_order_relaxed) >> shift) & COUNTER_MAX);
+        }
+
+        return static_cast<std::uint8_t>(frequency);
+    }
+
+private: // Helpers:
+    struct CounterLocation
+    {
+        std::atomic<std::uint64_t>& word;
+        Size                        shift;
+    };
+
+    auto counterOf(std::uint64_t const hash, Size const row) const noexcept(true) -> CounterLocation
+    {
+        auto mixed{ (hash + ROW_SEEDS[row]) * ROW_SEEDS[(row + 1) % ROWS_NUMBER] };
+        mixed ^= (mixed >> 32);
+
+        auto const counter{ static_cast<Size>(mixed >> 60) };
+        return CounterLocation{ this->words[mixed & this->words_mask], counter * COUNTER_BITS };
+    }
+
+    ///
+    /// \brief age halves all the counters. Only the increment that wins resetting the additions does it.
+    ///
+    auto age(Size additions) noexcept(true) -> void
+    {
+        if (not this->additions.compare_exchange_strong(additions, additions / 2, std::memory_order_relaxed))
+        { return; }
+
+        for (Size i{ 0 }; i <= this->words_mask; ++i)
+        {
+            auto const value{ this->words[i].load(std::memory_order_relaxed) };
+            this->words[i].store((value >> 1) & AGING_MASK, std::memory_order_relaxed);
+        }
+    }
+
+}; // FrequencySketch
+
+} // core
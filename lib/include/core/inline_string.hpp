@@ -0,0 +1,112 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+
+namespace core
+{
+
+///
+/// \name core::InlineString
+/// \brief The InlineString class is a length-prefixed string in a fixed inline buffer.
+/// \details It never allocates, so it can live in a node slab: reusing a node overwrites the bytes in place.
+/// Copies only move the used part of the buffer.
+///
+template <Size MAX_LENGTH>
+class InlineString
+{
+    static_assert((0 < MAX_LENGTH) and (MAX_LENGTH <= 0xFF), "The length has to fit its one-byte prefix.");
+
+private: // Fields:
+    std::uint8_t                length{ 0 };
+    std::array<char, MAX_LENGTH> chars;
+
+public: // RAII:
+    InlineString() noexcept(true) = default;
+
+    ///
+    /// \throws std::length_error if `str` doesn't fit.
+    ///
+    explicit InlineString(std::string_view const str) noexcept(false)
+    { this->assign(str); }
+
+    InlineString(InlineString const& other) noexcept(true)
+        : length{ other.length }
+    { std::memcpy(this->chars.data(), other.chars.data(), other.length); }
+
+    auto operator = (InlineString const& other) noexcept(true) -> InlineString&
+    {
+        this->length = other.length;
+        std::memmove(this->chars.data(), other.chars.data(), other.length);
+        return *this;
+    }
+
+public: // Methods:
+    [[nodiscard]]
+    static constexpr auto maxSize() noexcept(true) -> Size
+    { return MAX_LENGTH; }
+
+    [[nodiscard]]
+    static constexpr auto fits(std::string_view const str) noexcept(true) -> bool
+    { return (str.size() <= MAX_LENGTH); }
+
+    auto assign(std::string_view const str) noexcept(false) -> void
+    {
+        if (not fits(str))
+        { throw std::length_error{ "The string doesn't fit the inline buffer!" }; }
+
+        this->length = static_cast<std::uint8_t>(str.size());
+        std::memcpy(this->chars.data(), str.data(), str.size());
+    }
+
+    [[nodiscard]]
+    auto size() const noexcept(true) -> Size
+    { return this->length; }
+
+    [[nodiscard]]
+    auto data() const noexcept(true) -> char const*
+    { return this->chars.data(); }
+
+    [[nodiscard]]
+    auto view() const noexcept(true) -> std::string_view
+    { return std::string_view{ this->chars.data(), this->length }; }
+
+    operator std::string_view () const noexcept(true)
+    { return this->view(); }
+
+    friend auto operator == (InlineString const& lhs, InlineString const& rhs) noexcept(true) -> bool
+    {
+        return ((lhs.length == rhs.length) and
+                (0 == std::memcmp(lhs.chars.data(), rhs.chars.data(), lhs.length)));
+    }
+
+    friend auto operator != (InlineString const& lhs, InlineString const& rhs) noexcept(true) -> bool
+    { return not (lhs == rhs); }
+
+    friend auto operator < (InlineString const& lhs, InlineString const& rhs) noexcept(true) -> bool
+    { return (lhs.view() < rhs.view()); }
+
+}; // InlineString
+
+} // core
+
+namespace std
+{
+
+template <core::Size MAX_LENGTH>
+struct hash<core::InlineString<MAX_LENGTH>>
+{
+    auto operator () (core::InlineString<MAX_LENGTH> const& str) const noexcept(true) -> std::size_t
+    { return std::hash<std::string_view>{}(str.view()); }
+
+    // So the hashed indexes can look a view up w/o making a key of it.
+    auto operator () (std::string_view const str) const noexcept(true) -> std::size_t
+    { return std::hash<std::string_view>{}(str); }
+};
+
+} // std
@@ -1,22 +1,35 @@
 #pragma once
 
+#include "core/links.hpp"
+#include "core/span.hpp"
 #include "core/types.hpp"
 
+#include <atomic>
 #include <stdexcept>
 
 namespace core
 {
 
-template <typename Node>
+///
+/// \name core::Ladder
+/// \brief The Ladder class is the LRU-like replacement policy: the nodes are ordered from the next victim
+/// (the bottom) up to the most recently inserted one (the top).
+/// \details Writers promote the nodes they touch. Readers only mark them referenced (see reference()), so
+/// a hit writes no links: the promotion is deferred to releaseBottom(), which gives a referenced bottom
+/// node a second chance at the top instead of releasing it.
+/// \tparam Links is what the nodes link each other w/, see core::PointerLinks.
+///
+template <typename Node, typename Links = PointerLinks<Node>>
 class Ladder
 {
 public: // Types:
     class NodeTrait
     {
-        Node* next_ladder_item{};
-        Node* prev_ladder_item{};
+        typename Links::Link      next_ladder_item{ Links::NONE };
+        typename Links::Link      prev_ladder_item{ Links::NONE };
+        mutable std::atomic<bool> referenced{ false };
 
-        friend Ladder<Node>;
+        friend Ladder<Node, Links>;
     };
 
     struct ToTop {};
@@ -40,33 +53,39 @@ public: // Types:
 public: // Constants:
     inline static constexpr ToTop TO_TOP{};
     inline static constexpr OneUp ONE_UP{};
+    inline static constexpr ToBottom TO_BOTTOM{};
     inline static constexpr core::Capacity MINIMAL_VIABLE_CAPACITY{ 3 };
 
+private: // Constants:
+    inline static constexpr Size RELINK_PREFETCH_DISTANCE{ 16 };
+
 private: // Fields:
-    Capacity const capacity{};
+    Capacity       capacity{};
+    Links          links;
     Node*          ladder_bottom{}; // start of the linked list
     Node*          ladder_top{}; // end of the linked list for fast promoting reallocated nodes
 
 public: // RAII:
-    Ladder(Node* storage, Capacity capacity) noexcept(false)
+    Ladder(Node* storage, Capacity capacity, Links links = Links{}) noexcept(false)
         : capacity{ capacity }
+        , links{ links }
         , ladder_bottom{ storage }
         , ladder_top{ storage + (capacity - 1) }
     {
         if ((nullptr == this->ladder_bottom) or (MINIMAL_VIABLE_CAPACITY > this->capacity))
         { throw std::logic_error("BadArgs"); }
 
-        this->ladder_bottom->next_ladder_item = this->ladder_bottom + 1;
+        this->setNext(this->ladder_bottom, this->ladder_bottom + 1);
 
         auto const last_to_modify{ this->ladder_top - 1 };
-        for (auto it_ptr{ this->ladder_bottom->next_ladder_item }; it_ptr <= last_to_modify; ++it_ptr)
+        for (auto it_ptr{ this->ladder_bottom + 1 }; it_ptr <= last_to_modify; ++it_ptr)
         {
-            it_ptr->next_ladder_item = it_ptr + 1;
-            it_ptr->prev_ladder_item = it_ptr - 1;
+            this->setNext(it_ptr, it_ptr + 1);
+            this->setPrev(it_ptr, it_ptr - 1);
         }
 
-        this->ladder_top->prev_ladder_item = this->ladder_top - 1;
-        this->ladder_top->next_ladder_item = nullptr;
+        this->setPrev(this->ladder_top, this->ladder_top - 1);
+        this->setNext(this->ladder_top, nullptr);
     }
 
 public: // Methods:
@@ -74,75 +93,283 @@ public: // Methods:
     auto maxSize() noexcept(true) -> Capacity
     { return this->capacity; }
 
+    ///
+    /// \brief reference marks a hit. Safe to call w/o the writer's lock: it's a relaxed store, if any.
+    ///
+    static auto reference(Node const* node) noexcept(true) -> void
+    {
+        // Don't dirty the line if it's already marked.
+        if (not node->referenced.load(std::memory_order_relaxed))
+        { node->referenced.store(true, std::memory_order_relaxed); }
+    }
+
+    ///
+    /// \brief releaseBottom unlinks and returns the victim: the lowest node that hasn't been referenced
+    /// since it last got here. The referenced ones on the way go to the top.
+    ///
     [[nodiscard]]
     auto releaseBottom() noexcept(false) -> Node*
     {
+        // Bounded, as the readers may keep marking the nodes again meanwhile.
+        for (Capacity chances{ 0 };
+             (chances < this->capacity) and (nullptr != this->ladder_bottom) and
+             (this->ladder_bottom != this->ladder_top) and
+             this->ladder_bottom->referenced.load(std::memory_order_relaxed);
+             ++chances)
+        {
+            auto const referenced_node{ this->ladder_bottom };
+            referenced_node->referenced.store(false, std::memory_order_relaxed);
+            (void)this->promote(referenced_node, TO_TOP);
+        }
+
         if (nullptr != this->ladder_bottom)
         {
             auto free_node                        = this->ladder_bottom;
-            this->ladder_bottom                   = free_node->next_ladder_item;
+            this->ladder_bottom                   = this->next(free_node);
 
-            if ((nullptr != this->ladder_bottom) and
-                (nullptr != this->ladder_bottom->prev_ladder_item))
-            { this->ladder_bottom->prev_ladder_item = nullptr; }
+            if (nullptr != this->ladder_bottom)
+            { this->setPrev(this->ladder_bottom, nullptr); }
+            else
+            { this->ladder_top = nullptr; }
 
-            free_node->next_ladder_item           = nullptr;
-            free_node->prev_ladder_item           = nullptr;
+            this->setNext(free_node, nullptr);
+            this->setPrev(free_node, nullptr);
+            free_node->referenced.store(false, std::memory_order_relaxed);
             return free_node;
         }
 
         throw std::runtime_error{ "Bad ladder bottom!" };
     }
 
+    ///
+    /// \brief forEachFromBottom calls `visit` w/ every node on the ladder, from the next victim up to the top.
+    ///
+    template <typename Visit>
+    auto forEachFromBottom(Visit&& visit) const noexcept(false) -> void
+    {
+        for (auto node{ this->ladder_bottom }; nullptr != node; node = this->next(node))
+        { visit(node); }
+    }
+
+    ///
+    /// \brief extend puts more nodes on the ladder, at the bottom: they're the next to be released, `nodes[0]`
+    /// first. The ladder's as many nodes longer.
+    ///
+    auto extend(Span<Node* const> nodes) noexcept(true) -> void
+    {
+        for (auto i{ nodes.size() }; 0 < i; --i)
+        {
+            auto const node{ nodes[i - 1] };
+            this->setPrev(node, nullptr);
+            this->setNext(node, this->ladder_bottom);
+            node->referenced.store(false, std::memory_order_relaxed);
+
+            if (nullptr != this->ladder_bottom)
+            { this->setPrev(this->ladder_bottom, node); }
+            else
+            { this->ladder_top = node; }
+
+            this->ladder_bottom = node;
+        }
+
+        this->capacity += nodes.size();
+    }
+
+    ///
+    /// \brief shed is releaseBottom() for good: the ladder's a node shorter.
+    ///
+    [[nodiscard]]
+    auto shed() noexcept(false) -> Node*
+    {
+        auto const node{ this->releaseBottom() };
+        --this->capacity;
+        return node;
+    }
+
+    ///
+    /// \brief replace puts `to`, which isn't on the ladder, in the place of `from`, which is; `from` is unlinked.
+    ///
+    auto replace(Node* from, Node* to) noexcept(true) -> void
+    {
+        auto const below{ this->prev(from) };
+        auto const above{ this->next(from) };
+        this->setPrev(to, below);
+        this->setNext(to, above);
+        to->referenced.store(from->referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        if (nullptr != below)
+        { this->setNext(below, to); }
+        else
+        { this->ladder_bottom = to; }
+
+        if (nullptr != above)
+        { this->setPrev(above, to); }
+        else
+        { this->ladder_top = to; }
+
+        this->setNext(from, nullptr);
+        this->setPrev(from, nullptr);
+        from->referenced.store(false, std::memory_order_relaxed);
+    }
+
+    ///
+    /// \brief relink puts the ladder's nodes in the given order, from the bottom up, all their marks cleared.
+    /// \details For bulk loads: the nodes only get written, never read. `nodes` has to be all of the ladder's.
+    ///
+    auto relink(Span<Node* const> nodes) noexcept(true) -> void
+    {
+        Node* below{};
+        for (Size i{ 0 }; i < nodes.size(); ++i)
+        {
+            // The nodes are anywhere in the storage: their lines are asked for well ahead.
+            if ((i + RELINK_PREFETCH_DISTANCE) < nodes.size())
+            { prefetchForWrite(nodes[i + RELINK_PREFETCH_DISTANCE]); }
+
+            auto const node{ nodes[i] };
+            this->setPrev(node, below);
+            this->setNext(node, nullptr);
+            node->referenced.store(false, std::memory_order_relaxed);
+
+            if (nullptr != below)
+            { this->setNext(below, node); }
+
+            below = node;
+        }
+
+        this->ladder_bottom = nodes.empty() ? nullptr : nodes[0];
+        this->ladder_top    = below;
+    }
+
+    ///
+    /// \brief demote moves the node to the bottom, so it's the next one to be released.
+    ///
+    [[nodiscard]]
     auto demote(Node* demotee, ToBottom const&) noexcept(true) -> DemotingStatus
     {
         if (nullptr == demotee)
+        { return DemotingStatus::ERROR; }
+
+        demotee->referenced.store(false, std::memory_order_relaxed);
+
+        if (demotee == this->ladder_bottom)
+        { return DemotingStatus::NON_DEMOTABLE; }
+
+        // Still on the ladder (and not at the bottom): unlink it first.
+        if (auto const below{ this->prev(demotee) };
+            nullptr != below)
+        {
+            auto const above{ this->next(demotee) };
+            if (nullptr != above)
+            { this->setPrev(above, below); }
+            else
+            { this->ladder_top = below; }
+
+            this->setNext(below, above);
+        }
+
+        this->setPrev(demotee, nullptr);
+        this->setNext(demotee, this->ladder_bottom);
+
+        if (nullptr != this->ladder_bottom)
+        { this->setPrev(this->ladder_bottom, demotee); }
+        else
+        { this->ladder_top = demotee; }
+
+        this->ladder_bottom = demotee;
+
         return DemotingStatus::SUCCESS;
     }
 
+    ///
+    /// \brief promote moves the node to the top: both a released node and one that's still on the ladder.
+    ///
     [[nodiscard]]
     auto promote(Node* promotee, ToTop const&) noexcept(true) -> PromotingStatus
     {
-        if ((nullptr == promotee) or (nullptr == this->ladder_top))
+        if (nullptr == promotee)
         { return PromotingStatus::ERROR; }
 
         if (promotee == this->ladder_top)
         { return PromotingStatus::NON_PROMOTABLE; }
 
-        promotee->next_ladder_item = this->ladder_top->next_ladder_item;
-        promotee->prev_ladder_item = this->ladder_top;
+        // Still on the ladder (and not at the top): unlink it first.
+        if (auto const above{ this->next(promotee) };
+            nullptr != above)
+        {
+            auto const below{ this->prev(promotee) };
+            if (nullptr != below)
+            { this->setNext(below, above); }
+            else
+            { this->ladder_bottom = above; }
+
+            this->setPrev(above, below);
+        }
+
+        this->setNext(promotee, nullptr);
+        this->setPrev(promotee, this->ladder_top);
 
-        this->ladder_top->next_ladder_item = promotee;
-        this->ladder_top                   = promotee;
+        if (nullptr != this->ladder_top)
+        { this->setNext(this->ladder_top, promotee); }
+        else
+        { this->ladder_bottom = promotee; }
+
+        this->ladder_top = promotee;
 
         return PromotingStatus::SUCCESS;
     }
 
+    ///
+    /// \brief promote swaps the node w/ the one right above it.
+    ///
     [[nodiscard]]
     auto promote(Node* promotee, OneUp const&) noexcept(true) -> PromotingStatus
     {
         if (nullptr == promotee)
         { return PromotingStatus::ERROR; }
 
-        if (nullptr == promotee->next_ladder_item)
+        auto demotee{ this->next(promotee) };
+        if (nullptr == demotee)
         {
             if (promotee != this->ladder_top)
-            { this->ladder_top = promotee; }
+            { return PromotingStatus::ERROR; } // Not on the ladder.
 
             return PromotingStatus::NON_PROMOTABLE;
         }
 
-        auto demotee{ promotee->next_ladder_item };
+        auto below{ this->prev(promotee) };
+        auto above{ this->next(demotee) };
 
-        promotee->next_ladder_item = demotee->next_ladder_item;
-        demotee->next_ladder_item  = promotee;
+        if (nullptr != below)
+        { this->setNext(below, demotee); }
+        else
+        { this->ladder_bottom = demotee; }
 
-        demotee->prev_ladder_item  = promotee->prev_ladder_item;
-        promotee->prev_ladder_item = demotee;
+        if (nullptr != above)
+        { this->setPrev(above, promotee); }
+        else
+        { this->ladder_top = promotee; }
+
+        this->setPrev(demotee, below);
+        this->setNext(demotee, promotee);
+        this->setPrev(promotee, demotee);
+        this->setNext(promotee, above);
 
         return PromotingStatus::SUCCESS;
     }
 
+private: // Links:
+    auto next(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->next_ladder_item); }
+
+    auto prev(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->prev_ladder_item); }
+
+    auto setNext(Node* node, Node const* next) const noexcept(true) -> void
+    { node->next_ladder_item = this->links.linkOf(next); }
+
+    auto setPrev(Node* node, Node const* prev) const noexcept(true) -> void
+    { node->prev_ladder_item = this->links.linkOf(prev); }
+
 }; // Ladder
 
 } // core
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace core
+{
+
+///
+/// \name core::PointerLinks
+/// \brief The PointerLinks struct is the links' default: a link is the node's address.
+/// \details The links are what core::Ladder, core::Clock and core::FlatLLRBMap keep in their NodeTraits
+/// to get from a node to the next one:
+///  - `Link` is the type stored in the nodes, `NONE` the one that links to nothing;
+///  - `nodeOf(Link) -> Node*` gives the node linked to, null for `NONE`;
+///  - `linkOf(Node const*) -> Link` gives the link to the node, `NONE` for null.
+///
+/// The structures keep a copy of theirs (see core::CompactLinks for the ones w/ a state), the readers
+/// that don't hold the writer's lock go through nodeOf() as well.
+///
+template <typename Node>
+struct PointerLinks
+{
+    using Link = Node*;
+
+    inline static constexpr Link NONE{ nullptr };
+
+    static auto nodeOf(Link const link) noexcept(true) -> Node*
+    { return link; }
+
+    static auto linkOf(Node const* node) noexcept(true) -> Link
+    { return const_cast<Node*>(node); }
+
+}; // PointerLinks
+
+///
+/// \name core::SlotTable
+/// \brief The SlotTable class maps the slots, 32-bit indices of the nodes in an owner's slabs, back to the
+/// nodes.
+/// \details The slots are handed out in blocks of BLOCK_SIZE: a slab's nodes take the slots from the next
+/// free block's first on, so a slot's node is a block's base plus an offset, whatever the number of slabs.
+/// A slab may only be taken back from the end.
+///
+/// Lock-free readers may be mapping slots while the owner adds a slab: the table's copied, and the copies
+/// they may be looking at are only freed by reclaimRetired(), once the owner says no reader's left. Taking
+/// a slab back only cuts the table short, the owner keeps the slab until no reader's left in it.
+///
+template <typename Node>
+class SlotTable
+{
+public: // Types:
+    using Slot = std::uint32_t;
+
+public: // Constants:
+    inline static constexpr Size BLOCK_BITS{ 12 };
+    inline static constexpr Size BLOCK_SIZE{ Size{ 1 } << BLOCK_BITS };
+    inline static constexpr Slot NO_SLOT{ std::numeric_limits<Slot>::max() };
+
+private: // Types:
+    struct Blocks
+    {
+        Size                     number; // Only ever cut short in place: read and written atomically.
+        std::unique_ptr<Node*[]> bases;  // Block i's slots are from i * BLOCK_SIZE on.
+
+        explicit Blocks(Size const number) noexcept(false)
+            : number{ number }
+            , bases{ std::make_unique<Node*[]>(number) }
+        {}
+    };
+
+private: // Fields:
+    std::unique_ptr<Blocks>              blocks{ std::make_unique<Blocks>(0) };
+    Blocks*                              current{ blocks.get() }; // The readers': swapped atomically.
+    std::vector<std::unique_ptr<Blocks>> retired_blocks{};
+
+public: // Methods:
+    ///
+    /// \return The first slot the next slab gets: the end of the last one's blocks.
+    ///
+    [[nodiscard]]
+    auto end() const noexcept(true) -> Size
+    { return (this->blocks->number << BLOCK_BITS); }
+
+    ///
+    /// \brief add gives the `count` nodes from `nodes` on the slots from end() on.
+    /// \return The first slot: the owner numbers its nodes from it on.
+    /// \throws std::length_error if they'd run past the 32-bit slots.
+    ///
+    auto add(Node* nodes, Size const count) noexcept(false) -> Slot
+    {
+        auto const first{ this->end() };
+        if ((NO_SLOT < first) or ((NO_SLOT - first) < count))
+        { throw std::length_error{ "Out of slots!" }; }
+
+        auto const added{ (count + BLOCK_SIZE - 1) >> BLOCK_BITS };
+        auto fresh{ std::make_unique<Blocks>(this->blocks->number + added) };
+        for (Size i{ 0 }; i < this->blocks->number; ++i)
+        { fresh->bases[i] = this->blocks->bases[i]; }
+
+        for (Size i{ 0 }; i < added; ++i)
+        { fresh->bases[this->blocks->number + i] = nodes + (i << BLOCK_BITS); }
+
+        this->publish(std::move(fresh));
+        return static_cast<Slot>(first);
+    }
+
+    ///
+    /// \brief truncate takes the slabs back from the slot `first` on, which has to be one add() returned.
+    ///
+    auto truncate(Size const first) noexcept(true) -> void
+    { __atomic_store_n(&(this->blocks->number), first >> BLOCK_BITS, __ATOMIC_RELAXED); }
+
+    ///
+    /// \return The node in the slot, null for NO_SLOT or one past the slabs. Safe to call w/o the owner's
+    /// lock, see the class' details.
+    ///
+    [[nodiscard]]
+    auto at(Slot const slot) const noexcept(true) -> Node*
+    {
+        // Acquire: a reader that sees a fresh table sees its bases, too.
+        auto const blocks{ __atomic_load_n(&(this->current), __ATOMIC_ACQUIRE) };
+        auto const block{ Size{ slot } >> BLOCK_BITS };
+        if (block >= __atomic_load_n(&(blocks->number), __ATOMIC_RELAXED))
+        { return nullptr; }
+
+        return blocks->bases[block] + (slot & (BLOCK_SIZE - 1));
+    }
+
+    ///
+    /// \brief reclaimRetired frees the tables nobody maps w/ any more, if there are any: after `synchronize()`
+    /// has made sure no reader's left in them (see core::EpochDomain).
+    ///
+    template <typename Synchronize>
+    auto reclaimRetired(Synchronize&& synchronize) noexcept(true) -> void
+    {
+        if (this->retired_blocks.empty())
+        { return; }
+
+        synchronize();
+        this->retired_blocks.clear();
+    }
+
+private:
+    auto publish(std::unique_ptr<Blocks> fresh) noexcept(false) -> void
+    {
+        this->retired_blocks.reserve(this->retired_blocks.size() + 1);
+        __atomic_store_n(&(this->current), fresh.get(), __ATOMIC_RELEASE);
+        this->retired_blocks.push_back(std::move(this->blocks));
+        this->blocks = std::move(fresh);
+    }
+
+}; // SlotTable
+
+///
+/// \name core::CompactLinks
+/// \brief The CompactLinks class is the links as 32-bit slots of a core::SlotTable: half the pointers'
+/// bytes, for a lookup in the table on every step.
+/// \details The Node has to carry its own slot, `slot`, for linkOf(). The links may only point at the nodes
+/// of the table they're made w/.
+///
+template <typename Node>
+class CompactLinks
+{
+public: // Types:
+    using Link = typename SlotTable<Node>::Slot;
+
+public: // Constants:
+    inline static constexpr Link NONE{ SlotTable<Node>::NO_SLOT };
+
+private: // Fields:
+    SlotTable<Node> const* table{};
+
+public: // RAII:
+    CompactLinks() noexcept(true) = default;
+
+    explicit CompactLinks(SlotTable<Node> const* table) noexcept(true)
+        : table{ table }
+    {}
+
+public: // Methods:
+    auto nodeOf(Link const link) const noexcept(true) -> Node*
+    { return this->table->at(link); }
+
+    static auto linkOf(Node const* node) noexcept(true) -> Link
+    { return (nullptr == node) ? NONE : static_cast<Link>(node->slot); }
+
+}; // CompactLinks
+
+} // core
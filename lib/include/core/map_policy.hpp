@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace core
+{
+
+///
+/// \brief The CreateOrUpdateStatus enum is what a map's policy reports once it's seen to a node.
+///
+enum class CreateOrUpdateStatus : std::uint8_t
+{
+    SUCCESS,    // Welp, all's good!
+    ERROR,      // It's possible to live on w/ this kind of error.
+    FATAL_ERROR // Complite FUBAR!
+
+}; // CreateOrUpdateStatus
+
+///
+/// \name core::CallbackPolicy
+/// \brief The CallbackPolicy class is the flat maps' policy that calls back whatever's set at run time.
+/// \details A map's policy is what it asks for the nodes and tells about them:
+///  - `allocate() -> Node*` hands out a node for a new key, null if there's none;
+///  - `onCreate(Node*) -> CreateOrUpdateStatus` is told about a node once it's got its key and value,
+///    before it's linked; a FATAL_ERROR fails the insert;
+///  - `onUpdate(Node*) -> CreateOrUpdateStatus` is told about a node whose value's been replaced.
+///
+/// The policy's a template parameter, so an owner whose wiring is fixed passes its own and the whole
+/// insert path inlines. This one's the adapter for the rest: every call goes through a std::function, and
+/// the unset callbacks are skipped (w/o an allocate one, nothing can be inserted).
+///
+template <typename Node>
+class CallbackPolicy
+{
+public: // Types:
+    using AllocateCallback = std::function<Node* ()>;
+    using AccessCallback   = std::function<CreateOrUpdateStatus (Node*)>;
+
+private: // Fields:
+    AllocateCallback allocate_cb{};
+    AccessCallback   create_cb{};
+    AccessCallback   update_cb{};
+    AccessCallback   use_cb{};
+
+public: // Methods:
+    auto allocate() noexcept(false) -> Node*
+    { return this->allocate_cb ? this->allocate_cb() : nullptr; }
+
+    auto onCreate(Node* node) noexcept(false) -> CreateOrUpdateStatus
+    { return this->create_cb ? this->create_cb(node) : CreateOrUpdateStatus::SUCCESS; }
+
+    auto onUpdate(Node* node) noexcept(false) -> CreateOrUpdateStatus
+    { return this->update_cb ? this->update_cb(node) : CreateOrUpdateStatus::SUCCESS; }
+
+    ///
+    /// \brief onUse is for the owner to call on a hit: the maps' lookups don't write, so they never do.
+    ///
+    auto onUse(Node* node) noexcept(false) -> CreateOrUpdateStatus
+    { return this->use_cb ? this->use_cb(node) : CreateOrUpdateStatus::SUCCESS; }
+
+    auto setAllocateCallback(AllocateCallback allocate_cb) noexcept(true) -> void
+    { this->allocate_cb = std::move(allocate_cb); }
+
+    auto setCreateCallback(AccessCallback create_cb) noexcept(true) -> void
+    { this->create_cb = std::move(create_cb); }
+
+    auto setUpdateCallback(AccessCallback update_cb) noexcept(true) -> void
+    { this->update_cb = std::move(update_cb); }
+
+    auto setUseCallback(AccessCallback use_cb) noexcept(true) -> void
+    { this->use_cb = std::move(use_cb); }
+
+}; // CallbackPolicy
+
+} // core
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+extern "C"
+{
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+} // extern "C"
+
+namespace core
+{
+
+///
+/// \name core::MappedFile
+/// \brief The MappedFile class maps a whole file read-only for as long as it lives.
+/// \details The pages are faulted in on the first touch, so reading the file costs no copy into a buffer.
+/// An empty file maps to an empty span.
+///
+class MappedFile
+{
+private: // Fields:
+    void*      address{ MAP_FAILED };
+    Size       size{};
+
+public: // RAII:
+    ///
+    /// \throws std::system_error if the file can't be opened or mapped.
+    ///
+    explicit MappedFile(std::string const& path) noexcept(false)
+    {
+        auto const fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+        if (0 > fd)
+        { throw std::system_error{ errno, std::generic_category(), path }; }
+
+        struct ::stat status{};
+        if (0 != ::fstat(fd, &status))
+        {
+            auto const error{ errno };
+            ::close(fd);
+            throw std::system_error{ error, std::generic_category(), path };
+        }
+
+        this->size = static_cast<Size>(status.st_size);
+        if (0 != this->size)
+        { this->address = ::mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0); }
+
+        // The mapping outlives the descriptor.
+        auto const error{ errno };
+        ::close(fd);
+
+        if ((0 != this->size) and (MAP_FAILED == this->address))
+        { throw std::system_error{ error, std::generic_category(), path }; }
+    }
+
+    ~MappedFile() noexcept(true)
+    {
+        if (MAP_FAILED != this->address)
+        { ::munmap(this->address, this->size); }
+    }
+
+    MappedFile& operator = (MappedFile const&) = delete;
+    MappedFile& operator = (MappedFile&&)      = delete;
+    MappedFile(MappedFile const&)              = delete;
+    MappedFile(MappedFile&&)                   = delete;
+
+public: // Methods:
+    [[nodiscard]]
+    auto data() const noexcept(true) -> std::byte const*
+    { return (MAP_FAILED != this->address) ? static_cast<std::byte const*>(this->address) : nullptr; }
+
+    [[nodiscard]]
+    auto bytes() const noexcept(true) -> Size
+    { return this->size; }
+
+    ///
+    /// \brief adviseSequential tells the kernel the file's read front to back: it reads ahead more eagerly.
+    ///
+    auto adviseSequential() const noexcept(true) -> void
+    {
+        if (MAP_FAILED != this->address)
+        { (void)::madvise(this->address, this->size, MADV_SEQUENTIAL); }
+    }
+
+}; // MappedFile
+
+} // core
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+extern "C"
+{
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+} // extern "C"
+
+namespace core
+{
+
+inline constexpr Size HUGE_PAGE_SIZE{ 2 * 1024 * 1024 };
+
+///
+/// \brief The HugePages enum is what backs a PageRegion. Each kind falls back on the next one down if it's
+/// not to be had, see PageRegion::hugePages() for what it's come to.
+///
+enum class HugePages : std::uint8_t
+{
+    NONE,        // The base pages.
+    TRANSPARENT, // madvise(MADV_HUGEPAGE): the kernel backs what it can w/ 2MB pages, nothing's reserved.
+    EXPLICIT     // MAP_HUGETLB: the 2MB pages reserved up front (vm.nr_hugepages), all or nothing.
+
+}; // HugePages
+
+///
+/// \brief The NumaPlacement enum is where on a NUMA host a PageRegion's pages go. W/ a single node (or w/o
+/// the mbind() syscall) they all go where the first touch is, whatever it says.
+///
+enum class NumaPlacement : std::uint8_t
+{
+    FIRST_TOUCH, // The node of the thread that touches a page first: the one that constructs the objects.
+    INTERLEAVE,  // Page by page round robin over all the nodes: the same latency on average from any of them.
+    NODE         // PageOptions::numa_node's, preferably: it spills over to the others rather than fail.
+
+}; // NumaPlacement
+
+struct PageOptions
+{
+    HugePages     huge_pages{ HugePages::NONE };
+    NumaPlacement numa{ NumaPlacement::FIRST_TOUCH };
+    Size          numa_node{ 0 }; // W/ NumaPlacement::NODE, modulo numaNodesNumber().
+
+}; // PageOptions
+
+///
+/// \return The number of NUMA nodes the kernel knows of (the highest online one's ID, plus one), 1 if it
+/// can't be told.
+///
+inline auto numaNodesNumber() noexcept(true) -> Size
+{
+    // E.g. "0-1" or "0,2-3": the last number's the highest.
+    std::string online{};
+    std::ifstream file{ "/sys/devices/system/node/online" };
+    std::getline(file, online);
+
+    auto const last{ online.find_last_not_of("0123456789") };
+    auto const digits{ online.substr((std::string::npos == last) ? 0 : (last + 1)) };
+    if (digits.empty() or (4 < digits.size()))
+    { return 1; }
+
+    return static_cast<Size>(std::stoul(digits)) + 1;
+}
+
+///
+/// \name core::PageRegion
+/// \brief The PageRegion class is an anonymous private mapping w/ its pages placed as it's asked to.
+/// \details The pages are only placed (see NumaPlacement) before they're touched first, so whatever's put
+/// in them is put there afterwards. Huge pages (see HugePages) cut the TLB misses of random accesses over
+/// big regions: one entry maps 2MB instead of 4KB.
+///
+class PageRegion
+{
+private: // Fields:
+    void*     address{ MAP_FAILED };
+    Size      size{};
+    HugePages huge_pages{ HugePages::NONE };
+
+public: // RAII:
+    ///
+    /// \throws std::bad_alloc if even the base pages can't be mapped.
+    ///
+    PageRegion(Size const bytes, PageOptions const& options) noexcept(false)
+    {
+        if (0 == bytes)
+        { return; }
+
+        if (HugePages::EXPLICIT == options.huge_pages)
+        { this->mapExplicit(bytes); }
+
+        if (MAP_FAILED == this->address)
+        { this->mapBase(bytes, HugePages::NONE != options.huge_pages); }
+
+        if (MAP_FAILED == this->address)
+        { throw std::bad_alloc{}; }
+
+        this->place(options);
+    }
+
+    ~PageRegion() noexcept(true)
+    {
+        if (MAP_FAILED != this->address)
+        { ::munmap(this->address, this->size); }
+    }
+
+    PageRegion& operator = (PageRegion const&) = delete;
+    PageRegion& operator = (PageRegion&&)      = delete;
+    PageRegion(PageRegion const&)              = delete;
+    PageRegion(PageRegion&&)                   = delete;
+
+public: // Methods:
+    [[nodiscard]]
+    auto data() const noexcept(true) -> void*
+    { return (MAP_FAILED != this->address) ? this->address : nullptr; }
+
+    ///
+    /// \return What the region's got: EXPLICIT only if the reserved pages were there, TRANSPARENT if the
+    /// kernel's taken the advice (it may still back some of the region w/ the base pages).
+    ///
+    [[nodiscard]]
+    auto hugePages() const noexcept(true) -> HugePages
+    { return this->huge_pages; }
+
+private:
+    static auto roundUp(Size const bytes, Size const unit) noexcept(true) -> Size
+    { return ((bytes + unit - 1) / unit) * unit; }
+
+    auto mapExplicit(Size const bytes) noexcept(true) -> void
+    {
+        // The page size's log2 in the flags: <linux/mman.h>'s MAP_HUGE_2MB, which glibc's header lacks.
+        constexpr int MAP_HUGE_2MB_FLAG{ 21 << MAP_HUGE_SHIFT };
+
+        auto const size{ roundUp(bytes, HUGE_PAGE_SIZE) };
+        auto const address{
+            ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB_FLAG, -1, 0)
+        };
+
+        if (MAP_FAILED == address)
+        { return; }
+
+        this->address    = address;
+        this->size       = size;
+        this->huge_pages = HugePages::EXPLICIT;
+    }
+
+    auto mapBase(Size const bytes, bool const transparent) noexcept(true) -> void
+    {
+        if (not transparent)
+        {
+            this->size    = roundUp(bytes, static_cast<Size>(::sysconf(_SC_PAGESIZE)));
+            this->address = ::mmap(nullptr, this->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                                   -1, 0);
+            return;
+        }
+
+        // The kernel only uses a huge page for a whole aligned 2MB: a huge page more is mapped, then the
+        // misaligned ends are cut off.
+        auto const size{ roundUp(bytes, HUGE_PAGE_SIZE) };
+        auto const mapped{
+            ::mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+        };
+
+        if (MAP_FAILED == mapped)
+        { return; }
+
+        auto const begin{ reinterpret_cast<std::uintptr_t>(mapped) };
+        auto const aligned{ roundUp(begin, HUGE_PAGE_SIZE) };
+        if (begin != aligned)
+        { ::munmap(mapped, aligned - begin); }
+
+        if (auto const tail{ (begin + size + HUGE_PAGE_SIZE) - (aligned + size) };
+            0 != tail)
+        { ::munmap(reinterpret_cast<void*>(aligned + size), tail); }
+
+        this->address = reinterpret_cast<void*>(aligned);
+        this->size    = size;
+        if (0 == ::madvise(this->address, this->size, MADV_HUGEPAGE))
+        { this->huge_pages = HugePages::TRANSPARENT; }
+    }
+
+    auto place(PageOptions const& options) const noexcept(true) -> void
+    {
+        // The mask's a word: the hosts w/ more nodes than that get the default placement.
+        constexpr Size MAX_NODES{ 64 };
+
+        auto const nodes_number{ numaNodesNumber() };
+        if ((NumaPlacement::FIRST_TOUCH == options.numa) or (1 == nodes_number) or (MAX_NODES < nodes_number))
+        { return; }
+
+        unsigned long mask{};
+        auto mode{ MPOL_PREFERRED };
+        if (NumaPlacement::INTERLEAVE == options.numa)
+        {
+            mask = (MAX_NODES == nodes_number) ? ~0UL : ((1UL << nodes_number) - 1);
+            mode = MPOL_INTERLEAVE;
+        }
+        else
+        { mask = 1UL << (options.numa_node % nodes_number); }
+
+        // W/o the libnuma dependency. It's only advice: if it fails, the pages go where they're touched.
+        (void)::syscall(SYS_mbind, this->address, this->size, mode, &mask, MAX_NODES + 1, 0);
+    }
+
+}; // PageRegion
+
+///
+/// \name core::PageArray
+/// \brief The PageArray class is `count` value-initialized objects in a PageRegion of their own: what
+/// std::make_unique<T[]>() is, w/ the pages placed.
+///
+template <typename T>
+class PageArray
+{
+    static_assert(alignof(T) <= HUGE_PAGE_SIZE, "The mapping's only aligned to the pages!");
+
+private: // Fields:
+    PageRegion region;
+    Size       count;
+
+public: // RAII:
+    ///
+    /// \throws std::bad_alloc if even the base pages can't be mapped.
+    ///
+    PageArray(Size const count, PageOptions const& options) noexcept(false)
+        : region{ count * sizeof(T), options }
+        , count{ count }
+    {
+        auto const objects{ this->get() };
+        for (Size i{ 0 }; i < this->count; ++i)
+        { new (objects + i) T{}; }
+    }
+
+    ~PageArray() noexcept(true)
+    {
+        auto const objects{ this->get() };
+        for (Size i{ 0 }; i < this->count; ++i)
+        { objects[i].~T(); }
+    }
+
+    PageArray& operator = (PageArray const&) = delete;
+    PageArray& operator = (PageArray&&)      = delete;
+    PageArray(PageArray const&)              = delete;
+    PageArray(PageArray&&)                   = delete;
+
+public: // Methods:
+    [[nodiscard]]
+    auto get() const noexcept(true) -> T*
+    { return static_cast<T*>(this->region.data()); }
+
+    auto operator [] (Size const i) const noexcept(true) -> T&
+    { return this->get()[i]; }
+
+    [[nodiscard]]
+    auto size() const noexcept(true) -> Size
+    { return this->count; }
+
+    [[nodiscard]]
+    auto hugePages() const noexcept(true) -> HugePages
+    { return this->region.hugePages(); }
+
+}; // PageArray
+
+} // core
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace core
+{
+
+///
+/// \brief racyLoad reads a plain field that a concurrent writer may be modifying.
+/// \details Only for word-sized trivially copyable fields (links, raw IPs), so the read can't be torn.
+/// The value is only meaningful once the surrounding SeqLock read section is validated.
+///
+template <typename T>
+inline auto racyLoad(T const& field) noexcept(true) -> T
+{
+    static_assert(std::is_trivially_copyable_v<T> and (sizeof(T) <= sizeof(void*)));
+    return __atomic_load_n(&field, __ATOMIC_RELAXED);
+}
+
+///
+/// \brief racyCopy is racyLoad for the fields that are too big to be read at once.
+/// \details The copy may be torn, so it's only meaningful once the surrounding SeqLock read section is
+/// validated. The signal fences keep the compiler from moving the copy out of the section.
+///
+template <typename T>
+inline auto racyCopy(T const& field) noexcept(true) -> T
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    T copy;
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+    std::memcpy(&copy, &field, sizeof(T));
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+    return copy;
+}
+
+///
+/// \name core::SeqLock
+/// \brief The SeqLock class lets readers run optimistically alongside a (single, externally serialized) writer.
+/// \details The writer makes the sequence odd for the time of a modification. A reader samples the sequence,
+/// reads, and retries if the sequence was odd or has changed meanwhile.
+///
+class SeqLock
+{
+public: // Types:
+    using Sequence = std::uint64_t;
+
+    ///
+    /// \brief The WriteGuard class is a RAII helper for the writer's section.
+    ///
+    class WriteGuard
+    {
+        SeqLock& seq_lock;
+
+    public:
+        explicit WriteGuard(SeqLock& seq_lock) noexcept(true)
+            : seq_lock{ seq_lock }
+        { this->seq_lock.writeBegin(); }
+
+        ~WriteGuard() noexcept(true)
+        { this->seq_lock.writeEnd(); }
+
+        WriteGuard& operator = (WriteGuard const&) = delete;
+        WriteGuard(WriteGuard const&)              = delete;
+
+    }; // WriteGuard
+
+private: // Fields:
+    std::atomic<Sequence> sequence{ 0 };
+
+public: // Methods:
+    [[nodiscard]]
+    auto readBegin() const noexcept(true) -> Sequence
+    { return this->sequence.load(std::memory_order_acquire); }
+
+    [[nodiscard]]
+    static auto isWriting(Sequence const sequence) noexcept(true) -> bool
+    { return (0 != (sequence & 0b1)); }
+
+    ///
+    /// \return true if the read section that started at `sequence` has to be retried.
+    ///
+    [[nodiscard]]
+    auto readRetry(Sequence const sequence) const noexcept(true) -> bool
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (isWriting(sequence) or (sequence != this->sequence.load(std::memory_order_relaxed)));
+    }
+
+    auto writeBegin() noexcept(true) -> void
+    {
+        this->sequence.store(this->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    auto writeEnd() noexcept(true) -> void
+    { this->sequence.store(this->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+}; // SeqLock
+
+} // core
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace core
+{
+
+///
+/// \name core::SlabPool
+/// \brief The SlabPool class hands out fixed-size objects carved from slabs of SLAB_SIZE.
+/// \details It only grows: released objects go to a free list and are handed out again, so once the
+/// pool has reached its working size, allocating and releasing never touch the heap.
+///
+template <typename T, Size SLAB_SIZE = 256>
+class SlabPool
+{
+private: // Fields:
+    std::vector<std::unique_ptr<T[]>> slabs{};
+    std::vector<T*>                   free_list{};
+
+    auto grow() noexcept(false) -> void
+    {
+        this->slabs.push_back(std::make_unique<T[]>(SLAB_SIZE));
+        this->free_list.reserve(this->slabs.size() * SLAB_SIZE);
+
+        auto slab{ this->slabs.back().get() };
+        for (Size i{ SLAB_SIZE }; 0 < i; --i)
+        { this->free_list.push_back(slab + (i - 1)); }
+    }
+
+public: // Methods:
+    [[nodiscard]]
+    auto allocate() noexcept(false) -> T*
+    {
+        if (this->free_list.empty())
+        { this->grow(); }
+
+        auto object{ this->free_list.back() };
+        this->free_list.pop_back();
+        return object;
+    }
+
+    ///
+    /// \brief release takes an object back. Never allocates: the free list is reserved for every object.
+    ///
+    auto release(T* object) noexcept(true) -> void
+    { this->free_list.push_back(object); }
+
+    [[nodiscard]]
+    auto allocatedSize() const noexcept(true) -> Size
+    { return (this->slabs.size() * SLAB_SIZE) - this->free_list.size(); }
+
+}; // SlabPool
+
+} // core
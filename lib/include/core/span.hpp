@@ -0,0 +1,89 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+
+///
+/// \name core::Span
+/// \brief The Span class is a non-owning view over contiguous elements, a stand-in for C++20's std::span.
+///
+template <typename T>
+class Span
+{
+public: // Types:
+    using element_type = T;
+    using value_type   = std::remove_cv_t<T>;
+    using iterator     = T*;
+
+private: // Fields:
+    T*   elements{};
+    Size elements_number{};
+
+public: // RAII:
+    constexpr Span() noexcept(true) = default;
+
+    constexpr Span(T* elements, Size elements_number) noexcept(true)
+        : elements{ elements }
+        , elements_number{ elements_number }
+    {}
+
+    template <Size N>
+    constexpr Span(T (&elements)[N]) noexcept(true)
+        : Span{ elements, N }
+    {}
+
+    template <typename U, Size N, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    constexpr Span(std::array<U, N>& elements) noexcept(true)
+        : Span{ elements.data(), N }
+    {}
+
+    template <typename U, Size N, typename = std::enable_if_t<std::is_convertible_v<U const(*)[], T(*)[]>>>
+    constexpr Span(std::array<U, N> const& elements) noexcept(true)
+        : Span{ elements.data(), N }
+    {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    Span(std::vector<U>& elements) noexcept(true)
+        : Span{ elements.data(), elements.size() }
+    {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U const(*)[], T(*)[]>>>
+    Span(std::vector<U> const& elements) noexcept(true)
+        : Span{ elements.data(), elements.size() }
+    {}
+
+public: // Methods:
+    [[nodiscard]]
+    constexpr auto data() const noexcept(true) -> T*
+    { return this->elements; }
+
+    [[nodiscard]]
+    constexpr auto size() const noexcept(true) -> Size
+    { return this->elements_number; }
+
+    [[nodiscard]]
+    constexpr auto empty() const noexcept(true) -> bool
+    { return (0 == this->elements_number); }
+
+    constexpr auto operator [] (Size const index) const noexcept(true) -> T&
+    { return this->elements[index]; }
+
+    constexpr auto begin() const noexcept(true) -> iterator
+    { return this->elements; }
+
+    constexpr auto end() const noexcept(true) -> iterator
+    { return this->elements + this->elements_number; }
+
+    [[nodiscard]]
+    constexpr auto subspan(Size const offset, Size const count) const noexcept(true) -> Span
+    { return Span{ this->elements + offset, count }; }
+
+}; // Span
+
+} // core
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/types.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace core
+{
+
+///
+/// \name core::StripedCounters
+/// \brief The StripedCounters class is a set of counters that many threads bump and few read.
+/// \details Every counter is split into stripes, each on its own cache lines, and a thread always bumps the
+/// same stripe: the threads are dealt the stripes round robin, so up to STRIPES_NUMBER of them never share
+/// one. A bump is a relaxed add to a line that stays in the thread's core; the stripes are only summed up
+/// when a counter's read.
+///
+template <Size COUNTERS_NUMBER, Size STRIPES_NUMBER = 64>
+class StripedCounters
+{
+private: // Types:
+    struct alignas(CACHE_LINE_SIZE) Stripe
+    {
+        std::array<std::atomic<std::uint64_t>, COUNTERS_NUMBER> values{};
+    };
+
+private: // Fields:
+    std::unique_ptr<Stripe[]> stripes{ std::make_unique<Stripe[]>(STRIPES_NUMBER) };
+
+public: // Methods:
+    auto add(Size const counter, std::uint64_t const value = 1) noexcept(true) -> void
+    { this->stripes[stripeOf()].values[counter].fetch_add(value, std::memory_order_relaxed); }
+
+    ///
+    /// \return The sum of all the stripes: the bumps that race w/ the read may or may not be in it.
+    ///
+    [[nodiscard]]
+    auto sum(Size const counter) const noexcept(true) -> std::uint64_t
+    {
+        std::uint64_t sum{ 0 };
+        for (Size i{ 0 }; i < STRIPES_NUMBER; ++i)
+        { sum += this->stripes[i].values[counter].load(std::memory_order_relaxed); }
+
+        return sum;
+    }
+
+private: // Helpers:
+    static auto stripeOf() noexcept(true) -> Size
+    {
+        static std::atomic<Size> next_stripe{ 0 };
+        thread_local Size const stripe{ next_stripe.fetch_add(1, std::memory_order_relaxed) % STRIPES_NUMBER };
+        return stripe;
+    }
+
+}; // StripedCounters
+
+} // core
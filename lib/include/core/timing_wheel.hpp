@@ -0,0 +1,263 @@
+#pragma once
+
+#include "core/links.hpp"
+#include "core/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace core
+{
+
+///
+/// \name core::TimingWheel
+/// \brief The TimingWheel class is a hierarchical timing wheel over intrusively linked nodes.
+/// \details Every level has 64 slots, each one 64 times as long as the one of the level below: 6 levels
+/// reach 2^36 ticks ahead, timers further away wait at that horizon. A timer sits at the lowest level
+/// whose round covers the time left until it's due, and moves down when the wheel reaches its slot.
+/// Scheduling and cancelling are O(1); advancing costs O(1) per timer and per level it passes through,
+/// while the empty slots are skipped w/ the per-level occupancy masks, so a long idle gap costs nothing.
+/// \tparam Links is what the timers of a slot link each other w/, see core::PointerLinks.
+///
+template <typename Node, typename Links = PointerLinks<Node>>
+class TimingWheel
+{
+public: // Types:
+    using Tick = std::uint64_t;
+
+    class NodeTrait
+    {
+        typename Links::Link next_timer{ Links::NONE };
+        typename Links::Link prev_timer{ Links::NONE };
+        Tick                 timer_tick{};
+        std::uint16_t        timer_slot{ NOT_SCHEDULED };
+
+        friend TimingWheel<Node, Links>;
+    };
+
+private: // Constants:
+    inline static constexpr Size          SLOT_BITS{ 6 };
+    inline static constexpr Size          SLOTS_NUMBER{ Size{ 1 } << SLOT_BITS };
+    inline static constexpr Size          LEVELS_NUMBER{ 6 };
+    inline static constexpr Tick          HORIZON{ (Tick{ 1 } << (SLOT_BITS * LEVELS_NUMBER)) - 1 };
+    inline static constexpr std::uint16_t NOT_SCHEDULED{ std::numeric_limits<std::uint16_t>::max() };
+    inline static constexpr Tick          NO_EVENT{ std::numeric_limits<Tick>::max() };
+
+private: // Fields:
+    Links                                                      links;
+    std::array<std::array<Node*, SLOTS_NUMBER>, LEVELS_NUMBER> slots{};
+    std::array<std::uint64_t, LEVELS_NUMBER>                   occupied{}; // A bit per non-empty slot.
+    Tick                                                        now_tick{};
+    Size                                                        timers_number{};
+
+public: // RAII:
+    explicit TimingWheel(Tick const now, Links links = Links{}) noexcept(true)
+        : links{ links }
+        , now_tick{ now }
+    {}
+
+    TimingWheel& operator = (TimingWheel const&) = delete;
+    TimingWheel(TimingWheel const&)              = delete;
+
+public: // Methods:
+    [[nodiscard]]
+    auto now() const noexcept(true) -> Tick
+    { return this->now_tick; }
+
+    [[nodiscard]]
+    auto size() const noexcept(true) -> Size
+    { return this->timers_number; }
+
+    [[nodiscard]]
+    static auto isScheduled(Node const* node) noexcept(true) -> bool
+    { return (NOT_SCHEDULED != node->timer_slot); }
+
+    ///
+    /// \brief schedule (re)arms the node's timer to fire at `tick`.
+    /// \details A tick that has already passed fires on the next advance.
+    ///
+    auto schedule(Node* node, Tick const tick) noexcept(true) -> void
+    {
+        this->cancel(node);
+        node->timer_tick = std::max(tick, this->now_tick + 1); // The current tick has already fired.
+        this->link(node);
+        ++this->timers_number;
+    }
+
+    auto cancel(Node* node) noexcept(true) -> void
+    {
+        if (not isScheduled(node))
+        { return; }
+
+        this->unlink(node);
+        --this->timers_number;
+    }
+
+    ///
+    /// \brief advance moves the wheel on to `tick`, firing every timer due by then.
+    /// \param expire is called w/ every fired node (already unscheduled), in the due order. It may
+    /// schedule or cancel timers itself.
+    ///
+    template <typename Expire>
+    auto advance(Tick const tick, Expire&& expire) -> void
+    {
+        while (this->now_tick < tick)
+        {
+            auto const next_event{ this->nextEvent() };
+            if (tick < next_event)
+            {
+                this->now_tick = tick;
+                break;
+            }
+
+            this->now_tick = next_event;
+            this->cascade();
+            this->fire(expire);
+        }
+    }
+
+private: // Helpers:
+    static auto levelShift(Size const level) noexcept(true) -> Size
+    { return (level * SLOT_BITS); }
+
+    static auto slotOf(Tick const tick, Size const level) noexcept(true) -> Size
+    { return ((tick >> levelShift(level)) & (SLOTS_NUMBER - 1)); }
+
+    static auto highestBit(std::uint64_t const bits) noexcept(true) -> Size
+    { return static_cast<Size>(63 - __builtin_clzll(bits)); }
+
+    static auto lowestBit(std::uint64_t const bits) noexcept(true) -> Size
+    { return static_cast<Size>(__builtin_ctzll(bits)); }
+
+    auto link(Node* node) noexcept(true) -> void
+    {
+        auto const delay{ std::min(node->timer_tick - this->now_tick, HORIZON) };
+        auto const level{ (0 == delay) ? 0 : (highestBit(delay) / SLOT_BITS) };
+        auto const slot{ slotOf(this->now_tick + delay, level) };
+
+        auto& head{ this->slots[level][slot] };
+        this->setPrev(node, nullptr);
+        this->setNext(node, head);
+        if (nullptr != head)
+        { this->setPrev(head, node); }
+
+        head             = node;
+        node->timer_slot = static_cast<std::uint16_t>((level * SLOTS_NUMBER) + slot);
+        this->occupied[level] |= (std::uint64_t{ 1 } << slot);
+    }
+
+    auto unlink(Node* node) noexcept(true) -> void
+    {
+        auto const level{ node->timer_slot / SLOTS_NUMBER };
+        auto const slot{ node->timer_slot % SLOTS_NUMBER };
+
+        auto const prev{ this->prev(node) };
+        auto const next{ this->next(node) };
+        if (nullptr != prev)
+        { this->setNext(prev, next); }
+        else
+        { this->slots[level][slot] = next; }
+
+        if (nullptr != next)
+        { this->setPrev(next, prev); }
+
+        if (nullptr == this->slots[level][slot])
+        { this->occupied[level] &= ~(std::uint64_t{ 1 } << slot); }
+
+        this->setNext(node, nullptr);
+        this->setPrev(node, nullptr);
+        node->timer_slot = NOT_SCHEDULED;
+    }
+
+    ///
+    /// \return The tick at which the earliest non-empty slot is due, NO_EVENT if there's none.
+    /// \details The slots up to the current one (inclusive) have been handled in this round of their
+    /// level, so they're due in the next one.
+    ///
+    auto nextEvent() const noexcept(true) -> Tick
+    {
+        auto next_event{ NO_EVENT };
+        for (Size level{ 0 }; level < LEVELS_NUMBER; ++level)
+        {
+            auto const occupied{ this->occupied[level] };
+            if (0 == occupied)
+            { continue; }
+
+            auto const current_slot{ slotOf(this->now_tick, level) };
+            auto const ahead{
+                (SLOTS_NUMBER - 1 == current_slot) ? 0 : (occupied & (~std::uint64_t{ 0 } << (current_slot + 1)))
+            };
+
+            auto const round_shift{ levelShift(level + 1) };
+            auto round_start{ (this->now_tick >> round_shift) << round_shift };
+            if (0 == ahead)
+            { round_start += (Tick{ 1 } << round_shift); }
+
+            auto const slot{ lowestBit((0 != ahead) ? ahead : occupied) };
+            next_event = std::min(next_event, round_start + (Tick{ slot } << levelShift(level)));
+        }
+
+        return next_event;
+    }
+
+    ///
+    /// \brief cascade moves the timers of the upper levels' slots that have just come due one level down
+    /// (or lower). From the top, so a timer can pass several levels at once.
+    ///
+    auto cascade() noexcept(true) -> void
+    {
+        for (auto level{ LEVELS_NUMBER - 1 }; 0 < level; --level)
+        {
+            auto const low_bits{ (Tick{ 1 } << levelShift(level)) - 1 };
+            if (0 != (this->now_tick & low_bits))
+            { continue; }
+
+            auto& head{ this->slots[level][slotOf(this->now_tick, level)] };
+            while (nullptr != head)
+            {
+                auto node{ head };
+                this->unlink(node);
+                this->link(node);
+            }
+        }
+    }
+
+    template <typename Expire>
+    auto fire(Expire& expire) -> void
+    {
+        auto& head{ this->slots[0][slotOf(this->now_tick, 0)] };
+        while (nullptr != head)
+        {
+            auto node{ head };
+            this->unlink(node);
+
+            // Only the timers that were beyond the horizon are early: they wait at the horizon again.
+            if (this->now_tick < node->timer_tick)
+            {
+                this->link(node);
+                continue;
+            }
+
+            --this->timers_number;
+            expire(node);
+        }
+    }
+
+private: // Links:
+    auto next(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->next_timer); }
+
+    auto prev(Node const* node) const noexcept(true) -> Node*
+    { return this->links.nodeOf(node->prev_timer); }
+
+    auto setNext(Node* node, Node const* next) const noexcept(true) -> void
+    { node->next_timer = this->links.linkOf(next); }
+
+    auto setPrev(Node* node, Node const* prev) const noexcept(true) -> void
+    { node->prev_timer = this->links.linkOf(prev); }
+
+}; // TimingWheel
+
+} // core
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace core
@@ -8,4 +9,19 @@ namespace core
 using Capacity = std::size_t;
 using Size     = std::size_t;
 
+// Not std::hardware_destructive_interference_size: it's ABI-unstable and GCC warns on any use.
+inline constexpr std::size_t CACHE_LINE_SIZE{ 64 };
+
+///
+/// \brief prefetch asks for the cache line at `address` to be loaded for reading. Only a hint: it never faults.
+///
+inline auto prefetch(void const* address) noexcept(true) -> void
+{ __builtin_prefetch(address, 0, 3); }
+
+///
+/// \brief prefetchForWrite asks for the cache line at `address` to be loaded for writing.
+///
+inline auto prefetchForWrite(void* address) noexcept(true) -> void
+{ __builtin_prefetch(address, 1, 3); }
+
 } // core
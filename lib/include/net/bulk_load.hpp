@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/types.hpp"
+#include "net/types.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+///
+/// \brief The parsing half of DNSCache::bulkLoad(): hosts files and zone dumps, a piece at a time.
+/// \details Two kinds of lines are understood, and they may be mixed:
+///  - hosts lines: an IPv4 or IPv6 address, then the names it's for (`10.0.0.1 host.domain host`);
+///  - zone records: `name [ttl] [class] type address`, of the types A and AAAA only; the TTL (in seconds)
+///    and the class may come in either order, the name's trailing dot is dropped.
+///
+/// Everything after a `#` is a comment. Lines of other record types, the `$` directives, malformed lines
+/// and names longer than MAX_FQDN_LENGTH are skipped.
+///
+namespace net::bulk_load
+{
+
+inline constexpr std::int64_t DEFAULT_TTL{ -1 };
+
+///
+/// \brief The Record struct is a name's A or AAAA record as it's parsed, the name's left in the text.
+///
+struct Record
+{
+    std::uint64_t name_offset; // In the whole text: the records of a text are in its order by it.
+    std::int64_t  ttl_ms;      // The zone record's, or DEFAULT_TTL.
+    IPV6Raw       address;     // An IPv4 one in the first 4 bytes.
+    std::uint8_t  name_length;
+    bool          ipv6;
+
+    [[nodiscard]]
+    auto ipv4() const noexcept(true) -> IPV4Raw;
+
+}; // Record
+
+[[nodiscard]]
+inline auto nameOf(std::string_view const text, Record const& record) noexcept(true) -> std::string_view
+{ return text.substr(record.name_offset, record.name_length); }
+
+///
+/// \brief splitLines cuts `text` into at most `parts` pieces of about the same size, each of whole lines.
+///
+[[nodiscard]]
+auto splitLines(std::string_view text, core::Size parts) noexcept(false) -> std::vector<std::string_view>;
+
+///
+/// \brief parseLines appends the records of the `lines`, a piece of the `text`, to `records`.
+///
+auto parseLines(std::string_view text, std::string_view lines, std::vector<Record>& records) noexcept(false)
+    -> void;
+
+} // net::bulk_load
@@ -1,43 +1,486 @@
 #pragma once
 
+#include "core/page_array.hpp"
+#include "core/span.hpp"
 #include "core/types.hpp"
+#include "net/record_set.hpp"
 #include "net/types.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iosfwd>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace net
 {
 
+///
+/// \name net::DNSCache
+/// \brief The DNSCache class keeps the names' A and AAAA records, and their negative answers, in shards.
+/// \details Every shard has a lock, which may fail to be taken w/ a std::system_error. The readers (lookup(),
+/// lookupWildcard(), resolve(), resolveRaw(), find(), resolveAll() and resolveBatch()) only take it when the
+/// writers keep interfering w/ their lock-free reads: they miss then, as a cache may, and never throw for it.
+/// What's summed up over all the shards (size(), maxSize(), hugePages(), footprint()) has nothing to fall
+/// back to, so it throws, like the writers.
+///
 class DNSCache
 {
+public:
+    ///
+    /// \brief The Admission enum decides whether a new name may push an older one out.
+    ///
+    enum class Admission : std::uint8_t
+    {
+        ALWAYS,   // Every new name is cached, the least recently used one is evicted for it.
+        TINY_LFU  // A new name displaces an entry only if it's been seen more often (W-TinyLFU).
+    };
+
+    ///
+    /// \brief The Outcome enum tells the kinds of lookup() results apart.
+    ///
+    enum class Outcome : std::uint8_t
+    {
+        HIT,          // The name's records are cached.
+        NEGATIVE_HIT, // The name's known not to exist, or not to have any A or AAAA records.
+        MISS          // Nothing's known: ask upstream.
+    };
+
+    ///
+    /// \brief The Lookup struct is the result of lookup().
+    ///
+    struct Lookup
+    {
+        Outcome                outcome{ Outcome::MISS };
+        Negative               negative{ Negative::NONE }; // What the negative answer was, on a NEGATIVE_HIT.
+        std::optional<IPV4Raw> ipv4{};                     // The first A record on a HIT, if there's one.
+    };
+
+    ///
+    /// \brief The Stats struct is a snapshot of the cache's counters, see stats().
+    ///
+    struct Stats
+    {
+        std::uint64_t            hits{};
+        std::uint64_t            l1_hits{};           // Of the hits, those from the threads' L1s.
+        std::uint64_t            negative_hits{};
+        std::uint64_t            misses{};            // Expired entries and too long names included.
+        std::uint64_t            inserts{};           // New names cached.
+        std::uint64_t            updates{};           // Cached names' records replaced.
+        std::uint64_t            evictions{};         // Live entries pushed out by the replacement policy.
+        std::uint64_t            expirations{};       // Expired entries reclaimed.
+        std::uint64_t            promotions_to_top{}; // New entries, and the ones admitted past the window.
+        std::uint64_t            promotions_one_up{}; // Updated entries.
+        std::uint64_t            lock_contentions{};  // Times a shard's lock was found taken.
+        std::chrono::nanoseconds lock_wait{};         // Spent waiting for the shards' locks then.
+    };
+
+    ///
+    /// \brief The Footprint struct is the memory the entries take, see footprint().
+    ///
+    struct Footprint
+    {
+        core::Size node_bytes{}; // A node's: the inline name, the records' block, the links and the rest.
+        core::Size link_bytes{}; // Of those, the replacement policy's, the expiry wheel's and the ordered index'.
+        core::Size nodes{};      // All the shards', the negative, the parked and the retiring ones included.
+        core::Size bytes{};      // The nodes' and the hashed index' tables: the overflow records left out.
+    };
+
+    ///
+    /// \brief The BulkPriority callable ranks a name for bulkLoad(): the higher, the later it's evicted.
+    ///
+    using BulkPriority = std::function<std::uint64_t(std::string_view fqdn)>;
+
+    ///
+    /// \brief The Answer struct is what the upstream resolver has to say about a name.
+    ///
+    struct Answer
+    {
+        std::vector<IPV4Raw> ipv4s{};
+        std::vector<IPV6Raw> ipv6s{};
+        TTL                  ttl{ NO_TTL };
+        Negative             negative{ Negative::NONE }; // W/o the records, and `ttl` is the SOA's minimum then.
+    };
+
+    ///
+    /// \brief The Upstream callable asks the real resolvers about a name, see resolveOrFetch(). It may block,
+    /// and it may throw: the exception is what the waiting callers get.
+    ///
+    using Upstream = std::function<Answer(FQDN const& fqdn)>;
+
+    ///
+    /// \brief The FetchCallback callable is handed the ready result of resolveOrFetch().
+    /// \details What it throws is dropped: it would otherwise keep the other waiters from their callbacks, and
+    /// escape the call of whoever happened to do the fetch.
+    ///
+    using FetchCallback = std::function<void(std::shared_future<Lookup> const& result)>;
+
 private:
+    template <template <typename, typename> class Replacement>
+    class BasicDNSCacheImpl;
     class DNSCacheImpl;
+    class StatsCounters;
+    struct Fetch;
+    struct L1;
+
+    ///
+    /// \brief The Shard struct is an independent slice of the cache w/ its own lock.
+    /// \details Aligned to the cache line, so neighbouring shards' locks don't false-share. The fetches in
+    /// flight have a lock of their own: the upstream's answers aren't waited for w/ the cache locked.
+    ///
+    struct alignas(core::CACHE_LINE_SIZE) Shard
+    {
+        mutable std::mutex            mutex;
+        std::unique_ptr<DNSCacheImpl> impl;
+
+        std::mutex                                        fetches_mutex;
+        std::unordered_map<FQDN, std::shared_ptr<Fetch>> fetches;
+    };
 
 private:
-    std::mutex                    mutex;
-    std::unique_ptr<DNSCacheImpl> impl;
+    core::Size                     shards_number{};
+    std::unique_ptr<StatsCounters> counters; // Null w/o DNS_CACHE_STATS.
+    std::unique_ptr<Shard[]>       shards;
+    Upstream                       upstream{};
+    std::uint64_t                  id;                 // Never reused, unlike the address: see enableL1().
+    bool                           l1_enabled{ false };
 
-public:
+    auto lockShard(Shard const& shard) const noexcept(false) -> std::unique_lock<std::mutex>;
+
+    ///
+    /// \return The readers' lock of the shard, see the class' details: not owned if it couldn't be taken.
+    ///
+    auto lockShardToRead(Shard const& shard) const noexcept(true) -> std::unique_lock<std::mutex>;
+    auto shardIndexOf(std::string_view fqdn) const noexcept(true) -> core::Size;
+    auto shardOf(std::string_view fqdn) const noexcept(true) -> Shard&;
 
-    explicit DNSCache(core::Capacity capacity = 0);
+    auto resolveRecords(Shard& shard, std::string_view fqdn) const noexcept(true) -> std::optional<RecordBlock>;
+    auto resolveRawL1(std::string_view fqdn, L1& l1) noexcept(true) -> std::optional<IPV4Raw>;
+
+    ///
+    /// \return The calling thread's L1 for the owner, emptied if it's been another cache's; null if it couldn't
+    /// be allocated.
+    ///
+    static auto l1Of(std::uint64_t owner) noexcept(true) -> L1*;
+    auto fetch(FQDN const& fqdn, FetchCallback callback) noexcept(false) -> std::shared_future<Lookup>;
+    static auto lookupOf(std::optional<RecordBlock> const& records) noexcept(true) -> Lookup;
+    auto bulkLoadText(std::string_view text, TTL ttl, BulkPriority const& priority) noexcept(false)
+        -> core::Size;
+
+public:
+    ///
+    /// \param capacity is the total capacity, it's split evenly between the shards.
+    /// \param shards is the number of independent shards: keys are spread by the FQDN hash.
+    /// \param admission is the policy for the new names; TINY_LFU keeps the hot entries through scans.
+    /// \param negative_capacity is the budget of the negative entries, split between the shards like
+    /// `capacity`: they're evicted only by each other, so a flood of names that don't exist can't push the
+    /// cached records out. 0 doesn't cache the negative answers at all.
+    /// \param pages is what backs the shards' nodes: at tens of millions of entries, huge pages spare the
+    /// resolves most of their TLB misses. W/ NumaPlacement::NODE the shards are spread over the nodes round
+    /// robin, from `pages.numa_node` on, which only pays if the threads serving a shard run on its node. What
+    /// isn't to be had falls back, see hugePages().
+    /// \throws std::logic_error if a shard would get less than minViableCapacity() slots (twice that w/
+    /// TINY_LFU, for the window), or some but less than that of the negative ones.
+    ///
+    explicit DNSCache(
+        core::Capacity           capacity          = 0,
+        core::Size               shards            = 1,
+        Admission                admission         = Admission::ALWAYS,
+        core::Capacity           negative_capacity = 0,
+        core::PageOptions const& pages             = core::PageOptions{}
+    );
 
     ~DNSCache() noexcept(true); // = default
 
     static auto minViableCapacity() noexcept(true) -> core::Capacity; // unfortunately can't be constexpr
-    auto size() const noexcept(true) -> core::Size;
-    auto maxSize() noexcept(true) -> core::Capacity;
+
+    ///
+    /// \return The number of cached names, the negative ones and the expired ones that haven't been reclaimed
+    /// yet included.
+    /// \throws std::system_error if a shard's lock can't be taken.
+    ///
+    auto size() const noexcept(false) -> core::Size;
+
+    ///
+    /// \return The capacity, the negative budget left out: the constructor's, or the last resize()'s once it's
+    /// done.
+    /// \throws std::system_error if a shard's lock can't be taken: it's taken as resize() may be changing it.
+    ///
+    auto maxSize() noexcept(false) -> core::Capacity;
+    auto shardsNumber() const noexcept(true) -> core::Size;
+
+    ///
+    /// \brief resize changes the capacity given to the constructor while the cache's in use: what's cached stays,
+    /// as much as fits. It's split between the shards as the constructor splits it, and a shard's resized at a
+    /// time. Not to be called concurrently w/ itself.
+    /// \details A shard grows at the bottom of its queue, so the new nodes are the next ones used. It takes the
+    /// nodes it parked on shrinking first, then a new slab of them. It shrinks by evicting from the bottom and
+    /// parking the nodes. A grown slab's handed back once there are enough nodes parked elsewhere: its entries
+    /// move to them. The hashed index grows into a bigger table, which the later writes fill a few groups at a
+    /// time while the lookups check both tables. A shard's locked for up to 65536 nodes at a time, and the
+    /// lock's let go in between. The lock-free readers only wait while the index grows and while the entries
+    /// are evicted or moved; the L1 entries of the shards resized go stale. The admission window, its
+    /// frequency sketch and the negative budget stay as they are.
+    /// \throws std::logic_error if a shard would get less than the constructor allows, before anything's
+    /// resized; std::bad_alloc if a slab or an index table can't be allocated.
+    ///
+    auto resize(core::Capacity capacity) noexcept(false) -> void;
+
+    ///
+    /// \return What the shards' nodes have actually got, the least of them: the huge pages asked for in the
+    /// constructor may not have been there.
+    /// \throws std::system_error if a shard's lock can't be taken: it's taken as resize() may be adding a chunk.
+    ///
+    [[nodiscard]]
+    auto hugePages() const noexcept(false) -> core::HugePages;
+
+    ///
+    /// \return What the shards' entries take. The links are 32-bit slots instead of pointers if the library's
+    /// been built w/ DNS_CACHE_COMPACT_LINKS: half the bytes, for a table lookup on every step. The inline
+    /// name's MAX_FQDN_LENGTH bytes are most of a node either way.
+    /// \throws std::system_error if a shard's lock can't be taken: it's taken as resize() may be adding a chunk.
+    ///
+    [[nodiscard]]
+    auto footprint() const noexcept(false) -> Footprint;
+
+    ///
+    /// \return The counters summed up over the shards and threads now. All zeros if the library's been
+    /// built w/o DNS_CACHE_STATS, see statsEnabled().
+    /// \details The counters are bumped concurrently, so they're only consistent w/ each other once the
+    /// cache's quiet.
+    ///
+    [[nodiscard]]
+    auto stats() const noexcept(true) -> Stats;
+
+    static auto statsEnabled() noexcept(true) -> bool;
+
+    ///
+    /// \brief saveSnapshot writes the cached names w/ their records, what's left of their TTLs and their
+    /// eviction order to `path`, for loadSnapshot() to warm a restarted cache up w/.
+    /// \details A shard's locked only while its entries are copied out, the file's written after. The
+    /// expired entries are left out. The format's described in net/snapshot.hpp.
+    /// \throws std::runtime_error if the file can't be written.
+    ///
+    auto saveSnapshot(std::string const& path) const noexcept(false) -> void;
+
+    ///
+    /// \brief loadSnapshot fills the empty cache w/ a snapshot saveSnapshot() has written.
+    /// \details The file's mapped and read in place, there's nothing to parse. If the cache's sharded as the
+    /// saved one was, every shard reads its own run of entries, which come in its index' order; otherwise
+    /// the entries are dealt to the shards and sorted first. The TTLs go on from where they were, less the
+    /// snapshot's age, and what's expired meanwhile is left out; so are the coldest entries, if a shard's
+    /// smaller than it was. Everything goes into the main queue, the admission window starts empty. The
+    /// shards are restored in parallel, up to a thread per core.
+    /// \return The number of entries restored.
+    /// \throws std::logic_error if the cache isn't empty, std::system_error if the file can't be mapped, or
+    /// std::runtime_error if it isn't a sound snapshot. Either before anything's restored.
+    ///
+    auto loadSnapshot(std::string const& path) noexcept(false) -> core::Size;
+
+    ///
+    /// \brief bulkLoad fills the empty cache w/ the A and AAAA records of a hosts file or a zone dump, see
+    /// net/bulk_load.hpp for what's understood.
+    /// \details The file's mapped and cut into pieces of whole lines, which the threads (up to one per core)
+    /// parse at once, dealing the records to the shards. Then every shard's built in one pass, in parallel
+    /// again: a name's records are gathered from all its lines, the nodes are filled in the index' order and
+    /// the index is built from them at once. The names are stacked in the eviction order in the order of
+    /// their last lines (as updating the cache line by line would have), or by `priority` if it's given:
+    /// the lowest goes first, the ties in the file's order. If a shard can't hold all its names, the ones
+    /// that would be evicted first are left out.
+    /// \param ttl is the hosts lines' TTL; a zone record's is its own. A name's is the shortest of its records'.
+    /// \param priority is called concurrently, from the loading threads.
+    /// \return The number of names cached.
+    /// \throws std::logic_error if the cache isn't empty, std::system_error if the file can't be mapped.
+    ///
+    auto bulkLoad(std::string const& path, TTL ttl = NO_TTL, BulkPriority const& priority = {}) noexcept(false)
+        -> core::Size;
+
+    ///
+    /// \brief bulkLoad reads the whole `input` first, then it's the same as the file's overload.
+    /// \throws std::runtime_error if the stream fails w/ anything but the end of it.
+    ///
+    auto bulkLoad(std::istream& input, TTL ttl = NO_TTL, BulkPriority const& priority = {}) noexcept(false)
+        -> core::Size;
 
     DNSCache& operator = (DNSCache const&) = delete;
     DNSCache& operator = (DNSCache&&)      = delete;
     DNSCache(DNSCache const&)              = delete;
     DNSCache(DNSCache&&)                   = delete;
 
-    auto update(FQDN const& fqdn, IP const& ip) noexcept(false) -> void;
+    ///
+    /// \brief update parses the textual `ip`, then it's the same as the raw overload.
+    /// \throws std::length_error if `fqdn` is longer than MAX_FQDN_LENGTH.
+    ///
+    auto update(FQDN const& fqdn, IP const& ip, TTL ttl = NO_TTL) noexcept(false) -> void;
+
+    ///
+    /// \brief update makes `raw_ip` the only record of the name.
+    /// \throws std::length_error if `fqdn` is longer than MAX_FQDN_LENGTH.
+    ///
+    auto update(FQDN const& fqdn, IPV4Raw raw_ip, TTL ttl = NO_TTL) noexcept(false) -> void;
+
+    ///
+    /// \brief update replaces the name's A and AAAA record sets.
+    /// \details A few records of each kind are stored inline in the node, the rest in pooled chunks.
+    /// Once `ttl` is over, the name resolves as a miss; a zero `ttl` doesn't cache at all.
+    /// \throws std::length_error if `fqdn` is longer than MAX_FQDN_LENGTH or there are over 65535 records
+    /// of a kind.
+    ///
+    auto update(
+        FQDN const&               fqdn,
+        core::Span<IPV4Raw const> ipv4s,
+        core::Span<IPV6Raw const> ipv6s,
+        TTL                       ttl = NO_TTL
+    ) noexcept(false) -> void;
+
+    ///
+    /// \brief updateNegative caches a negative answer for the name, in place of whatever's cached for it.
+    /// \details A negative entry takes a node of the negative budget and holds nothing but what the answer
+    /// was. It's a no-op w/o a negative budget.
+    /// \param ttl is the SOA's minimum, as RFC 2308 has it; it's cut down to MAX_NEGATIVE_TTL.
+    /// \throws std::length_error if `fqdn` is longer than MAX_FQDN_LENGTH, std::logic_error if `negative` is
+    /// NONE.
+    ///
+    auto updateNegative(FQDN const& fqdn, Negative negative, TTL ttl) noexcept(false) -> void;
 
+    ///
+    /// \brief updateBatch makes `ipv4s[i]` the only record of `fqdns[i]`, all w/ the same `ttl`.
+    /// \details A shard's lock is taken once for all its names in a batch of up to 64, and their lookups are
+    /// interleaved: meant for the answers of a whole recvmmsg() worth of queries.
+    /// \throws std::logic_error if the spans' sizes differ, std::length_error if a name is longer than
+    /// MAX_FQDN_LENGTH. Either before anything's updated.
+    ///
+    auto updateBatch(
+        core::Span<FQDN const>    fqdns,
+        core::Span<IPV4Raw const> ipv4s,
+        TTL                       ttl = NO_TTL
+    ) noexcept(false) -> void;
+
+    ///
+    /// \return The textual IP, or an empty string on a miss.
+    ///
     [[nodiscard]]
     auto resolve(FQDN const& fqdn) noexcept(true) -> IP;
+
+    ///
+    /// \return Whether the name's records are cached, a negative answer for it is, or neither; the first A
+    /// record on a hit. The other resolves take a negative hit for a miss.
+    ///
+    [[nodiscard]]
+    auto lookup(FQDN const& fqdn) noexcept(true) -> Lookup;
+
+    ///
+    /// \brief lookupWildcard is lookup() that falls back on the wildcards (RFC 4592) on a miss: on
+    /// `*.b.example.com` for `a.b.example.com`, then on `*.example.com` and `*.com`. The first cached one's
+    /// answer is the name's, negative or not.
+    /// \details A wildcard's cached as any other name, e.g. by a zone dump's `*.example.com` record. The
+    /// candidates are looked up as views of a buffer on the stack: nothing's allocated, and each one's a
+    /// lookup (and a miss in the stats, if it is one). The existing names under a wildcard's domain don't
+    /// block it: the cache can't know all the names that exist.
+    ///
+    [[nodiscard]]
+    auto lookupWildcard(std::string_view fqdn) noexcept(true) -> Lookup;
+
+    ///
+    /// \return The (first) IP as it's stored (network byte order), w/o the text conversion.
+    ///
+    [[nodiscard]]
+    auto resolveRaw(FQDN const& fqdn) noexcept(true) -> std::optional<IPV4Raw>;
+
+    ///
+    /// \brief find is resolveRaw for a name that isn't a std::string, e.g. one still in a request's buffer.
+    /// \details Neither a hit nor a miss allocates or throws, the lookup under the lock included (if the
+    /// writers keep interfering): no key's made of the name, it's compared as it is. A name longer than
+    /// MAX_FQDN_LENGTH is just a miss.
+    /// \return The (first) IP as it's stored (network byte order), nullopt on a miss or a negative hit.
+    ///
+    [[nodiscard]]
+    auto find(std::string_view fqdn) noexcept(true) -> std::optional<IPV4Raw>;
+
+    ///
+    /// \brief enableL1 puts a thread-local L1 in front of resolveRaw() and resolve(), or takes it away. Not to
+    /// be called while there are resolves running.
+    /// \details Every thread gets a small direct-mapped table of the names it's resolved, for each of the last
+    /// 4 caches it's used (64 KiB apiece): a hit there is a hash, a compare of the name and of its shard's
+    /// generation, w/o the lookup and w/o any shared writes. An entry's only good while its shard's generation
+    /// is the one it was looked up at, and every write to the shard (an update, an eviction, an expiry) changes
+    /// that: a stale record is never returned, but w/ a high update rate the L1 hardly hits. The L1 hits don't
+    /// count towards the replacement policy either; the first resolve after a write does. Names that don't fit
+    /// in a cache line along w/ the record aren't kept in the L1.
+    ///
+    auto enableL1(bool enabled = true) noexcept(true) -> void;
+
+    ///
+    /// \brief enableSuffixIndex keeps every shard's names in the label-reversed order as well (`com.example.a`
+    /// for `a.example.com`), or stops: then a domain's names are all together, for invalidateSuffix().
+    /// \details The names cached by then are indexed right away. It's another ordered index, updated along
+    /// w/ the dictionary under the shards' locks: a new name costs an insert into it and an evicted one an
+    /// erase, and every slot's got a node of it: a view of the name and the tree's links. The readers never
+    /// touch it.
+    ///
+    auto enableSuffixIndex(bool enabled = true) noexcept(false) -> void;
+
+    ///
+    /// \brief invalidateSuffix drops the entries of `domain` and of all the names under it, e.g. when the
+    /// upstream zone's changed: `example.com` drops `example.com` and `a.b.example.com`, but not
+    /// `notexample.com`. The negative entries are dropped too; the trailing dot is optional, and `.` (or
+    /// nothing) is the root, under which everything is.
+    /// \details A shard at a time, under its lock. W/ the suffix index, a shard's names are found together:
+    /// the time's proportional to how many there are (an erase each), not to the shard's size; w/o it,
+    /// every entry's checked.
+    /// \return The number of entries dropped.
+    ///
+    auto invalidateSuffix(std::string_view domain) noexcept(false) -> core::Size;
+
+    ///
+    /// \brief resolveBatch is resolveRaw for many names: `ipv4s[i]` gets the result for `fqdns[i]`.
+    /// \details The names of a shard are looked up together w/ their tree walks (or probes) interleaved and
+    /// prefetched, so the cache misses of the batch overlap rather than add up. The lock is taken at most
+    /// once per shard and batch of up to 64, only if the writers keep interfering w/ the lock-free reads.
+    /// \throws std::logic_error if the spans' sizes differ.
+    ///
+    auto resolveBatch(
+        core::Span<FQDN const>             fqdns,
+        core::Span<std::optional<IPV4Raw>> ipv4s
+    ) noexcept(false) -> void;
+
+    ///
+    /// \return All the A and AAAA records of the name: one lookup, no allocations. See RecordSetView for
+    /// how long the view may be held.
+    ///
+    [[nodiscard]]
+    auto resolveAll(FQDN const& fqdn) noexcept(true) -> std::optional<RecordSetView>;
+
+    ///
+    /// \brief setUpstream sets the resolver resolveOrFetch() asks on a miss. Not to be called while there are
+    /// fetches in flight.
+    ///
+    auto setUpstream(Upstream upstream) noexcept(true) -> void;
+
+    ///
+    /// \brief resolveOrFetch is lookup(), but a miss is fetched from the upstream and cached.
+    /// \details The concurrent misses of a name are coalesced (single-flight): the first caller asks the
+    /// upstream, in its own thread, and the others wait on its answer rather than ask again. The answer is
+    /// cached as update() or updateNegative() would; it's the result even if it isn't cached, e.g. for a TTL
+    /// of 0, or a negative answer w/o a negative budget.
+    /// \return The result: ready, unless another caller's fetch of the name is still in flight.
+    /// \throws std::logic_error w/o an upstream, std::length_error if `fqdn` is longer than MAX_FQDN_LENGTH.
+    ///
+    [[nodiscard]]
+    auto resolveOrFetch(FQDN const& fqdn) noexcept(false) -> std::shared_future<Lookup>;
+
+    ///
+    /// \brief resolveOrFetch w/ a callback: it's called w/ the ready result, by this thread, or by the one
+    /// whose fetch this call waits on. The call doesn't wait then.
+    ///
+    auto resolveOrFetch(FQDN const& fqdn, FetchCallback callback) noexcept(false) -> void;
     
 }; // DNSCache
 
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core/epoch.hpp"
+#include "core/types.hpp"
+#include "net/types.hpp"
+
+#include <array>
+#include <utility>
+
+namespace net
+{
+
+///
+/// \brief The RecordChunk struct holds the records that don't fit a RecordBlock.
+/// \details Chunks come from the shard's pool and are immutable once published: replacing a record set
+/// retires the whole chain, which goes back to the pool after a grace period.
+///
+struct RecordChunk
+{
+    inline static constexpr core::Size IPV4_RECORDS{ 8 };
+    inline static constexpr core::Size IPV6_RECORDS{ 4 };
+
+    std::array<IPV4Raw, IPV4_RECORDS> ipv4{};
+    std::array<IPV6Raw, IPV6_RECORDS> ipv6{};
+    RecordChunk*                      next{};
+
+    // Bookkeeping of a retired chain, used in its first chunk only.
+    RecordChunk*                      next_retired{};
+    core::EpochDomain::Epoch          retired_at{};
+
+}; // RecordChunk
+
+///
+/// \brief The RecordBlock struct is the fixed-size record set a cache node holds inline.
+/// \details The first few A and AAAA records live right here, the rest spill into a RecordChunk chain.
+///
+struct RecordBlock
+{
+    inline static constexpr core::Size IPV4_RECORDS{ 4 };
+    inline static constexpr core::Size IPV6_RECORDS{ 2 };
+
+    std::uint16_t                     ipv4_number{}; // All of them, the overflowing ones included.
+    std::uint16_t                     ipv6_number{};
+    Negative                          negative{};    // A negative entry's, which has no records; in the padding.
+    std::array<IPV4Raw, IPV4_RECORDS> ipv4{};
+    std::array<IPV6Raw, IPV6_RECORDS> ipv6{};
+    RecordChunk*                      overflow{};
+
+}; // RecordBlock
+
+///
+/// \name net::RecordSetView
+/// \brief The RecordSetView class is a non-owning view of a name's A and AAAA records.
+/// \details The inline records are a snapshot; the overflowing ones are read in place, and the view pins
+/// them for its lifetime. Pinning never blocks the cache's writers, but it delays the reuse of replaced
+/// records, so views are meant to be short-lived. A view must not outlive its cache.
+///
+class RecordSetView
+{
+private: // Fields:
+    RecordBlock              block;
+    core::EpochDomain::Guard guard;
+
+public: // RAII:
+    RecordSetView(RecordBlock const& block, core::EpochDomain::Guard&& guard) noexcept(true)
+        : block{ block }
+        , guard{ std::move(guard) }
+    {}
+
+public: // Methods:
+    [[nodiscard]]
+    auto ipv4Number() const noexcept(true) -> core::Size
+    { return this->block.ipv4_number; }
+
+    [[nodiscard]]
+    auto ipv6Number() const noexcept(true) -> core::Size
+    { return this->block.ipv6_number; }
+
+    ///
+    /// \pre `index` < ipv4Number()
+    ///
+    [[nodiscard]]
+    auto ipv4(core::Size index) const noexcept(true) -> IPV4Raw
+    {
+        if (index < RecordBlock::IPV4_RECORDS)
+        { return this->block.ipv4[index]; }
+
+        index -= RecordBlock::IPV4_RECORDS;
+        auto chunk{ this->block.overflow };
+        for (; RecordChunk::IPV4_RECORDS <= index; index -= RecordChunk::IPV4_RECORDS)
+        { chunk = chunk->next; }
+
+        return chunk->ipv4[index];
+    }
+
+    ///
+    /// \pre `index` < ipv6Number()
+    ///
+    [[nodiscard]]
+    auto ipv6(core::Size index) const noexcept(true) -> IPV6Raw const&
+    {
+        if (index < RecordBlock::IPV6_RECORDS)
+        { return this->block.ipv6[index]; }
+
+        index -= RecordBlock::IPV6_RECORDS;
+        auto chunk{ this->block.overflow };
+        for (; RecordChunk::IPV6_RECORDS <= index; index -= RecordChunk::IPV6_RECORDS)
+        { chunk = chunk->next; }
+
+        return chunk->ipv6[index];
+    }
+
+}; // RecordSetView
+
+} // net
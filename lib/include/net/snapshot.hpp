@@ -0,0 +1,183 @@
+#pragma once
+
+#include "core/mapped_file.hpp"
+#include "core/span.hpp"
+#include "core/types.hpp"
+#include "net/record_set.hpp"
+#include "net/types.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+///
+/// \brief The snapshot file of a DNSCache, see DNSCache::saveSnapshot().
+/// \details The file is a Header followed by sections that the header points at by offset. The sections are
+/// arrays of fixed-size records, each 8-byte aligned, in the host's byte order: it's a warm restart format,
+/// not an interchange one. A file of another version or byte order is rejected.
+///
+/// Every shard's entries are a run of the entries section: sorted by key w/ the ordered index (hashed
+/// entries come in the table's order), so a shard of a cache that's sharded the same way rebuilds its index
+/// w/o sorting. The ranks section has a position in the run per entry, from the next victim up.
+///
+namespace net::snapshot
+{
+
+inline constexpr std::array<char, 8> MAGIC{ 'D', 'N', 'S', 'C', 'S', 'N', 'A', 'P' };
+inline constexpr std::uint32_t       VERSION{ 1 };
+inline constexpr std::uint32_t       BYTE_ORDER_MARK{ 0x0102'0304 };
+inline constexpr std::int64_t        NEVER_EXPIRES{ -1 };
+
+struct Header
+{
+    std::array<char, 8> magic;
+    std::uint32_t       version;
+    std::uint32_t       byte_order;
+    std::uint64_t       file_size;
+    std::uint64_t       checksum;       // Of everything after the header.
+    std::int64_t        saved_at_ms;    // The system clock's, the TTLs are counted from it.
+    std::uint64_t       hash_probe;     // std::hash of PROBE_KEY: a change of it reshuffles the shards.
+    std::uint64_t       shards_number;
+    std::uint64_t       entries_number;
+    std::uint64_t       runs_offset;    // std::uint64_t[shards_number + 1]: where each shard's run begins.
+    std::uint64_t       entries_offset; // Entry[entries_number]
+    std::uint64_t       ranks_offset;   // std::uint32_t[entries_number]
+    std::uint64_t       keys_offset;    // The keys' characters, back to back.
+    std::uint64_t       keys_size;
+    std::uint64_t       ipv4_offset;    // IPV4Raw[ipv4_number]
+    std::uint64_t       ipv4_number;
+    std::uint64_t       ipv6_offset;    // IPV6Raw[ipv6_number]
+    std::uint64_t       ipv6_number;
+
+}; // Header
+
+struct Entry
+{
+    std::uint64_t                key_offset;
+    std::uint64_t                ipv4_index;  // The first record's, in the IPv4 section.
+    std::uint64_t                ipv6_index;
+    std::int64_t                 ttl_ms;      // What was left of it at saved_at_ms, or NEVER_EXPIRES.
+    std::uint16_t                ipv4_number;
+    std::uint16_t                ipv6_number;
+    std::uint8_t                 key_length;
+    std::array<std::uint8_t, 3>  padding;
+
+}; // Entry
+
+inline constexpr std::string_view PROBE_KEY{ "probe.snapshot.dns.cache" };
+
+///
+/// \name net::snapshot::Writer
+/// \brief The Writer class gathers a snapshot shard by shard, then writes it at once.
+///
+class Writer
+{
+private: // Fields:
+    std::int64_t               saved_at_ms{};
+    std::vector<std::uint64_t> runs{ 0 };
+    std::vector<Entry>         entries{};
+    std::vector<std::uint32_t> ranks{};
+    std::vector<char>          keys{};
+    std::vector<IPV4Raw>       ipv4s{};
+    std::vector<IPV6Raw>       ipv6s{};
+
+public: // RAII:
+    Writer() noexcept(false);
+
+public: // Methods:
+    ///
+    /// \brief add appends an entry to the current shard's run, records from the overflow included.
+    /// \param ttl_ms is what's left of the TTL now, or NEVER_EXPIRES.
+    /// \return The entry's position in the run.
+    ///
+    auto add(std::string_view key, RecordBlock const& records, std::int64_t ttl_ms) noexcept(false)
+        -> std::uint32_t;
+
+    ///
+    /// \brief rank appends a position in the current shard's run, from the next victim up.
+    ///
+    auto rank(std::uint32_t position) noexcept(false) -> void;
+
+    ///
+    /// \brief closeRun starts the next shard's run.
+    /// \throws std::logic_error if the run's entries haven't been ranked each exactly once.
+    ///
+    auto closeRun() noexcept(false) -> void;
+
+    ///
+    /// \brief write puts the snapshot into a temporary file next to `path` first, then renames it: the file
+    /// at `path` is either the old one or the whole new one.
+    /// \throws std::runtime_error if the file can't be written.
+    ///
+    auto write(std::string const& path) const noexcept(false) -> void;
+
+}; // Writer
+
+///
+/// \name net::snapshot::Reader
+/// \brief The Reader class maps a snapshot and checks it, then the entries are read right in the mapping.
+///
+class Reader
+{
+private: // Fields:
+    core::MappedFile file;
+    Header const*    header{};
+
+public: // RAII:
+    ///
+    /// \throws std::system_error if the file can't be mapped, std::runtime_error if it isn't a snapshot of
+    /// this version, doesn't add up, or fails the checksum.
+    ///
+    explicit Reader(std::string const& path) noexcept(false);
+
+public: // Methods:
+    [[nodiscard]]
+    auto shardsNumber() const noexcept(true) -> core::Size
+    { return this->header->shards_number; }
+
+    ///
+    /// \return Whether the shards would be picked the same way now: the hash function and their number.
+    ///
+    [[nodiscard]]
+    auto shardedAs(core::Size shards_number) const noexcept(true) -> bool;
+
+    ///
+    /// \return How long ago the snapshot was taken, by the system clock: never negative.
+    ///
+    [[nodiscard]]
+    auto age() const noexcept(true) -> std::chrono::milliseconds;
+
+    [[nodiscard]]
+    auto entries() const noexcept(true) -> core::Span<Entry const>;
+
+    ///
+    /// \return The first entry of every shard's run, and the end of the last one.
+    ///
+    [[nodiscard]]
+    auto runs() const noexcept(true) -> core::Span<std::uint64_t const>;
+
+    [[nodiscard]]
+    auto ranks() const noexcept(true) -> core::Span<std::uint32_t const>;
+
+    [[nodiscard]]
+    auto key(Entry const& entry) const noexcept(true) -> std::string_view;
+
+    [[nodiscard]]
+    auto ipv4s(Entry const& entry) const noexcept(true) -> core::Span<IPV4Raw const>;
+
+    [[nodiscard]]
+    auto ipv6s(Entry const& entry) const noexcept(true) -> core::Span<IPV6Raw const>;
+
+private: // Helpers:
+    template <typename T>
+    auto section(std::uint64_t offset) const noexcept(true) -> T const*
+    { return reinterpret_cast<T const*>(this->file.data() + offset); }
+
+    auto validate() noexcept(false) -> void;
+
+}; // Reader
+
+} // net::snapshot
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -9,5 +12,29 @@ namespace net
 using FQDN    = std::string;
 using IP      = std::string;
 using IPV4Raw = std::uint32_t;
+using IPV6Raw = std::array<std::uint8_t, 16>;
+
+// The longest name in the wire format; the presentation format is shorter still.
+inline constexpr std::size_t MAX_FQDN_LENGTH{ 255 };
+
+// Milliseconds, so the tests don't have to sleep for seconds; std::chrono::seconds convert implicitly.
+using TTL = std::chrono::milliseconds;
+
+// The records never expire, they're only evicted.
+inline constexpr TTL NO_TTL{ TTL::max() };
+
+///
+/// \brief The Negative enum is what a negative answer said (RFC 2308); NONE is a positive one.
+///
+enum class Negative : std::uint8_t
+{
+    NONE,
+    NXDOMAIN, // The name doesn't exist.
+    NODATA    // The name exists, but it has no A or AAAA records.
+};
+
+// RFC 2308 finds one to three hours sensible for the negative TTLs and longer than a day problematic: the
+// longer ones are cut down to this.
+inline constexpr TTL MAX_NEGATIVE_TTL{ std::chrono::hours{ 3 } };
 
 } // net::util
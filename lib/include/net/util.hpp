@@ -4,6 +4,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace net
 {
@@ -16,4 +17,24 @@ using IPV4StrResult = std::optional<IP>;
 
 auto IPV4RawToStr(IPV4Raw raw_ip) noexcept(true) -> IPV4StrResult;
 
+using IPV6RawResult = std::optional<IPV6Raw>;
+
+auto strToIPV6Raw(std::string const& str_ip) noexcept(true) -> IPV6RawResult;
+
+using IPV6StrResult = std::optional<IP>;
+
+auto IPV6RawToStr(IPV6Raw const& raw_ip) noexcept(true) -> IPV6StrResult;
+
+///
+/// \brief compareReversedLabels orders the names label by label from the right (`com`, `example.com`,
+/// `a.example.com`, `b.example.com`, `net`), so the names under a domain come right after it, all together.
+/// \return Less than, equal to or greater than 0, like std::string_view::compare().
+///
+auto compareReversedLabels(std::string_view lhs, std::string_view rhs) noexcept(true) -> int;
+
+///
+/// \return Whether `fqdn` is `domain` or a name under it; every name is under the root, the empty domain.
+///
+auto isUnderDomain(std::string_view fqdn, std::string_view domain) noexcept(true) -> bool;
+
 } // net
@@ -0,0 +1,225 @@
+#include "net/bulk_load.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+extern "C"
+{
+#include <arpa/inet.h>
+
+} // extern "C"
+
+namespace net::bulk_load
+{
+
+namespace
+{
+
+// RFC 2181: a TTL is 31 bits.
+inline constexpr std::int64_t MAX_TTL_SECONDS{ std::numeric_limits<std::int32_t>::max() };
+
+// The same as std::isspace() in the C locale, w/o the call.
+constexpr auto isSpace(char const c) noexcept(true) -> bool
+{ return (' ' == c) or (('\t' <= c) and (c <= '\r')); }
+
+auto nextToken(std::string_view& line) noexcept(true) -> std::string_view
+{
+    core::Size begin{ 0 };
+    while ((begin < line.size()) and isSpace(line[begin]))
+    { ++begin; }
+
+    auto end{ begin };
+    while ((end < line.size()) and not isSpace(line[end]))
+    { ++end; }
+
+    auto const token{ line.substr(begin, end - begin) };
+    line.remove_prefix(end);
+    return token;
+}
+
+auto equalsIgnoringCase(std::string_view const token, std::string_view const word) noexcept(true) -> bool
+{
+    auto const sameLetter{
+        [] (char const lhs, char const upper)
+        { return (lhs == upper) or (lhs == static_cast<char>(upper - 'A' + 'a')); }
+    };
+
+    // The words are upper case.
+    return (token.size() == word.size()) and std::equal(token.begin(), token.end(), word.begin(), sameLetter);
+}
+
+///
+/// \brief parseIPV4 is inet_pton(AF_INET) w/o the NUL terminated copy: the dotted quad, no leading zeros.
+///
+auto parseIPV4(std::string_view const token, Record& record) noexcept(true) -> bool
+{
+    std::array<std::uint8_t, 4> octets{};
+    core::Size octet{ 0 };
+    unsigned   value{ 0 };
+    core::Size digits{ 0 };
+
+    for (auto const c : token)
+    {
+        if ('.' == c)
+        {
+            if ((0 == digits) or ((octets.size() - 1) == octet))
+            { return false; }
+
+            octets[octet++] = static_cast<std::uint8_t>(value);
+            value  = 0;
+            digits = 0;
+            continue;
+        }
+
+        if ((c < '0') or ('9' < c) or ((1 == digits) and (0 == value)))
+        { return false; }
+
+        value = (value * 10) + static_cast<unsigned>(c - '0');
+        ++digits;
+        if (255 < value)
+        { return false; }
+    }
+
+    if ((0 == digits) or ((octets.size() - 1) != octet))
+    { return false; }
+
+    octets[octet] = static_cast<std::uint8_t>(value);
+
+    // As it goes on the wire: the network byte order, the same as inet_pton's.
+    record.address = IPV6Raw{};
+    std::memcpy(record.address.data(), octets.data(), octets.size());
+    record.ipv6 = false;
+    return true;
+}
+
+auto parseIPV6(std::string_view const token, Record& record) noexcept(true) -> bool
+{
+    std::array<char, INET6_ADDRSTRLEN> terminated{};
+    if ((terminated.size() <= token.size()) or (std::string_view::npos == token.find(':')))
+    { return false; }
+
+    std::copy(token.begin(), token.end(), terminated.begin());
+    record.ipv6 = true;
+    return (1 == ::inet_pton(AF_INET6, terminated.data(), record.address.data()));
+}
+
+auto parseAddress(std::string_view const token, Record& record) noexcept(true) -> bool
+{ return parseIPV4(token, record) or parseIPV6(token, record); }
+
+auto parseSeconds(std::string_view const token, std::int64_t& ttl_ms) noexcept(true) -> bool
+{
+    std::int64_t seconds{};
+    auto const [end, error]{ std::from_chars(token.data(), token.data() + token.size(), seconds) };
+    if ((std::errc{} != error) or ((token.data() + token.size()) != end) or (seconds < 0))
+    { return false; }
+
+    ttl_ms = std::min(seconds, MAX_TTL_SECONDS) * 1000;
+    return true;
+}
+
+auto setName(char const* origin, std::string_view const name, Record& record) noexcept(true) -> bool
+{
+    if (name.empty() or (MAX_FQDN_LENGTH < name.size()))
+    { return false; }
+
+    record.name_offset = static_cast<std::uint64_t>(name.data() - origin);
+    record.name_length = static_cast<std::uint8_t>(name.size());
+    return true;
+}
+
+auto parseLine(char const* origin, std::string_view line, std::vector<Record>& records) noexcept(false) -> void
+{
+    auto const first{ nextToken(line) };
+    if (first.empty() or ('$' == first.front()))
+    { return; }
+
+    Record record{};
+    record.ttl_ms = DEFAULT_TTL;
+
+    // A hosts line: the address, then the names.
+    if (parseAddress(first, record))
+    {
+        for (auto name{ nextToken(line) }; not name.empty(); name = nextToken(line))
+        {
+            if (setName(origin, name, record))
+            { records.push_back(record); }
+        }
+
+        return;
+    }
+
+    // A zone record: name [ttl] [class] type address.
+    auto name{ first };
+    if ((1 < name.size()) and ('.' == name.back()))
+    { name.remove_suffix(1); }
+
+    if (not setName(origin, name, record))
+    { return; }
+
+    auto type{ nextToken(line) };
+    while (parseSeconds(type, record.ttl_ms) or equalsIgnoringCase(type, "IN"))
+    { type = nextToken(line); }
+
+    auto const address{ nextToken(line) };
+    auto const parsed{
+        equalsIgnoringCase(type, "A")    ? parseIPV4(address, record) :
+        equalsIgnoringCase(type, "AAAA") ? parseIPV6(address, record) : false
+    };
+
+    if (parsed)
+    { records.push_back(record); }
+}
+
+} // anonymous
+
+auto Record::ipv4() const noexcept(true) -> IPV4Raw
+{
+    IPV4Raw raw_ip{};
+    std::memcpy(&raw_ip, this->address.data(), sizeof(raw_ip));
+    return raw_ip;
+}
+
+auto splitLines(std::string_view const text, core::Size const parts) noexcept(false)
+    -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> pieces;
+    auto const piece_size{ text.size() / std::max(parts, core::Size{ 1 }) };
+
+    core::Size begin{ 0 };
+    while (begin < text.size())
+    {
+        // The last piece takes the rest, the others end right after a line.
+        auto end{ text.size() };
+        if ((pieces.size() + 1) < parts)
+        {
+            end = text.find('\n', begin + std::max(piece_size, core::Size{ 1 }) - 1);
+            end = (std::string_view::npos == end) ? text.size() : (end + 1);
+        }
+
+        pieces.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    return pieces;
+}
+
+auto parseLines(std::string_view const text, std::string_view lines, std::vector<Record>& records) noexcept(false)
+    -> void
+{
+    while (not lines.empty())
+    {
+        auto const line_end{ lines.find('\n') };
+        auto line{ lines.substr(0, line_end) };
+        lines.remove_prefix((std::string_view::npos == line_end) ? lines.size() : (line_end + 1));
+
+        if (auto const comment{ line.find('#') }; std::string_view::npos != comment)
+        { line = line.substr(0, comment); }
+
+        parseLine(text.data(), line, records);
+    }
+}
+
+} // net::bulk_load
@@ -1,191 +1,3043 @@
+#include "core/clock.hpp"
+#include "core/epoch.hpp"
 #include "core/flat_map.hpp"
+#include "core/frequency_sketch.hpp"
+#include "core/inline_string.hpp"
 #include "core/ladder.hpp"
+#include "core/links.hpp"
+#include "core/map_policy.hpp"
+#include "core/mapped_file.hpp"
+#include "core/page_array.hpp"
+#include "core/seq_lock.hpp"
+#include "core/slab_pool.hpp"
+#include "core/span.hpp"
+#include "core/striped_counters.hpp"
+#include "core/timing_wheel.hpp"
 #include "core/types.hpp"
+#include "net/bulk_load.hpp"
 #include "net/dns_cache.hpp"
+#include "net/record_set.hpp"
+#include "net/snapshot.hpp"
 #include "net/util.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #include <functional>
+#include <future>
+#include <istream>
 #include <iterator>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace net
 {
 
 ///
-/// \brief The DNSCache::DNSCacheImpl class
+/// \brief The DNSCache::StatsCounters class is what stats() sums up: a counter per Stats field.
 ///
-class DNSCache::DNSCacheImpl
+class DNSCache::StatsCounters
 {
 public:
-    using NodeKeyType   = FQDN;
-    using NodeValueType = IPV4Raw;
+    enum class Counter : core::Size
+    {
+        HITS,
+        L1_HITS,
+        NEGATIVE_HITS,
+        MISSES,
+        INSERTS,
+        UPDATES,
+        EVICTIONS,
+        EXPIRATIONS,
+        PROMOTIONS_TO_TOP,
+        PROMOTIONS_ONE_UP,
+        LOCK_CONTENTIONS,
+        LOCK_WAIT_NS,
+        COUNTERS_NUMBER
+    };
+
+private:
+    core::StripedCounters<static_cast<core::Size>(Counter::COUNTERS_NUMBER)> counters{};
+
+public:
+    ///
+    /// \brief add is a no-op w/o DNS_CACHE_STATS, `counters` is null then.
+    ///
+    static auto add(
+        [[maybe_unused]] StatsCounters* counters,
+        [[maybe_unused]] Counter        counter,
+        [[maybe_unused]] std::uint64_t  value = 1
+    ) noexcept(true) -> void
+    {
+#if defined(DNS_CACHE_STATS)
+        counters->counters.add(static_cast<core::Size>(counter), value);
+#endif
+    }
+
+    [[nodiscard]]
+    auto sum(Counter const counter) const noexcept(true) -> std::uint64_t
+    { return this->counters.sum(static_cast<core::Size>(counter)); }
+
+}; // DNSCache::StatsCounters
+
+///
+/// \brief The DNSCache::BasicDNSCacheImpl class is a shard of the cache.
+/// \tparam Replacement is the replacement policy: core::Ladder or core::Clock.
+/// \details Writers are serialized by the owning shard's mutex. Readers don't take it: they walk the
+/// dictionary optimistically under the seqlock, while the epoch domain keeps the nodes they may be looking
+/// at from being reused. Readers' hits only mark the node (see Replacement::reference()).
+///
+/// An evicted node a reader may still see isn't reused right away: it joins a few retiring nodes off the
+/// queues, and the oldest of those goes in its place once the epoch's moved on past it. The writer only
+/// waits for the readers if even the oldest one isn't safe yet.
+///
+/// Entries w/ a TTL are scheduled on the expiry wheel. Readers check the expiry themselves, so an expired
+/// entry is a miss right away; the writers reclaim it lazily, advancing the wheel on every update, and put
+/// its node where the replacement policy releases the next victim from, so it's reused first.
+///
+/// W/ the TinyLFU admission, new names enter a small window queue first. When the window's victim is
+/// to be evicted, it's admitted to the main queue only if it's been seen more often than the main
+/// queue's victim (going by the frequency sketch of all the resolves and updates); otherwise it's the
+/// one evicted. A scan of one-off names thus only churns the window.
+///
+/// Record sets that don't fit a node spill into chunks from the shard's pool. A second epoch domain
+/// protects those: record set views pin it, and since the writers never wait for it, holding a view never
+/// blocks an update.
+///
+/// The nodes are in slabs (see Chunk): the constructor's, and one per resize() that grows the main queue
+/// past the nodes it's parked. Shrinking parks the nodes it evicts off the queues; a slab's handed back once
+/// there are enough parked nodes elsewhere for its entries to move to.
+///
+template <template <typename, typename> class Replacement>
+class DNSCache::BasicDNSCacheImpl
+{
+public:
+    using NodeKeyType   = core::InlineString<MAX_FQDN_LENGTH>; // Inline, so reusing a node never allocates.
+    using NodeValueType = RecordBlock;
+    using Tick          = std::uint64_t; // The expiry wheel's: milliseconds of the steady clock.
+
+    inline static constexpr Tick NEVER{ std::numeric_limits<Tick>::max() };
+
+#if defined(DNS_CACHE_HASHED_INDEX)
+    using IndexKind = core::HashedIndex;
+#else
+    using IndexKind = core::OrderedIndex;
+#endif
+
+    struct Node;
+
+#if defined(DNS_CACHE_COMPACT_LINKS)
+    using NodeLinks = core::CompactLinks<Node>; // The nodes' slots in `slots`: half the links' bytes.
+#else
+    using NodeLinks = core::PointerLinks<Node>;
+#endif
+
+    ///
+    /// \brief The Node struct
+    /// \details The wheel's trait comes first: the queue's packs into its tail padding w/ the compact links.
+    ///
+    struct Node
+        : public core::TimingWheel<Node, NodeLinks>::NodeTrait
+        , public Replacement<Node, NodeLinks>::NodeTrait
+        , public core::FlatMap<NodeKeyType, NodeValueType, Node, IndexKind, core::CallbackPolicy<Node>,
+                               NodeLinks>::NodeTrait
+    {
+        using NodeKeyReference = NodeKeyType const&;
+
+        bool                     indexed{ false };
+        bool                     in_window{ false };
+        bool                     in_negative{ false }; // In the negative queue, the negative entries' own.
+        bool                     parked{ false };      // Off the queues after a shrink, for a grow to take.
+        bool                     retiring{ false };    // Off the queues till no reader can see it: see retire().
+        std::uint32_t            slot{};               // The index over all the chunks' nodes, see `slots`.
+        core::EpochDomain::Epoch retired_at{};
+        Tick                     expires_at{ NEVER };
+
+        ///
+        /// \brief operator NodeKeyReference is a helper cast operator.
+        /// \details It's defined, so we don't have to define tons of comparison operators.
+        /// Just use the existing ones.
+        /// \return Const reference to the key held by the node.
+        ///
+        operator NodeKeyReference () const noexcept(true)
+        { return this->first; }
+
+    }; // Node
+
+    ///
+    /// \brief The DictionaryPolicy struct wires the dictionary to the shard at compile time: the insert path
+    /// inlines down to the replacement policy, w/o any std::function in between.
+    ///
+    struct DictionaryPolicy
+    {
+        BasicDNSCacheImpl* impl{};
+
+        auto allocate() noexcept(false) -> Node*
+        { return this->impl->allocate(); }
+
+        auto onCreate(Node* created_node) noexcept(true) -> core::CreateOrUpdateStatus
+        { return this->impl->onCreate(created_node); }
+
+        auto onUpdate(Node* updated_node) noexcept(true) -> core::CreateOrUpdateStatus
+        { return this->impl->onUpdate(updated_node); }
+
+    }; // DictionaryPolicy
+
+    ///
+    /// \brief The ReversedName struct is a cached name as the suffix index orders it, see compareReversedLabels().
+    /// \details Just a view of the node's key: a node's unindexed before its key's reused.
+    ///
+    struct ReversedName
+    {
+        std::string_view name{};
+
+        friend auto operator == (ReversedName const& lhs, ReversedName const& rhs) noexcept(true) -> bool
+        { return (lhs.name == rhs.name); }
+
+        friend auto operator < (ReversedName const& lhs, ReversedName const& rhs) noexcept(true) -> bool
+        { return (compareReversedLabels(lhs.name, rhs.name) < 0); }
+
+    }; // ReversedName
+
+    struct SuffixNode
+        : public core::FlatLLRBMap<ReversedName, Node*, SuffixNode>::NodeTrait
+    {
+        operator ReversedName const& () const noexcept(true)
+        { return this->first; }
+
+    }; // SuffixNode
+
+    ///
+    /// \brief The SuffixPolicy struct hands the suffix index the node of the name being indexed: a node's
+    /// suffix node is the one at the same position in its chunk's `suffixes`.
+    ///
+    struct SuffixPolicy
+    {
+        BasicDNSCacheImpl* impl{};
+
+        auto allocate() noexcept(true) -> SuffixNode*
+        { return this->impl->pending_suffix; }
+
+        auto onCreate(SuffixNode*) noexcept(true) -> core::CreateOrUpdateStatus
+        { return core::CreateOrUpdateStatus::SUCCESS; }
+
+        auto onUpdate(SuffixNode*) noexcept(true) -> core::CreateOrUpdateStatus
+        { return core::CreateOrUpdateStatus::SUCCESS; }
+
+    }; // SuffixPolicy
+
+    ///
+    /// \brief The Chunk struct is a slab of nodes, w/ their slots from `first_slot` on once it's numbered.
+    ///
+    struct Chunk
+    {
+        core::PageArray<Node>         nodes;
+        core::Size                    first_slot{};
+        std::unique_ptr<SuffixNode[]> suffixes{}; // Parallel to `nodes`, w/ the suffix index only.
+
+        Chunk(core::Size const nodes_number, core::PageOptions const& pages) noexcept(false)
+            : nodes{ nodes_number, pages }
+        {}
+
+        ///
+        /// \brief number gives the nodes their slots in `slots`: the last thing done to a new chunk that may
+        /// throw.
+        ///
+        auto number(core::SlotTable<Node>& slots) noexcept(false) -> void
+        {
+            this->first_slot = slots.add(this->nodes.get(), this->nodes.size());
+            for (core::Size i{ 0 }; i < this->nodes.size(); ++i)
+            { this->nodes[i].slot = static_cast<std::uint32_t>(this->first_slot + i); }
+        }
+
+        [[nodiscard]]
+        auto holds(Node const* node) const noexcept(true) -> bool
+        { return ((this->first_slot <= node->slot) and (node->slot < (this->first_slot + this->nodes.size()))); }
+
+    }; // Chunk
+
+public:
+    using DNSReplacement = Replacement<Node, NodeLinks>;
+    using DNSDictionary  = core::FlatMap<NodeKeyType, NodeValueType, Node, IndexKind, DictionaryPolicy, NodeLinks>;
+    using ExpiryWheel    = core::TimingWheel<Node, NodeLinks>;
+    using SuffixIndex    = core::FlatLLRBMap<ReversedName, Node*, SuffixNode, SuffixPolicy>;
+
+    enum class ReadStatus : std::uint8_t
+    {
+        HIT,
+        MISS,
+        CONTENDED // Writers kept interfering: retry under the lock.
+    };
+
+    ///
+    /// \brief BATCH_WIDTH is the most names a batched call takes: the lookups in flight at once.
+    /// \details About as many cache misses as a core can have outstanding; more would only grow the stack.
+    ///
+    inline static constexpr core::Size BATCH_WIDTH{ 16 };
+
+    [[nodiscard]]
+    static auto nowTick() noexcept(true) -> Tick
+    {
+        auto const since_epoch{ std::chrono::steady_clock::now().time_since_epoch() };
+        return static_cast<Tick>(std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count());
+    }
+
+    [[nodiscard]]
+    static auto isExpired(Tick const expires_at, Tick const now = nowTick()) noexcept(true) -> bool
+    { return ((NEVER != expires_at) and (expires_at <= now)); }
+
+private:
+    inline static constexpr core::Size LOCK_FREE_READ_ATTEMPTS{ 8 };
+    inline static constexpr core::Size WINDOW_PERCENTAGE{ 1 };
+    inline static constexpr core::Size RETIRING_NODES{ 64 }; // Evictions a reader may lag behind w/o a wait.
+
+private:
+    core::Capacity const      window_capacity; // 0 w/o the admission filter.
+    core::PageOptions const   pages;           // The chunks'.
+    core::SlotTable<Node>     slots{};         // The chunks' nodes by their slots, for the compact links.
+    std::vector<std::unique_ptr<Chunk>> chunks; // In their slots' order, the constructor's first.
+    std::vector<Node*>        parked_nodes{};
+    std::array<Node*, RETIRING_NODES> retiring_nodes{}; // A ring, the oldest retired at `retiring_head`.
+    core::Size                retiring_head{ 0 };
+    std::optional<DNSReplacement> window{};
+    DNSReplacement                main_queue;
+    std::optional<DNSReplacement> negative_queue{}; // After the others' nodes, w/ a negative budget only.
+    DNSDictionary             dictionary;
+    core::SeqLock             seq_lock{};
+    mutable core::EpochDomain epoch_domain{};
+    ExpiryWheel               expiry_wheel{ nowTick(), nodeLinks() };
+    Tick                      pending_expires_at{ NEVER }; // For the create/update callbacks.
+    bool                      pending_negative{ false };   // For the allocate callback.
+
+    core::SlabPool<RecordChunk> records_pool{};
+    mutable core::EpochDomain   records_domain{};
+    RecordChunk*                retired_records_head{};
+    RecordChunk*                retired_records_tail{};
+
+    mutable std::optional<core::FrequencySketch> frequencies{}; // W/ the admission filter only.
+
+    // The writers' only: the readers never look names up by their suffixes.
+    std::optional<SuffixIndex>    suffix_index{};
+    SuffixNode*                   pending_suffix{}; // For the suffix index' allocate callback.
+
+    StatsCounters* const counters; // Shared by all the shards, null w/o DNS_CACHE_STATS.
+
+    using Counter = StatsCounters::Counter;
+
+    auto count(Counter const counter) const noexcept(true) -> void
+    { StatsCounters::add(this->counters, counter); }
+
+    auto allocate() noexcept(false) -> Node*;
+
+    ///
+    /// \brief onCreate puts a new name's node on top of its queue and schedules its expiry.
+    ///
+    auto onCreate(Node* created_node) noexcept(true) -> core::CreateOrUpdateStatus;
+
+    ///
+    /// \brief onUpdate promotes an updated name's node one up and reschedules its expiry.
+    ///
+    auto onUpdate(Node* updated_node) noexcept(true) -> core::CreateOrUpdateStatus;
+
+    ///
+    /// \brief admit picks the node to reuse w/ the admission filter, see the class' details.
+    ///
+    auto admit() noexcept(false) -> Node*;
+
+    ///
+    /// \brief retire puts the evicted `node`, which a reader may still see, w/ the retiring nodes.
+    /// \return The oldest retiring node, to be reused in its place: safe, after a grace period if need be.
+    ///
+    auto retire(Node* node) noexcept(true) -> Node*;
+
+    ///
+    /// \brief replaceRetiring puts the parked `to` in the place of the retiring `from`; `from`'s parked then.
+    ///
+    auto replaceRetiring(Node* from, Node* to) noexcept(true) -> void;
+
+    auto queueOf(Node const* node) noexcept(true) -> DNSReplacement&
+    {
+        if (node->in_negative)
+        { return *(this->negative_queue); }
+
+        return (node->in_window ? *(this->window) : this->main_queue);
+    }
+
+    ///
+    /// \brief forEachNode calls `visit` w/ every node of every chunk, in the slots' order.
+    ///
+    template <typename Visit>
+    auto forEachNode(Visit&& visit) const noexcept(false) -> void
+    {
+        for (auto const& chunk : this->chunks)
+        {
+            for (core::Size i{ 0 }; i < chunk->nodes.size(); ++i)
+            { visit(chunk->nodes.get() + i); }
+        }
+    }
+
+    [[nodiscard]]
+    auto chunkOf(Node const* node) const noexcept(true) -> Chunk&
+    {
+        auto const next{
+            std::upper_bound(this->chunks.begin(), this->chunks.end(), core::Size{ node->slot },
+                             [] (core::Size const slot, auto const& chunk) { return slot < chunk->first_slot; })
+        };
+
+        return **std::prev(next);
+    }
+
+    [[nodiscard]]
+    auto slotsNumber() const noexcept(true) -> core::Size
+    { return (this->chunks.back()->first_slot + this->chunks.back()->nodes.size()); }
+
+    [[nodiscard]]
+    auto negativeCapacity() noexcept(true) -> core::Capacity
+    { return this->negative_queue.has_value() ? this->negative_queue->maxSize() : 0; }
+
+    [[nodiscard]]
+    auto makeChunks(core::Size const nodes_number) noexcept(false) -> std::vector<std::unique_ptr<Chunk>>
+    {
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        chunks.push_back(std::make_unique<Chunk>(nodes_number, this->pages));
+        chunks.back()->number(this->slots);
+        this->slots.reclaimRetired([] () {}); // No reader's come yet.
+
+        return chunks;
+    }
+
+    [[nodiscard]]
+    auto nodeLinks() const noexcept(true) -> NodeLinks
+    {
+        if constexpr (std::is_same_v<NodeLinks, core::CompactLinks<Node>>)
+        { return NodeLinks{ &(this->slots) }; }
+        else
+        { return NodeLinks{}; }
+    }
+
+    [[nodiscard]]
+    auto makeDictionary(core::Capacity const capacity) noexcept(false) -> DNSDictionary
+    {
+        // The hashed index' table links to the nodes itself.
+        if constexpr (std::is_same_v<IndexKind, core::OrderedIndex>)
+        { return DNSDictionary{ capacity, DictionaryPolicy{ this }, this->nodeLinks() }; }
+        else
+        { return DNSDictionary{ capacity, DictionaryPolicy{ this } }; }
+    }
+
+    [[nodiscard]]
+    static auto keyHash(std::string_view const key) noexcept(true) -> std::uint64_t
+    { return std::hash<NodeKeyType>{}(key); }
+
+    [[nodiscard]]
+    static auto windowCapacity(core::Capacity const capacity, Admission const admission) noexcept(true)
+        -> core::Capacity
+    {
+        if (Admission::TINY_LFU != admission)
+        { return 0; }
+
+        return std::max(DNSReplacement::MINIMAL_VIABLE_CAPACITY, (capacity * WINDOW_PERCENTAGE) / 100);
+    }
+
+    ///
+    /// \brief unindex drops the node from the dictionary and the expiry wheel; its storage is retired.
+    ///
+    auto unindex(Node* node) noexcept(true) -> void;
+    auto indexSuffix(Node* node) noexcept(true) -> void;
+    auto rebuildSuffixIndex() noexcept(false) -> void;
+    auto setExpiry(Node* node) noexcept(true) -> void;
+    auto reclaimExpired(Tick now) noexcept(true) -> void;
+
+    ///
+    /// \brief grow puts `nodes_number` more nodes at the bottom of the main queue: the parked ones first, then
+    /// a new chunk's.
+    ///
+    auto grow(core::Size nodes_number) noexcept(false) -> void;
+
+    ///
+    /// \brief shrink parks the main queue's next `nodes_number` victims, evicting their entries.
+    ///
+    auto shrink(core::Size nodes_number) noexcept(false) -> void;
+
+    ///
+    /// \brief releaseChunks hands the last chunks back while there are enough parked nodes to take over from
+    /// theirs, moving up to `max_nodes` of their entries.
+    /// \return true if there's no chunk left to hand back.
+    ///
+    auto releaseChunks(core::Size max_nodes) noexcept(false) -> bool;
+
+    ///
+    /// \brief relocate moves `from`'s place in its queue, and its entry if it has one, to the parked `to`;
+    /// `from`'s parked then. Under the write guard.
+    ///
+    auto relocate(Node* from, Node* to) noexcept(true) -> void;
+
+    [[nodiscard]]
+    static auto expiresAt(Tick const now, TTL const ttl) noexcept(true) -> Tick
+    {
+        auto const ttl_ticks{ static_cast<Tick>(std::max(ttl.count(), TTL::rep{ 0 })) };
+        return ((NO_TTL == ttl) or ((NEVER - now) <= ttl_ticks)) ? NEVER : (now + ttl_ticks);
+    }
+
+    ///
+    /// \brief insertOrUpdate puts the block in, retiring the overflow it replaces. Under the write guard only.
+    /// \details If the block can't be put in, its own overflow's released before the exception's passed on.
+    ///
+    auto insertOrUpdate(NodeKeyType const& key, RecordBlock const& block) noexcept(false) -> void;
+
+    auto makeRecordBlock(
+        core::Span<IPV4Raw const> ipv4s,
+        core::Span<IPV6Raw const> ipv6s
+    ) noexcept(false) -> RecordBlock;
+
+    auto retireRecords(RecordChunk* chain) noexcept(true) -> void;
+    auto reclaimRecords() noexcept(true) -> void;
+
+    ///
+    /// \brief releaseRecords gives the chain back to the pool: one no reader can see, now or ever.
+    ///
+    auto releaseRecords(RecordChunk* chain) noexcept(true) -> void;
+
+    ///
+    /// \brief The Loaded struct is an entry for fill(), wherever it's come from.
+    ///
+    struct Loaded
+    {
+        std::string_view          key;
+        core::Span<IPV4Raw const> ipv4s;
+        core::Span<IPV6Raw const> ipv6s;
+        TTL                       ttl;
+    };
+
+    ///
+    /// \brief fill is restore() and bulkLoad() w/o the source: `entry_at(position)` gives the entry at the
+    /// position, or nothing if it isn't to be cached after all (an expired one).
+    ///
+    template <typename EntryAt>
+    auto fill(
+        core::Size                      entries_number,
+        EntryAt const&                  entry_at,
+        core::Span<std::uint32_t const> ranks
+    ) noexcept(false) -> core::Size;
+
+public:
+    ///
+    /// \param pages is where the nodes go, see core::PageOptions.
+    /// \throws std::logic_error if there's no room for both the window and the main queue, or the negative
+    /// budget is too small to be one.
+    ///
+    BasicDNSCacheImpl(
+        core::Capacity const     capacity,
+        Admission const          admission,
+        core::Capacity const     negative_capacity,
+        StatsCounters* const     counters,
+        core::PageOptions const& pages
+    ) noexcept(false)
+        : window_capacity{ windowCapacity(capacity, admission) }
+        , pages{ pages }
+        , chunks{ makeChunks(capacity + negative_capacity + RETIRING_NODES) }
+        , main_queue{ chunks.front()->nodes.get() + window_capacity,
+                      (window_capacity < capacity) ? (capacity - window_capacity) : 0, nodeLinks() }
+        , dictionary{ makeDictionary(capacity + negative_capacity) }
+        , counters{ counters }
+    {
+        auto const& nodes{ this->chunks.front()->nodes };
+        for (core::Size i{ 0 }; i < RETIRING_NODES; ++i)
+        {
+            this->retiring_nodes[i]           = nodes.get() + capacity + negative_capacity + i;
+            this->retiring_nodes[i]->retiring = true;
+        }
+
+        if (0 != negative_capacity)
+        {
+            this->negative_queue.emplace(nodes.get() + capacity, negative_capacity, this->nodeLinks());
+            for (auto i{ capacity }; i < (capacity + negative_capacity); ++i)
+            { nodes[i].in_negative = true; }
+        }
+
+        if (0 != this->window_capacity)
+        {
+            this->window.emplace(nodes.get(), this->window_capacity, this->nodeLinks());
+            this->frequencies.emplace(capacity);
+
+            for (core::Size i{ 0 }; i < this->window_capacity; ++i)
+            { nodes[i].in_window = true; }
+        }
+    }
+
+    auto size() const noexcept(true) -> core::Capacity
+    { return this->dictionary.size(); }
+
+    [[nodiscard]]
+    auto hugePages() const noexcept(true) -> core::HugePages
+    {
+        auto huge_pages{ core::HugePages::EXPLICIT };
+        for (auto const& chunk : this->chunks)
+        { huge_pages = std::min(huge_pages, chunk->nodes.hugePages()); }
+
+        return huge_pages;
+    }
+
+    [[nodiscard]]
+    auto maxSize() noexcept(true) -> core::Capacity
+    { return (this->main_queue.maxSize() + this->window_capacity); }
+
+    [[nodiscard]]
+    auto footprint() const noexcept(true) -> Footprint
+    {
+        // The replacement policy's two, the expiry wheel's two, and the ordered index' two: the hashed one's
+        // are in its table.
+        constexpr auto index_links{ std::is_same_v<IndexKind, core::OrderedIndex> ? 2 : 0 };
+
+        Footprint footprint{};
+        footprint.node_bytes = sizeof(Node);
+        footprint.link_bytes = (2 + 2 + index_links) * sizeof(typename NodeLinks::Link);
+        for (auto const& chunk : this->chunks)
+        { footprint.nodes += chunk->nodes.size(); }
+
+        footprint.bytes = (footprint.nodes * sizeof(Node)) + this->dictionary.tableBytes();
+        return footprint;
+    }
+
+    ///
+    /// \return The least maxSize() the shard may be resized to: the window, and the main queue's minimum.
+    ///
+    [[nodiscard]]
+    auto minCapacity() const noexcept(true) -> core::Capacity
+    { return (this->window_capacity + DNSReplacement::MINIMAL_VIABLE_CAPACITY); }
+
+public:
+    ///
+    /// \brief update replaces the name's record set, it expires in `ttl` (never if it's NO_TTL).
+    /// \details Reclaims the entries that have expired by now first.
+    /// \throws std::length_error if there are more records of a kind than a RecordBlock can count.
+    ///
+    auto update(
+        FQDN const&               fqdn,
+        core::Span<IPV4Raw const> ipv4s,
+        core::Span<IPV6Raw const> ipv6s,
+        TTL                       ttl
+    ) noexcept(false) -> void;
+
+    ///
+    /// \brief updateNegative replaces the name's entry w/ a negative one, if there's a negative budget.
+    ///
+    auto updateNegative(FQDN const& fqdn, Negative negative, TTL ttl) noexcept(false) -> void;
+
+    ///
+    /// \brief updateBatch makes `ipv4s[i]` the only record of `*fqdns[i]`, all under one write guard.
+    /// \details The lookups are batched first (see DNSDictionary::findOptimisticBatch()): the updates then
+    /// find their paths in the cache. At most BATCH_WIDTH names.
+    /// \throws std::length_error if a name is longer than MAX_FQDN_LENGTH: the names before it are updated.
+    ///
+    auto updateBatch(
+        core::Span<FQDN const* const> fqdns,
+        core::Span<IPV4Raw const>     ipv4s,
+        TTL                           ttl
+    ) noexcept(false) -> void;
+
+    ///
+    /// \brief resize grows or shrinks the main queue towards a maxSize() of `capacity`, by up to `max_nodes`
+    /// nodes; then it hands back the chunks it can, moving up to `max_nodes` entries. Under the shard's lock.
+    /// \details The index grows along w/ the nodes, see DNSDictionary::reserve(). Shrinking evicts from the
+    /// bottom of the main queue. The window and the negative budget stay as they are.
+    /// \return true once it's all done, false if it's to be called again.
+    /// \throws std::logic_error if `capacity` is less than minCapacity(), std::bad_alloc if a chunk or the
+    /// bigger index can't be allocated.
+    ///
+    auto resize(core::Capacity capacity, core::Size max_nodes) noexcept(false) -> bool;
+
+    ///
+    /// \brief enableSuffixIndex starts keeping the names in the label-reversed order as well, w/ the ones
+    /// cached already, or stops. Under the shard's lock.
+    ///
+    auto enableSuffixIndex(bool enabled) noexcept(false) -> void;
+
+    ///
+    /// \brief invalidateSuffix drops `domain`'s entry and those of all the names under it, the negative ones
+    /// included; their nodes are the next ones reused. Under the shard's lock.
+    /// \details W/ the suffix index, the names are found where they are in it, all together; w/o it, every
+    /// entry's checked.
+    /// \return The number of entries dropped.
+    ///
+    auto invalidateSuffix(std::string_view domain) noexcept(true) -> core::Size;
+
+    ///
+    /// \brief find is the lookup for under the shard's mutex. No key is made of `fqdn`, so it doesn't allocate.
+    /// \return The value, or nullopt on a miss: an expired entry or a name too long to be cached included.
+    ///
+    [[nodiscard]]
+    auto find(std::string_view fqdn) noexcept(true) -> std::optional<RecordBlock>;
+
+    ///
+    /// \brief resolveLockFree is the reader's path that doesn't need the shard's mutex.
+    /// \param records receives the value on a HIT. Its overflow is only safe to follow under pinRecords().
+    /// \param expires_at receives the entry's expiry on a HIT, if it isn't null.
+    ///
+    [[nodiscard]]
+    auto resolveLockFree(
+        std::string_view fqdn,
+        RecordBlock&     records,
+        Tick*            expires_at = nullptr
+    ) const noexcept(true) -> ReadStatus;
+
+    ///
+    /// \return The shard's generation: every write changes it, and it's odd while one's in progress.
+    ///
+    [[nodiscard]]
+    auto generation() const noexcept(true) -> core::SeqLock::Sequence
+    { return this->seq_lock.readBegin(); }
+
+    ///
+    /// \brief resolveLockFreeBatch is resolveLockFree for up to BATCH_WIDTH names, w/ the lookups interleaved.
+    /// \details One seqlock section for all of them: if the writers keep interfering, they're all CONTENDED.
+    ///
+    auto resolveLockFreeBatch(
+        core::Span<FQDN const* const> fqdns,
+        core::Span<RecordBlock>       records,
+        core::Span<ReadStatus>        statuses
+    ) const noexcept(true) -> void;
+
+    ///
+    /// \brief save adds the live entries to the writer's run in the index' order, then ranks them from the
+    /// next victim up: the window's first, if there's one. Under the shard's lock.
+    ///
+    auto save(snapshot::Writer& writer) const noexcept(false) -> void;
+
+    ///
+    /// \brief restore fills the empty shard w/ its entries of a snapshot, all into the main queue.
+    /// \param entries are the shard's entries in the index' order, `ranks` the positions in `entries` from
+    /// the next victim up. If there are more than the main queue holds, the lowest ranked are left out.
+    /// \param age is how old the snapshot is: the TTLs that ran out meanwhile are left out, too.
+    /// \details One pass over the entries in order fills the nodes, then the queue is relinked in the ranks'
+    /// order and the index is rebuilt at once (w/o sorting, if the entries come in the index' order).
+    /// \return The number of entries restored.
+    /// \throws std::logic_error if the shard isn't empty.
+    ///
+    auto restore(
+        snapshot::Reader const&         reader,
+        core::Span<std::uint32_t const> entries,
+        core::Span<std::uint32_t const> ranks,
+        TTL                             age
+    ) noexcept(false) -> core::Size;
+
+    ///
+    /// \brief bulkLoad fills the empty shard w/ its records of a bulk load, all into the main queue.
+    /// \param records are the shard's records in the text's order.
+    /// \details See DNSCache::bulkLoad(): the records of a name are gathered, then it's the same as restore().
+    /// \return The number of names cached.
+    /// \throws std::logic_error if the shard isn't empty.
+    ///
+    auto bulkLoad(
+        std::string_view                    text,
+        core::Span<bulk_load::Record const> records,
+        TTL                                 ttl,
+        BulkPriority const&                 priority
+    ) noexcept(false) -> core::Size;
+
+    ///
+    /// \brief pinRecords keeps the overflowing records seen from now on from being reused.
+    ///
+    [[nodiscard]]
+    auto pinRecords() const noexcept(true) -> core::EpochDomain::Guard
+    { return this->records_domain.enter(); }
+
+    BasicDNSCacheImpl& operator = (BasicDNSCacheImpl const&) = delete;
+    BasicDNSCacheImpl& operator = (BasicDNSCacheImpl&&)      = delete;
+    BasicDNSCacheImpl(BasicDNSCacheImpl const&)              = delete;
+    BasicDNSCacheImpl(BasicDNSCacheImpl&&)                   = delete;
+
+    ~BasicDNSCacheImpl() noexcept(true)
+    {}
+
+}; // DNSCache::BasicDNSCacheImpl
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::admit() noexcept(false) -> Node*
+{
+    auto candidate{ this->window->releaseBottom() };
+    if (not candidate->indexed)
+    { return candidate; }
+
+    auto victim{ this->main_queue.releaseBottom() };
+    if ((not victim->indexed) or
+        (this->frequencies->estimate(keyHash(victim->first)) <
+         this->frequencies->estimate(keyHash(candidate->first))))
+    {
+        // Admitted: the candidate moves on to the main queue, the victim's node goes to the window.
+        candidate->in_window = false;
+        (void)this->main_queue.promote(candidate, DNSReplacement::TO_TOP);
+        this->count(Counter::PROMOTIONS_TO_TOP);
+        return victim;
+    }
+
+    // Rejected: the main queue's victim stays where it was.
+    (void)this->main_queue.demote(victim, DNSReplacement::TO_BOTTOM);
+    return candidate;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::allocate() noexcept(false) -> Node*
+{
+    auto node{
+        this->pending_negative ? this->negative_queue->releaseBottom()
+                               : (this->window.has_value() ? this->admit() : this->main_queue.releaseBottom())
+    };
+
+    if (node->indexed)
+    {
+        this->unindex(node);
+        this->count(Counter::EVICTIONS);
+    }
+
+    // A lock-free reader may still be comparing against the evicted key.
+    if (not this->epoch_domain.isSafe(node->retired_at))
+    { node = this->retire(node); }
+
+    return node;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::retire(Node* node) noexcept(true) -> Node*
+{
+    // The ring's in the retiring order: if the oldest one isn't safe, none is. It takes two advances at most.
+    auto& oldest{ this->retiring_nodes[this->retiring_head] };
+    while (not this->epoch_domain.isSafe(oldest->retired_at))
+    {
+        if (not this->epoch_domain.tryAdvance())
+        { break; }
+    }
+
+    if (not this->epoch_domain.isSafe(oldest->retired_at))
+    {
+        this->epoch_domain.synchronize();
+        return node;
+    }
+
+    auto const reused{ oldest };
+    reused->retiring    = false;
+    reused->in_negative = node->in_negative;
+
+    node->retiring      = true;
+    oldest              = node;
+    this->retiring_head = (this->retiring_head + 1) % RETIRING_NODES;
+    return reused;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::replaceRetiring(Node* from, Node* to) noexcept(true) -> void
+{
+    *std::find(this->retiring_nodes.begin(), this->retiring_nodes.end(), from) = to;
+
+    // `to`'s own retirement's as old as its parking, at least: it's only reused once that's safe.
+    to->parked     = false;
+    to->retiring   = true;
+    from->retiring = false;
+    from->parked   = true;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::onCreate(Node* created_node) noexcept(true)
+    -> core::CreateOrUpdateStatus
+{
+    if (nullptr == created_node)
+    { return core::CreateOrUpdateStatus::FATAL_ERROR; }
+
+    // The new names start in the window, if there's one.
+    created_node->in_window = this->window.has_value() and not created_node->in_negative;
+    auto promoting_status{ this->queueOf(created_node).promote(created_node, DNSReplacement::TO_TOP) };
+    if (DNSReplacement::PromotingStatus::ERROR == promoting_status)
+    { return core::CreateOrUpdateStatus::FATAL_ERROR; }
+
+    created_node->indexed = true;
+    this->indexSuffix(created_node);
+    this->setExpiry(created_node);
+    this->count(Counter::INSERTS);
+    this->count(Counter::PROMOTIONS_TO_TOP);
+    return core::CreateOrUpdateStatus::SUCCESS;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::onUpdate(Node* updated_node) noexcept(true)
+    -> core::CreateOrUpdateStatus
+{
+    if (nullptr == updated_node)
+    { return core::CreateOrUpdateStatus::FATAL_ERROR; }
+
+    auto promoting_status{ this->queueOf(updated_node).promote(updated_node, DNSReplacement::ONE_UP) };
+    if (DNSReplacement::PromotingStatus::ERROR == promoting_status)
+    { return core::CreateOrUpdateStatus::FATAL_ERROR; }
+
+    this->setExpiry(updated_node);
+    this->count(Counter::PROMOTIONS_ONE_UP);
+    this->count(Counter::UPDATES);
+    return core::CreateOrUpdateStatus::SUCCESS;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::unindex(Node* node) noexcept(true) -> void
+{
+    this->dictionary.erase(node->first);
+    if (this->suffix_index.has_value())
+    { (void)this->suffix_index->erase(ReversedName{ node->first.view() }); }
+
+    this->retireRecords(node->second.overflow);
+    this->expiry_wheel.cancel(node);
+
+    node->indexed    = false;
+    node->retired_at = this->epoch_domain.retireStamp();
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::indexSuffix(Node* node) noexcept(true) -> void
+{
+    if (not this->suffix_index.has_value())
+    { return; }
+
+    auto const& chunk{ this->chunkOf(node) };
+    this->pending_suffix = chunk.suffixes.get() + (node->slot - chunk.first_slot);
+    this->suffix_index->insertOrUpdate(ReversedName{ node->first.view() }, node);
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::rebuildSuffixIndex() noexcept(false) -> void
+{
+    std::vector<SuffixNode*> suffix_nodes;
+    suffix_nodes.reserve(this->dictionary.size());
+
+    for (auto const& chunk : this->chunks)
+    {
+        for (core::Size i{ 0 }; i < chunk->nodes.size(); ++i)
+        {
+            if (auto node{ chunk->nodes.get() + i };
+                node->indexed)
+            {
+                auto suffix_node{ chunk->suffixes.get() + i };
+                suffix_node->first  = ReversedName{ node->first.view() };
+                suffix_node->second = node;
+                suffix_nodes.push_back(suffix_node);
+            }
+        }
+    }
+
+    this->suffix_index->rebuild(suffix_nodes);
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::enableSuffixIndex(bool const enabled) noexcept(false) -> void
+{
+    if (not enabled)
+    {
+        this->suffix_index.reset();
+        for (auto& chunk : this->chunks)
+        { chunk->suffixes.reset(); }
+
+        return;
+    }
+
+    if (this->suffix_index.has_value())
+    { return; }
+
+    for (auto& chunk : this->chunks)
+    { chunk->suffixes = std::make_unique<SuffixNode[]>(chunk->nodes.size()); }
+
+    this->suffix_index.emplace(this->slotsNumber(), SuffixPolicy{ this });
+    this->rebuildSuffixIndex();
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::invalidateSuffix(std::string_view const domain) noexcept(true)
+    -> core::Size
+{
+    auto const drop{
+        [this] (Node* node)
+        {
+            this->unindex(node);
+            (void)this->queueOf(node).demote(node, DNSReplacement::TO_BOTTOM);
+        } // lambda
+    };
+
+    core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+
+    core::Size dropped{ 0 };
+    if (this->suffix_index.has_value())
+    {
+        // The domain's names are the first ones from its bound on: dropping one makes the next the first.
+        for (auto suffix_node{ this->suffix_index->lowerBound(ReversedName{ domain }) };
+             (nullptr != suffix_node) and isUnderDomain(suffix_node->first.name, domain);
+             suffix_node = this->suffix_index->lowerBound(ReversedName{ domain }))
+        {
+            drop(suffix_node->second);
+            ++dropped;
+        }
+
+        return dropped;
+    }
+
+    this->forEachNode(
+        [&] (Node* node)
+        {
+            if (node->indexed and isUnderDomain(node->first.view(), domain))
+            {
+                drop(node);
+                ++dropped;
+            }
+        } // lambda
+    );
+
+    return dropped;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::resize(core::Capacity const capacity, core::Size const max_nodes)
+    noexcept(false) -> bool
+{
+    if (capacity < this->minCapacity())
+    { throw std::logic_error{ "BadArgs" }; }
+
+    auto const size{ this->maxSize() };
+    if (size < capacity)
+    {
+        this->grow(std::min(capacity - size, max_nodes));
+        return (this->maxSize() == capacity);
+    }
+
+    if (capacity < size)
+    {
+        this->shrink(std::min(size - capacity, max_nodes));
+        return false;
+    }
+
+    return this->releaseChunks(max_nodes);
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::grow(core::Size const nodes_number) noexcept(false) -> void
+{
+    auto const capacity{ this->maxSize() + nodes_number };
+    {
+        core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+        this->dictionary.reserve(capacity + this->negativeCapacity());
+    }
+
+    auto const parked{ std::min(nodes_number, this->parked_nodes.size()) };
+
+    // Everything that may throw goes first: then the queue's extended w/ all the nodes or none.
+    std::unique_ptr<Chunk> chunk{};
+    if (parked < nodes_number)
+    {
+        chunk = std::make_unique<Chunk>(nodes_number - parked, this->pages);
+        if (this->suffix_index.has_value())
+        { chunk->suffixes = std::make_unique<SuffixNode[]>(chunk->nodes.size()); }
+
+        this->chunks.reserve(this->chunks.size() + 1);
+        chunk->number(this->slots);
+    }
+
+    std::vector<Node*> added;
+    added.reserve(nodes_number);
+
+    // The parked nodes are mapped already.
+    for (core::Size i{ 0 }; i < parked; ++i)
+    {
+        auto const node{ this->parked_nodes.back() };
+        this->parked_nodes.pop_back();
+
+        node->parked    = false;
+        node->in_window = false;
+        added.push_back(node);
+    }
+
+    if (nullptr != chunk)
+    {
+        for (core::Size i{ 0 }; i < chunk->nodes.size(); ++i)
+        { added.push_back(chunk->nodes.get() + i); }
+
+        this->chunks.push_back(std::move(chunk));
+    }
+
+    // W/o the write guard: the readers never follow the queues' links.
+    this->main_queue.extend(added);
+
+    if (this->suffix_index.has_value())
+    { this->suffix_index->reserve(this->slotsNumber()); }
+
+    this->slots.reclaimRetired([this] () { this->epoch_domain.synchronize(); });
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::shrink(core::Size const nodes_number) noexcept(false) -> void
+{
+    this->parked_nodes.reserve(this->parked_nodes.size() + nodes_number);
+
+    core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+    for (core::Size i{ 0 }; i < nodes_number; ++i)
+    {
+        auto const node{ this->main_queue.shed() };
+        if (node->indexed)
+        {
+            this->unindex(node);
+            this->count(Counter::EVICTIONS);
+        }
+
+        node->parked = true;
+        this->parked_nodes.push_back(node);
+    }
+
+    this->dictionary.reserve(this->maxSize() + this->negativeCapacity());
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::releaseChunks(core::Size max_nodes) noexcept(false) -> bool
+{
+    // The constructor's chunk has the window's and the negative budget's nodes: it stays.
+    while ((1 < this->chunks.size()) and (this->chunks.back()->nodes.size() <= this->parked_nodes.size()))
+    {
+        auto const& chunk{ *(this->chunks.back()) };
+
+        // There are enough of these for the chunk's nodes that aren't parked.
+        std::vector<Node*> elsewhere;
+        elsewhere.reserve(this->parked_nodes.size());
+        std::copy_if(this->parked_nodes.begin(), this->parked_nodes.end(), std::back_inserter(elsewhere),
+                     [&chunk] (Node const* node) { return not chunk.holds(node); });
+
+        {
+            core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+            for (core::Size i{ 0 }; (i < chunk.nodes.size()) and (0 != max_nodes); ++i)
+            {
+                if (auto const node{ chunk.nodes.get() + i };
+                    not node->parked)
+                {
+                    if (node->retiring)
+                    { this->replaceRetiring(node, elsewhere.back()); }
+                    else
+                    { this->relocate(node, elsewhere.back()); }
+
+                    elsewhere.pop_back();
+                    --max_nodes;
+                }
+            }
+        }
+
+        auto const left{
+            std::any_of(chunk.nodes.get(), chunk.nodes.get() + chunk.nodes.size(),
+                        [] (Node const& node) { return not node.parked; })
+        };
+
+        if (left)
+        {
+            // Out of the budget: the chunk's parked nodes stay parked for the next call.
+            for (core::Size i{ 0 }; i < chunk.nodes.size(); ++i)
+            {
+                if (chunk.nodes[i].parked)
+                { elsewhere.push_back(chunk.nodes.get() + i); }
+            }
+
+            this->parked_nodes = std::move(elsewhere);
+            return false;
+        }
+
+        this->parked_nodes = std::move(elsewhere);
+        this->slots.truncate(chunk.first_slot);
+
+        // A lock-free reader may still be looking at a node that's been moved.
+        this->epoch_domain.synchronize();
+        this->chunks.pop_back();
+    }
+
+    if (this->suffix_index.has_value())
+    { this->suffix_index->reserve(this->slotsNumber()); }
+
+    return true;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::relocate(Node* from, Node* to) noexcept(true) -> void
+{
+    // A lock-free reader may still be comparing against the key `to` had.
+    if (not this->epoch_domain.isSafe(to->retired_at))
+    { this->epoch_domain.synchronize(); }
+
+    to->parked    = false;
+    to->in_window = from->in_window;
+    this->queueOf(from).replace(from, to);
+
+    if (from->indexed)
+    {
+        to->first      = from->first;
+        to->second     = from->second; // The overflow goes along: it isn't retired.
+        to->expires_at = from->expires_at;
+        (void)this->dictionary.replace(from, to);
+
+        if (this->suffix_index.has_value())
+        { (void)this->suffix_index->erase(ReversedName{ from->first.view() }); }
+
+        this->indexSuffix(to);
+
+        if (ExpiryWheel::isScheduled(from))
+        {
+            this->expiry_wheel.cancel(from);
+            this->expiry_wheel.schedule(to, to->expires_at);
+        }
+
+        to->indexed   = true;
+        from->indexed = false;
+    }
+
+    from->parked     = true;
+    from->retired_at = this->epoch_domain.retireStamp();
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::setExpiry(Node* node) noexcept(true) -> void
+{
+    node->expires_at = this->pending_expires_at;
+
+    if (NEVER != node->expires_at)
+    { this->expiry_wheel.schedule(node, node->expires_at); }
+    else
+    { this->expiry_wheel.cancel(node); }
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::reclaimExpired(Tick const now) noexcept(true) -> void
+{
+    this->expiry_wheel.advance(
+        now,
+        [this] (Node* expired_node)
+        {
+            this->unindex(expired_node);
+            (void)this->queueOf(expired_node).demote(expired_node, DNSReplacement::TO_BOTTOM);
+            this->count(Counter::EXPIRATIONS);
+        } // lambda
+    );
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::makeRecordBlock(
+    core::Span<IPV4Raw const> ipv4s,
+    core::Span<IPV6Raw const> ipv6s
+) noexcept(false) -> RecordBlock
+{
+    constexpr core::Size MAX_RECORDS{ std::numeric_limits<decltype(RecordBlock::ipv4_number)>::max() };
+    if ((MAX_RECORDS < ipv4s.size()) or (MAX_RECORDS < ipv6s.size()))
+    { throw std::length_error{ "Too many records!" }; }
+
+    this->reclaimRecords();
+
+    RecordBlock block{};
+    block.ipv4_number = static_cast<decltype(block.ipv4_number)>(ipv4s.size());
+    block.ipv6_number = static_cast<decltype(block.ipv6_number)>(ipv6s.size());
+
+    auto const inline_ipv4{ std::min(ipv4s.size(), RecordBlock::IPV4_RECORDS) };
+    auto const inline_ipv6{ std::min(ipv6s.size(), RecordBlock::IPV6_RECORDS) };
+    std::copy_n(ipv4s.begin(), inline_ipv4, block.ipv4.begin());
+    std::copy_n(ipv6s.begin(), inline_ipv6, block.ipv6.begin());
+
+    auto const chunksFor{
+        [] (core::Size records, core::Size per_chunk) -> core::Size
+        { return (records + per_chunk - 1) / per_chunk; }
+    };
+    auto const chunks_number{
+        std::max(chunksFor(ipv4s.size() - inline_ipv4, RecordChunk::IPV4_RECORDS),
+                 chunksFor(ipv6s.size() - inline_ipv6, RecordChunk::IPV6_RECORDS))
+    };
+
+    // The chunks linked so far are given back if the pool can't grow: no one else knows of them.
+    auto link{ &(block.overflow) };
+    for (core::Size i{ 0 }; i < chunks_number; ++i)
+    {
+        RecordChunk* chunk{ nullptr };
+        try
+        {
+            chunk = this->records_pool.allocate();
+        }
+        catch (...)
+        {
+            this->releaseRecords(block.overflow);
+            throw;
+        }
+
+        auto const ipv4_offset{ std::min(ipv4s.size(), inline_ipv4 + (i * RecordChunk::IPV4_RECORDS)) };
+        auto const ipv6_offset{ std::min(ipv6s.size(), inline_ipv6 + (i * RecordChunk::IPV6_RECORDS)) };
+        std::copy_n(ipv4s.begin() + ipv4_offset,
+                    std::min(ipv4s.size() - ipv4_offset, RecordChunk::IPV4_RECORDS),
+                    chunk->ipv4.begin());
+        std::copy_n(ipv6s.begin() + ipv6_offset,
+                    std::min(ipv6s.size() - ipv6_offset, RecordChunk::IPV6_RECORDS),
+                    chunk->ipv6.begin());
+
+        chunk->next = nullptr;
+        *link       = chunk;
+        link        = &(chunk->next);
+    }
+
+    return block;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::retireRecords(RecordChunk* chain) noexcept(true) -> void
+{
+    if (nullptr == chain)
+    { return; }
+
+    chain->retired_at   = this->records_domain.retireStamp();
+    chain->next_retired = nullptr;
+
+    if (nullptr != this->retired_records_tail)
+    { this->retired_records_tail->next_retired = chain; }
+    else
+    { this->retired_records_head = chain; }
+
+    this->retired_records_tail = chain;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::reclaimRecords() noexcept(true) -> void
+{
+    if (nullptr == this->retired_records_head)
+    { return; }
+
+    // Never waits for the readers: what isn't safe yet stays for the next time, and the pool grows meanwhile.
+    (void)this->records_domain.tryAdvance();
+
+    while ((nullptr != this->retired_records_head) and
+           this->records_domain.isSafe(this->retired_records_head->retired_at))
+    {
+        auto chain{ this->retired_records_head };
+        this->retired_records_head = chain->next_retired;
+        if (nullptr == this->retired_records_head)
+        { this->retired_records_tail = nullptr; }
+
+        this->releaseRecords(chain);
+    }
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::releaseRecords(RecordChunk* chain) noexcept(true) -> void
+{
+    while (nullptr != chain)
+    {
+        auto const next{ chain->next };
+        this->records_pool.release(chain);
+        chain = next;
+    }
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::update(
+    FQDN const&               fqdn,
+    core::Span<IPV4Raw const> ipv4s,
+    core::Span<IPV6Raw const> ipv6s,
+    TTL                       ttl
+) noexcept(false) -> void
+{
+    NodeKeyType const key{ fqdn };
+    auto const block{ this->makeRecordBlock(ipv4s, ipv6s) };
+
+    auto const now{ nowTick() };
+    this->pending_expires_at = expiresAt(now, ttl);
+
+    if (this->frequencies.has_value())
+    { this->frequencies->increment(keyHash(key)); }
+
+    core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+    this->reclaimExpired(now);
+    this->insertOrUpdate(key, block);
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::updateNegative(
+    FQDN const&    fqdn,
+    Negative const negative,
+    TTL const      ttl
+) noexcept(false) -> void
+{
+    NodeKeyType const key{ fqdn };
+    if (not this->negative_queue.has_value())
+    { return; }
+
+    RecordBlock block{};
+    block.negative = negative;
+
+    auto const now{ nowTick() };
+    this->pending_expires_at = expiresAt(now, std::min(ttl, MAX_NEGATIVE_TTL));
+
+    if (this->frequencies.has_value())
+    { this->frequencies->increment(keyHash(key)); }
+
+    core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+    this->reclaimExpired(now);
+    this->insertOrUpdate(key, block);
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::updateBatch(
+    core::Span<FQDN const* const> fqdns,
+    core::Span<IPV4Raw const>     ipv4s,
+    TTL                           ttl
+) noexcept(false) -> void
+{
+    std::array<NodeKeyType, BATCH_WIDTH> keys;
+    auto const width{ std::min(fqdns.size(), BATCH_WIDTH) };
+    for (core::Size i{ 0 }; i < width; ++i)
+    {
+        keys[i].assign(*fqdns[i]);
+        if (this->frequencies.has_value())
+        { this->frequencies->increment(keyHash(keys[i])); }
+    }
+
+    auto const now{ nowTick() };
+    this->pending_expires_at = expiresAt(now, ttl);
+
+    core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+    this->reclaimExpired(now);
+
+    // Only warms the caches: every update may move the nodes the next ones would have found.
+    std::array<Node const*, BATCH_WIDTH> found;
+    this->dictionary.findOptimisticBatch(core::Span<NodeKeyType const>{ keys.data(), width },
+                                         core::Span<Node const*>{ found.data(), width });
+
+    for (core::Size i{ 0 }; i < width; ++i)
+    { this->insertOrUpdate(keys[i], this->makeRecordBlock(ipv4s.subspan(i, 1), {})); }
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::insertOrUpdate(
+    NodeKeyType const& key,
+    RecordBlock const& block
+) noexcept(false) -> void
+{
+    // The replaced overflow is immutable: it's retired as a whole once the new block is in place.
+    auto const replaced{ this->dictionary.findOptimistic(key) };
+    auto replaced_overflow{ (nullptr != replaced) ? replaced->second.overflow : nullptr };
+
+    // A positive entry can't take a negative one's node or the other way round: the old one's dropped,
+    // and its node's the next to be reused in its queue.
+    this->pending_negative = (Negative::NONE != block.negative);
+    if ((nullptr != replaced) and (this->pending_negative != replaced->in_negative))
+    {
+        auto const node{ this->dictionary.find(key) }; // W/o the const.
+        this->unindex(node);
+        (void)this->queueOf(node).demote(node, DNSReplacement::TO_BOTTOM);
+        replaced_overflow = nullptr;
+    }
+
+    // Nothing's changed in the dictionary if it throws, so the block's overflow is still no one else's.
+    try
+    {
+        this->dictionary.insertOrUpdate(key, block);
+    }
+    catch (...)
+    {
+        this->releaseRecords(block.overflow);
+        throw;
+    }
+
+    this->retireRecords(replaced_overflow);
+
+    // The tables a grown hashed index has migrated from: it only happens once per resize().
+    this->dictionary.reclaimRetired([this] () { this->epoch_domain.synchronize(); });
+}
+
+template <template <typename, typename> class Replacement>
+[[nodiscard]]
+auto DNSCache::BasicDNSCacheImpl<Replacement>::find(std::string_view const fqdn) noexcept(true)
+    -> std::optional<RecordBlock>
+{
+    // No key that long is ever cached, and it wouldn't fit a NodeKeyType anyway.
+    auto const node{ NodeKeyType::fits(fqdn) ? this->dictionary.find(fqdn) : nullptr };
+    if ((nullptr == node) or isExpired(node->expires_at))
+    {
+        this->count(Counter::MISSES);
+        return std::nullopt;
+    }
+
+    this->count((Negative::NONE == node->second.negative) ? Counter::HITS : Counter::NEGATIVE_HITS);
+    return node->second;
+}
+
+template <template <typename, typename> class Replacement>
+[[nodiscard]]
+auto DNSCache::BasicDNSCacheImpl<Replacement>::resolveLockFree(
+    std::string_view const fqdn,
+    RecordBlock&           records,
+    Tick* const            expires_at
+) const noexcept(true) -> ReadStatus
+{
+    if (not NodeKeyType::fits(fqdn))
+    {
+        this->count(Counter::MISSES);
+        return ReadStatus::MISS;
+    }
+
+    if (this->frequencies.has_value())
+    { this->frequencies->increment(keyHash(fqdn)); }
+
+    for (core::Size attempt{ 0 }; attempt < LOCK_FREE_READ_ATTEMPTS; ++attempt)
+    {
+        auto const epoch_guard{ this->epoch_domain.enter() };
+
+        auto const sequence{ this->seq_lock.readBegin() };
+        if (core::SeqLock::isWriting(sequence))
+        { continue; }
+
+        auto const node{ this->dictionary.findOptimistic(fqdn) };
+        auto const value{ (nullptr != node) ? core::racyCopy(node->second) : NodeValueType{} };
+        auto const node_expires_at{ (nullptr != node) ? core::racyLoad(node->expires_at) : NEVER };
+
+        if (this->seq_lock.readRetry(sequence))
+        { continue; }
+
+        if ((nullptr == node) or isExpired(node_expires_at))
+        {
+            this->count(Counter::MISSES);
+            return ReadStatus::MISS;
+        }
+
+        DNSReplacement::reference(node);
+        this->count((Negative::NONE == value.negative) ? Counter::HITS : Counter::NEGATIVE_HITS);
+
+        records = value;
+        if (nullptr != expires_at)
+        { *expires_at = node_expires_at; }
+
+        return ReadStatus::HIT;
+    }
+
+    return ReadStatus::CONTENDED;
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::resolveLockFreeBatch(
+    core::Span<FQDN const* const> fqdns,
+    core::Span<RecordBlock>       records,
+    core::Span<ReadStatus>        statuses
+) const noexcept(true) -> void
+{
+    // The names that can be cached at all are looked up, `positions` maps them back.
+    std::array<NodeKeyType, BATCH_WIDTH> keys;
+    std::array<core::Size, BATCH_WIDTH>  positions;
+    core::Size                           keys_number{ 0 };
+    for (core::Size i{ 0 }; i < std::min(fqdns.size(), BATCH_WIDTH); ++i)
+    {
+        if (not NodeKeyType::fits(*fqdns[i]))
+        {
+            statuses[i] = ReadStatus::MISS;
+            this->count(Counter::MISSES);
+            continue;
+        }
+
+        statuses[i] = ReadStatus::CONTENDED;
+        keys[keys_number].assign(*fqdns[i]);
+        positions[keys_number] = i;
+
+        if (this->frequencies.has_value())
+        { this->frequencies->increment(keyHash(keys[keys_number])); }
+
+        ++keys_number;
+    }
+
+    if (0 == keys_number)
+    { return; }
+
+    std::array<Node const*, BATCH_WIDTH> found;
+    std::array<Tick, BATCH_WIDTH>        expires_at;
+    for (core::Size attempt{ 0 }; attempt < LOCK_FREE_READ_ATTEMPTS; ++attempt)
+    {
+        auto const epoch_guard{ this->epoch_domain.enter() };
+
+        auto const sequence{ this->seq_lock.readBegin() };
+        if (core::SeqLock::isWriting(sequence))
+        { continue; }
+
+        this->dictionary.findOptimisticBatch(core::Span<NodeKeyType const>{ keys.data(), keys_number },
+                                             core::Span<Node const*>{ found.data(), keys_number });
+
+        for (core::Size k{ 0 }; k < keys_number; ++k)
+        {
+            auto const node{ found[k] };
+            records[positions[k]] = (nullptr != node) ? core::racyCopy(node->second) : NodeValueType{};
+            expires_at[k]         = (nullptr != node) ? core::racyLoad(node->expires_at) : NEVER;
+        }
+
+        if (this->seq_lock.readRetry(sequence))
+        { continue; }
+
+        auto const now{ nowTick() };
+        for (core::Size k{ 0 }; k < keys_number; ++k)
+        {
+            if ((nullptr == found[k]) or isExpired(expires_at[k], now))
+            {
+                statuses[positions[k]] = ReadStatus::MISS;
+                this->count(Counter::MISSES);
+                continue;
+            }
+
+            DNSReplacement::reference(found[k]);
+            statuses[positions[k]] = ReadStatus::HIT;
+            this->count((Negative::NONE == records[positions[k]].negative) ? Counter::HITS
+                                                                           : Counter::NEGATIVE_HITS);
+        }
+
+        return;
+    }
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::save(snapshot::Writer& writer) const noexcept(false) -> void
+{
+    constexpr std::uint32_t UNSAVED{ std::numeric_limits<std::uint32_t>::max() };
+
+    auto const now{ nowTick() };
+    std::vector<std::uint32_t> positions(this->slotsNumber(), UNSAVED);
+    this->dictionary.forEach(
+        [&] (Node const* node)
+        {
+            // The negative entries are short-lived anyway.
+            if (isExpired(node->expires_at, now) or (Negative::NONE != node->second.negative))
+            { return; }
+
+            auto const ttl_ms{ (NEVER == node->expires_at) ? snapshot::NEVER_EXPIRES
+                                                           : static_cast<std::int64_t>(node->expires_at - now) };
+            positions[node->slot] = writer.add(node->first.view(), node->second, ttl_ms);
+        } // lambda
+    );
+
+    auto const rank{
+        [&] (Node const* node)
+        {
+            if (auto const position{ positions[node->slot] };
+                UNSAVED != position)
+            { writer.rank(position); }
+        } // lambda
+    };
+
+    if (this->window.has_value())
+    { this->window->forEachFromBottom(rank); }
+
+    this->main_queue.forEachFromBottom(rank);
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::restore(
+    snapshot::Reader const&         reader,
+    core::Span<std::uint32_t const> entries,
+    core::Span<std::uint32_t const> ranks,
+    TTL                             age
+) noexcept(false) -> core::Size
+{
+    auto const entryAt{
+        [&] (core::Size const position) -> std::optional<Loaded>
+        {
+            auto const& entry{ reader.entries()[entries[position]] };
+
+            auto ttl{ NO_TTL };
+            if (snapshot::NEVER_EXPIRES != entry.ttl_ms)
+            {
+                ttl = TTL{ entry.ttl_ms } - age;
+                if (TTL::zero() >= ttl)
+                { return std::nullopt; }
+            }
+
+            return Loaded{ reader.key(entry), reader.ipv4s(entry), reader.ipv6s(entry), ttl };
+        } // lambda
+    };
+
+    return this->fill(entries.size(), entryAt, ranks);
+}
+
+template <template <typename, typename> class Replacement>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::bulkLoad(
+    std::string_view                    text,
+    core::Span<bulk_load::Record const> records,
+    TTL                                 ttl,
+    BulkPriority const&                 priority
+) noexcept(false) -> core::Size
+{
+    if (0 != this->dictionary.size())
+    { throw std::logic_error{ "Not empty!" }; }
+
+    if (std::numeric_limits<std::uint32_t>::max() < records.size())
+    { throw std::length_error{ "Too many records in a shard!" }; }
+
+    // By name, then in the text's order: a name's records keep the order they're given in. Sorted by 8 bytes
+    // of the names at a time (big-endian, so they compare as the names do), the ties by the next 8 bytes:
+    // every name's read once per level, rather than at every comparison.
+    struct Sortable
+    {
+        std::uint64_t digit;
+        std::uint32_t record;
+    };
+
+    struct Run
+    {
+        core::Size begin;
+        core::Size end;
+        core::Size offset;
+    };
+
+    auto const nameAt{
+        [&] (std::uint32_t const record) { return bulk_load::nameOf(text, records[record]); }
+    };
+
+    std::vector<Sortable> order(records.size());
+    for (std::uint32_t i{ 0 }; i < records.size(); ++i)
+    { order[i].record = i; }
+
+    std::vector<Run> runs{ Run{ 0, order.size(), 0 } };
+    while (not runs.empty())
+    {
+        auto const run{ runs.back() };
+        runs.pop_back();
+
+        for (auto i{ run.begin }; i < run.end; ++i)
+        {
+            auto const key{ nameAt(order[i].record) };
+            std::uint64_t digit{ 0 };
+            for (auto k{ run.offset }; k < (run.offset + sizeof(digit)); ++k)
+            { digit = (digit << 8) | ((k < key.size()) ? static_cast<std::uint8_t>(key[k]) : 0); }
+
+            order[i].digit = digit;
+        }
+
+        std::sort(order.begin() + run.begin, order.begin() + run.end,
+                  [] (Sortable const& lhs, Sortable const& rhs)
+                  { return (lhs.digit < rhs.digit) or ((lhs.digit == rhs.digit) and (lhs.record < rhs.record)); });
+
+        // Once no name of a tie has more bytes, they're all the same name.
+        auto const offset{ run.offset + sizeof(std::uint64_t) };
+        for (auto begin{ run.begin }, end{ run.begin }; begin < run.end; begin = end)
+        {
+            auto longer{ false };
+            while ((end < run.end) and (order[begin].digit == order[end].digit))
+            {
+                longer = longer or (offset < records[order[end].record].name_length);
+                ++end;
+            }
+
+            if ((1 < (end - begin)) and longer)
+            { runs.push_back(Run{ begin, end, offset }); }
+        }
+    }
+
+    struct Name
+    {
+        std::string_view key;
+        core::Size       ipv4_begin;
+        core::Size       ipv6_begin;
+        TTL              ttl;
+        std::uint32_t    last_record;
+    };
+
+    constexpr core::Size MAX_RECORDS{ std::numeric_limits<decltype(RecordBlock::ipv4_number)>::max() };
+
+    std::vector<Name>    names;
+    std::vector<IPV4Raw> ipv4s;
+    std::vector<IPV6Raw> ipv6s;
+    names.reserve(records.size());
+    ipv4s.reserve(records.size());
+
+    for (core::Size i{ 0 }; i < order.size(); )
+    {
+        Name name{ nameAt(order[i].record), ipv4s.size(), ipv6s.size(), NO_TTL, 0 };
+        for (; (i < order.size()) and (nameAt(order[i].record) == name.key); ++i)
+        {
+            auto const& record{ records[order[i].record] };
+            name.ttl         = std::min(name.ttl, (bulk_load::DEFAULT_TTL == record.ttl_ms) ? ttl
+                                                                                          : TTL{ record.ttl_ms });
+            name.last_record = order[i].record;
+
+            // The records past what a RecordBlock counts are dropped rather than failing the whole load.
+            if (record.ipv6 and ((ipv6s.size() - name.ipv6_begin) < MAX_RECORDS))
+            { ipv6s.push_back(record.address); }
+            else if (not record.ipv6 and ((ipv4s.size() - name.ipv4_begin) < MAX_RECORDS))
+            { ipv4s.push_back(record.ipv4()); }
+        }
+
+        names.push_back(name);
+    }
+
+    // From the next victim up, by the last record: a name per record at most, so the records' order is
+    // the names' w/o sorting. By the priority first, if there's one.
+    constexpr std::uint32_t NO_NAME{ std::numeric_limits<std::uint32_t>::max() };
+    std::vector<std::uint32_t> ranks(records.size(), NO_NAME);
+    for (std::uint32_t position{ 0 }; position < names.size(); ++position)
+    { ranks[names[position].last_record] = position; }
+
+    ranks.erase(std::remove(ranks.begin(), ranks.end(), NO_NAME), ranks.end());
+
+    if (priority)
+    {
+        std::vector<std::uint64_t> priorities(names.size());
+        for (core::Size i{ 0 }; i < names.size(); ++i)
+        { priorities[i] = priority(names[i].key); }
+
+        std::stable_sort(ranks.begin(), ranks.end(),
+                         [&] (std::uint32_t const lhs, std::uint32_t const rhs)
+                         { return priorities[lhs] < priorities[rhs]; });
+    }
+
+    auto const entryAt{
+        [&] (core::Size const position) -> std::optional<Loaded>
+        {
+            auto const& name{ names[position] };
+            if (TTL::zero() >= name.ttl)
+            { return std::nullopt; }
+
+            auto const ipv4_end{ (position + 1 < names.size()) ? names[position + 1].ipv4_begin : ipv4s.size() };
+            auto const ipv6_end{ (position + 1 < names.size()) ? names[position + 1].ipv6_begin : ipv6s.size() };
+            return Loaded{
+                name.key,
+                core::Span<IPV4Raw const>{ ipv4s.data() + name.ipv4_begin, ipv4_end - name.ipv4_begin },
+                core::Span<IPV6Raw const>{ ipv6s.data() + name.ipv6_begin, ipv6_end - name.ipv6_begin },
+                name.ttl
+            };
+        } // lambda
+    };
+
+    return this->fill(names.size(), entryAt, ranks);
+}
+
+template <template <typename, typename> class Replacement>
+template <typename EntryAt>
+auto DNSCache::BasicDNSCacheImpl<Replacement>::fill(
+    core::Size                      entries_number,
+    EntryAt const&                  entry_at,
+    core::Span<std::uint32_t const> ranks
+) noexcept(false) -> core::Size
+{
+    if (0 != this->dictionary.size())
+    { throw std::logic_error{ "Not empty!" }; }
+
+    // Both queues are relinked from scratch: the window gets the first nodes that aren't parked again.
+    auto const main_capacity{ this->main_queue.maxSize() };
+    std::vector<Node*> window_nodes;
+    std::vector<Node*> main_nodes;
+    window_nodes.reserve(this->window_capacity);
+    main_nodes.reserve(main_capacity);
+
+    this->forEachNode(
+        [&] (Node* node)
+        {
+            if (node->in_negative or node->parked or node->retiring)
+            { return; }
+
+            node->in_window = (window_nodes.size() < this->window_capacity);
+            (node->in_window ? window_nodes : main_nodes).push_back(node);
+        } // lambda
+    );
+
+    // What doesn't fit are the lowest ranked entries.
+    std::vector<bool> fits(entries_number, true);
+    if (main_capacity < ranks.size())
+    {
+        auto const left_out{ ranks.size() - main_capacity };
+        for (core::Size i{ 0 }; i < left_out; ++i)
+        { fits[ranks[i]] = false; }
+    }
+
+    auto const now{ nowTick() };
+    std::vector<Node*> nodes(entries_number, nullptr);
+    core::Size restored{ 0 };
+
+    // Checked on the way, while the keys are at hand: then the index needn't check them again.
+    auto sorted{ true };
+    std::string_view previous_key{};
+
+    core::SeqLock::WriteGuard write_guard{ this->seq_lock };
+
+    // Nothing's indexed, but a lock-free reader may still be comparing against an old key.
+    this->epoch_domain.synchronize();
+
+    for (core::Size position{ 0 }; position < entries_number; ++position)
+    {
+        if (not fits[position])
+        { continue; }
+
+        auto const entry{ entry_at(position) };
+        if (not entry.has_value())
+        { continue; }
+
+        sorted       = sorted and ((0 == restored) or (previous_key < entry->key));
+        previous_key = entry->key;
+
+        auto node{ main_nodes[restored++] };
+        node->first.assign(entry->key);
+        node->second  = this->makeRecordBlock(entry->ipv4s, entry->ipv6s);
+        node->indexed = true;
+
+        this->pending_expires_at = expiresAt(now, entry->ttl);
+        this->setExpiry(node);
+
+        if (this->frequencies.has_value())
+        { this->frequencies->increment(keyHash(node->first)); }
+
+        nodes[position] = node;
+    }
+
+    if (this->window.has_value())
+    { this->window->relink(window_nodes); }
+
+    // The unused nodes stay at the bottom, the restored ones go up in the ranks' order.
+    std::vector<Node*> queue_nodes;
+    queue_nodes.reserve(main_capacity);
+    for (auto i{ restored }; i < main_capacity; ++i)
+    { queue_nodes.push_back(main_nodes[i]); }
+
+    for (auto const position : ranks)
+    {
+        if (nullptr != nodes[position])
+        { queue_nodes.push_back(nodes[position]); }
+    }
+
+    this->main_queue.relink(queue_nodes);
+
+    nodes.erase(std::remove(nodes.begin(), nodes.end(), nullptr), nodes.end());
+    if (sorted)
+    { this->dictionary.rebuild(nodes, DNSDictionary::SORTED); }
+    else
+    { this->dictionary.rebuild(nodes); }
+
+    if (this->suffix_index.has_value())
+    { this->rebuildSuffixIndex(); }
+
+    StatsCounters::add(this->counters, Counter::INSERTS, restored);
+    return restored;
+}
+
+///
+/// \brief The DNSCache::DNSCacheImpl class is the shard w/ the replacement policy the library's built w/.
+///
+class DNSCache::DNSCacheImpl final
+#if defined(DNS_CACHE_CLOCK_REPLACEMENT)
+    : public DNSCache::BasicDNSCacheImpl<core::Clock>
+#else
+    : public DNSCache::BasicDNSCacheImpl<core::Ladder>
+#endif
+{
+public:
+    using BasicDNSCacheImpl::BasicDNSCacheImpl;
+
+}; // DNSCache::DNSCacheImpl
+
+///
+/// \brief The DNSCache::Fetch struct is a name's fetch in flight, the callers that missed it wait on it.
+///
+struct DNSCache::Fetch
+{
+    std::promise<Lookup>       promise{};
+    std::shared_future<Lookup> result{ promise.get_future().share() };
+    std::vector<FetchCallback> callbacks{}; // The other callers', guarded by the shard's fetches_mutex.
+
+}; // DNSCache::Fetch
+
+namespace
+{
+
+///
+/// \brief callBack hands `result` to `callback`, if there's one. What the callback throws is dropped: the other
+/// callers waiting on the same fetch are still to be called back, and the fetch itself is done already.
+///
+template <typename Callback, typename Result>
+auto callBack(Callback const& callback, Result const& result) noexcept(true) -> void
+{
+    if (not callback)
+    { return; }
+
+    try
+    { callback(result); }
+    catch (...)
+    {}
+}
+
+///
+/// \brief mixShardHash decorrelates the shard choice from the bits a hashing index would use.
+///
+inline auto mixShardHash(std::size_t hash) noexcept(true) -> std::uint64_t
+{
+    std::uint64_t mixed{ hash };
+    mixed ^= (mixed >> 33);
+    mixed *= 0xFF51'AFD7'ED55'8CCDull;
+    mixed ^= (mixed >> 33);
+    return mixed;
+}
+
+inline auto shardIndexOfMixed(std::uint64_t const mixed, core::Size const shards_number) noexcept(true)
+    -> core::Size
+{ return ((1 == shards_number) ? 0 : (mixed % shards_number)); }
+
+///
+/// \brief L1_SLOTS is the size of a thread's L1: enough for the hottest names, small enough to stay cached.
+///
+inline constexpr core::Size L1_SLOTS{ 1024 };
+
+///
+/// \brief L1_TABLES is how many caches a thread keeps an L1 for: a new one empties the least recently used.
+///
+inline constexpr core::Size L1_TABLES{ 4 };
+
+///
+/// \brief The L1Entry struct is a slot of a thread's L1: a name's first A record as of its shard's generation.
+///
+struct alignas(core::CACHE_LINE_SIZE) L1Entry
+{
+    inline static constexpr core::Size NAME_CAPACITY{
+        core::CACHE_LINE_SIZE - (2 * sizeof(std::uint64_t)) - sizeof(IPV4Raw) - sizeof(std::uint8_t)
+    };
+
+    std::uint64_t                   generation{ 1 }; // Odd, so an empty slot never matches a shard's.
+    std::uint64_t                   expires_at{};    // The expiry wheel's tick.
+    IPV4Raw                         ipv4{};
+    std::uint8_t                    name_length{};
+    std::array<char, NAME_CAPACITY> name{};
+
+    [[nodiscard]]
+    auto holds(std::string_view const fqdn) const noexcept(true) -> bool
+    {
+        return (fqdn.size() == this->name_length)
+           and (0 == std::memcmp(fqdn.data(), this->name.data(), fqdn.size()));
+    }
+
+}; // L1Entry
+
+static_assert(sizeof(L1Entry) == core::CACHE_LINE_SIZE);
+
+///
+/// \brief next_cache_id hands out the caches' ids: unlike the addresses, they're never reused, so a thread's
+/// L1 can't mistake a new cache for an old one.
+///
+std::atomic<std::uint64_t> next_cache_id{ 1 };
+
+///
+/// \brief BATCH_WINDOW is how many names of a batch are grouped by shard at a time.
+///
+inline constexpr core::Size BATCH_WINDOW{ 64 };
+
+///
+/// \brief RESIZE_STEP is the most nodes resize() adds, evicts or moves in a shard under one hold of its lock.
+///
+inline constexpr core::Size RESIZE_STEP{ 1 << 16 };
+
+///
+/// \brief forEachShardRun calls `run` w/ every shard's positions in the batch, a window of it at a time.
+/// \details The positions in a run keep their order, so the updates of a name are applied in the order given.
+///
+template <typename ShardIndexOf, typename Run>
+auto forEachShardRun(core::Span<FQDN const> fqdns, ShardIndexOf const& shard_index_of, Run const& run) -> void
+{
+    std::array<core::Size, BATCH_WINDOW> shard_indices;
+    std::array<core::Size, BATCH_WINDOW> positions;
+    for (core::Size offset{ 0 }; offset < fqdns.size(); offset += BATCH_WINDOW)
+    {
+        auto const width{ std::min(fqdns.size() - offset, BATCH_WINDOW) };
+        for (core::Size i{ 0 }; i < width; ++i)
+        {
+            shard_indices[i] = shard_index_of(fqdns[offset + i]);
+            positions[i]     = offset + i;
+        }
+
+        auto const by_shard{
+            [&] (core::Size const lhs, core::Size const rhs) -> bool
+            {
+                return std::pair{ shard_indices[lhs - offset], lhs } < std::pair{ shard_indices[rhs - offset], rhs };
+            } // lambda
+        };
+
+        // W/ one shard, or a batch that's been grouped already, there's nothing to sort.
+        if (not std::is_sorted(positions.begin(), positions.begin() + width, by_shard))
+        { std::sort(positions.begin(), positions.begin() + width, by_shard); }
+
+        for (core::Size begin{ 0 }, end{ 0 }; begin < width; begin = end)
+        {
+            auto const shard_index{ shard_indices[positions[begin] - offset] };
+            while ((end < width) and (shard_index == shard_indices[positions[end] - offset]))
+            { ++end; }
+
+            run(shard_index, core::Span<core::Size const>{ positions.data() + begin, end - begin });
+        }
+    }
+}
+
+///
+/// \brief threadsNumber is how many threads the bulk operations run on: one per core.
+///
+inline auto threadsNumber() noexcept(true) -> core::Size
+{ return std::max(1u, std::thread::hardware_concurrency()); }
+
+///
+/// \brief runInParallel calls `task` w/ every index below `tasks_number`, on up to threadsNumber() threads.
+/// \details The threads take the tasks one by one, the calling one included: if no other thread can be
+/// started, it runs them all. Returns once all the tasks are done.
+/// \throws The first task's exception (by index) that's thrown, once all the tasks are done.
+///
+template <typename Task>
+auto runInParallel(core::Size const tasks_number, Task const& task) noexcept(false) -> void
+{
+    std::vector<std::exception_ptr> errors(tasks_number);
+    std::atomic<core::Size>         next_task{ 0 };
+
+    auto const runTasks{
+        [&] ()
+        {
+            for (auto i{ next_task.fetch_add(1) }; i < tasks_number; i = next_task.fetch_add(1))
+            {
+                try
+                { task(i); }
+                catch (...)
+                { errors[i] = std::current_exception(); }
+            }
+        } // lambda
+    };
+
+    std::vector<std::thread> helpers;
+    try
+    {
+        auto const helpers_number{ std::min(tasks_number, threadsNumber()) - 1 };
+        for (core::Size i{ 0 }; i < helpers_number; ++i)
+        { helpers.emplace_back(runTasks); }
+    }
+    catch (std::system_error const&)
+    {
+        // Fewer threads then: this one takes whatever's left anyway.
+    }
+
+    runTasks();
+    for (auto& helper : helpers)
+    { helper.join(); }
+
+    for (auto const& error : errors)
+    {
+        if (nullptr != error)
+        { std::rethrow_exception(error); }
+    }
+}
+
+} // anonymous
+
+///
+/// \brief The DNSCache::L1 struct is a thread's direct-mapped table of one cache's hot names.
+///
+struct DNSCache::L1
+{
+    std::uint64_t                 owner{}; // The id of the cache it's for, 0 for none.
+    std::array<L1Entry, L1_SLOTS> entries{};
+
+}; // DNSCache::L1
+
+auto DNSCache::l1Of(std::uint64_t const owner) noexcept(true) -> L1*
+{
+    // The most recently used first: a thread that sticks to a cache finds its table right away.
+    thread_local std::array<std::unique_ptr<L1>, L1_TABLES> tables{};
+    if ((nullptr != tables[0]) and (owner == tables[0]->owner))
+    { return tables[0].get(); }
+
+    auto found{
+        std::find_if(tables.begin() + 1, tables.end(),
+                     [owner] (std::unique_ptr<L1> const& table) -> bool
+                     { return (nullptr != table) and (owner == table->owner); })
+    };
+
+    // A new owner takes the last table: a fresh one while there's room, the least recently used one then.
+    if (tables.end() == found)
+    {
+        found = tables.end() - 1;
+        if (nullptr == *found)
+        { found->reset(new (std::nothrow) L1{}); }
+
+        if (nullptr == *found)
+        { return nullptr; }
+
+        (*found)->entries.fill(L1Entry{});
+        (*found)->owner = owner;
+    }
+
+    std::rotate(tables.begin(), found, found + 1);
+    return tables[0].get();
+}
+
+DNSCache::DNSCache(
+    core::Capacity           capacity,
+    core::Size               shards,
+    Admission                admission,
+    core::Capacity           negative_capacity,
+    core::PageOptions const& pages
+)
+    : shards_number{ shards }
+    , id{ next_cache_id.fetch_add(1, std::memory_order_relaxed) }
+{
+    if ((0 == shards) or ((capacity / shards) < minViableCapacity()))
+    { throw std::logic_error{ "BadArgs" }; }
+
+#if defined(DNS_CACHE_STATS)
+    this->counters = std::make_unique<StatsCounters>();
+#endif
+
+    this->shards = std::make_unique<Shard[]>(shards);
+
+    // The remainder goes to the first shards, so the total is exactly `capacity`.
+    auto const shard_capacity{ capacity / shards };
+    auto const remainder{ capacity % shards };
+    auto const shard_negative_capacity{ negative_capacity / shards };
+    auto const negative_remainder{ negative_capacity % shards };
+    for (core::Size i{ 0 }; i < shards; ++i)
+    {
+        // W/ NumaPlacement::NODE, the shards go round robin over the nodes from the one asked for on.
+        auto shard_pages{ pages };
+        shard_pages.numa_node = pages.numa_node + i;
+
+        this->shards[i].impl = std::make_unique<DNSCacheImpl>(
+            shard_capacity + ((i < remainder) ? 1 : 0),
+            admission,
+            shard_negative_capacity + ((i < negative_remainder) ? 1 : 0),
+            this->counters.get(),
+            shard_pages
+        );
+    }
+}
+
+auto DNSCache::resize(core::Capacity const capacity) noexcept(false) -> void
+{
+    if ((capacity / this->shards_number) < minViableCapacity())
+    { throw std::logic_error{ "BadArgs" }; }
+
+    // Split as the constructor does.
+    auto const shard_capacity{ capacity / this->shards_number };
+    auto const remainder{ capacity % this->shards_number };
+    auto const capacityOf{
+        [&] (core::Size const i) -> core::Capacity
+        { return shard_capacity + ((i < remainder) ? 1 : 0); }
+    };
+
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
+    {
+        if (auto const& shard{ this->shards[i] };
+            (nullptr != shard.impl) and (capacityOf(i) < shard.impl->minCapacity()))
+        { throw std::logic_error{ "BadArgs" }; }
+    }
+
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
+    {
+        auto& shard{ this->shards[i] };
+        if (nullptr == shard.impl)
+        { continue; }
+
+        // The lock's let go between the steps: the writers, and the readers that fall back on it, get in.
+        for (auto done{ false }; not done; )
+        {
+            auto const lck{ this->lockShard(shard) };
+            done = shard.impl->resize(capacityOf(i), RESIZE_STEP);
+        }
+    }
+}
+
+auto DNSCache::hugePages() const noexcept(false) -> core::HugePages
+{
+    auto huge_pages{ core::HugePages::EXPLICIT };
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
+    {
+        // Locked: resize() may be adding a chunk.
+        if (auto const& shard{ this->shards[i] };
+            nullptr != shard.impl)
+        {
+            auto const lck{ this->lockShard(shard) };
+            huge_pages = std::min(huge_pages, shard.impl->hugePages());
+        }
+    }
+
+    return huge_pages;
+}
+
+auto DNSCache::footprint() const noexcept(false) -> Footprint
+{
+    Footprint footprint{};
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
+    {
+        if (auto const& shard{ this->shards[i] };
+            nullptr != shard.impl)
+        {
+            auto const lck{ this->lockShard(shard) };
+            auto const shard_footprint{ shard.impl->footprint() };
+
+            footprint.node_bytes = shard_footprint.node_bytes;
+            footprint.link_bytes = shard_footprint.link_bytes;
+            footprint.nodes     += shard_footprint.nodes;
+            footprint.bytes     += shard_footprint.bytes;
+        }
+    }
+
+    return footprint;
+}
+
+auto DNSCache::lockShard(Shard const& shard) const noexcept(false) -> std::unique_lock<std::mutex>
+{
+#if defined(DNS_CACHE_STATS)
+    // Only a contended lock is timed: the clock isn't read on the fast path.
+    std::unique_lock lck{ shard.mutex, std::try_to_lock };
+    if (not lck.owns_lock())
+    {
+        auto const start{ std::chrono::steady_clock::now() };
+        lck.lock();
+        auto const waited{ std::chrono::steady_clock::now() - start };
+
+        StatsCounters::add(this->counters.get(), StatsCounters::Counter::LOCK_CONTENTIONS);
+        StatsCounters::add(this->counters.get(), StatsCounters::Counter::LOCK_WAIT_NS,
+                           static_cast<std::uint64_t>(std::chrono::nanoseconds{ waited }.count()));
+    }
+
+    return lck;
+#else
+    return std::unique_lock{ shard.mutex };
+#endif
+}
+
+auto DNSCache::lockShardToRead(Shard const& shard) const noexcept(true) -> std::unique_lock<std::mutex>
+{
+    try
+    {
+        return this->lockShard(shard);
+    }
+    catch (std::system_error const&)
+    {
+        return std::unique_lock<std::mutex>{};
+    }
+}
 
-    ///
-    /// \brief The Node struct
-    ///
-    struct Node
-        : public core::Ladder<Node>::NodeTrait
-        , public core::FlatMap<NodeKeyType, NodeValueType, Node>::NodeTrait
+auto DNSCache::shardIndexOf(std::string_view fqdn) const noexcept(true) -> core::Size
+{
+    if (1 == this->shards_number)
+    { return 0; }
+
+    // The same as std::hash<FQDN>, the standard says so.
+    return shardIndexOfMixed(mixShardHash(std::hash<std::string_view>{}(fqdn)), this->shards_number);
+}
+
+auto DNSCache::shardOf(std::string_view const fqdn) const noexcept(true) -> Shard&
+{
+    return this->shards[this->shardIndexOf(fqdn)];
+}
+
+auto DNSCache::update(FQDN const& fqdn, IP const& ip, TTL ttl) noexcept(false) -> void
+{
+    this->update(fqdn, strToIPV4Raw(ip).value_or(0), ttl);
+}
+
+auto DNSCache::update(FQDN const& fqdn, IPV4Raw raw_ip, TTL ttl) noexcept(false) -> void
+{
+    this->update(fqdn, core::Span<IPV4Raw const>{ &raw_ip, 1 }, {}, ttl);
+}
+
+auto DNSCache::update(
+    FQDN const&               fqdn,
+    core::Span<IPV4Raw const> ipv4s,
+    core::Span<IPV6Raw const> ipv6s,
+    TTL                       ttl
+) noexcept(false) -> void
+{
+    auto& shard{ this->shardOf(fqdn) };
+    if (nullptr != shard.impl)
     {
-        using NodeKeyReference = NodeKeyType const&;
+        auto const lck{ this->lockShard(shard) };
+        shard.impl->update(fqdn, ipv4s, ipv6s, ttl);
+    }
+}
 
-        ///
-        /// \brief operator NodeKeyReference is a helper cast operator.
-        /// \details It's defined, so we don't have to define tons of comparison operators.
-        /// Just use the existing ones.
-        /// \return Const reference to the key held by the node.
-        ///
-        operator NodeKeyReference () const noexcept(true)
-        { return this->first; }
+auto DNSCache::updateNegative(FQDN const& fqdn, Negative negative, TTL ttl) noexcept(false) -> void
+{
+    if (Negative::NONE == negative)
+    { throw std::logic_error{ "BadArgs" }; }
 
-    }; // Node
+    auto& shard{ this->shardOf(fqdn) };
+    if (nullptr != shard.impl)
+    {
+        auto const lck{ this->lockShard(shard) };
+        shard.impl->updateNegative(fqdn, negative, ttl);
+    }
+}
 
-public:
-    using DNSLadder     = core::Ladder<Node>;
-    using DNSDictionary = core::FlatMap<NodeKeyType, NodeValueType, Node>;
+auto DNSCache::updateBatch(
+    core::Span<FQDN const>    fqdns,
+    core::Span<IPV4Raw const> ipv4s,
+    TTL                       ttl
+) noexcept(false) -> void
+{
+    if (fqdns.size() != ipv4s.size())
+    { throw std::logic_error{ "BadArgs" }; }
 
-private:
-    std::unique_ptr<Node[]> storage{};
-    DNSLadder               ladder;
-    DNSDictionary           dictionary;
+    for (auto const& fqdn : fqdns)
+    {
+        if (MAX_FQDN_LENGTH < fqdn.size())
+        { throw std::length_error{ "Too long to be cached!" }; }
+    }
 
-public:
-    DNSCacheImpl(core::Capacity const capacity) noexcept(false)
-        : storage{ std::make_unique<Node[]>(capacity) }
-        , ladder{ storage.get(), capacity }
-        , dictionary{ capacity }
-    {
-        dictionary.setAllocateCallback(
-            [this] () -> Node*
-            { return this->ladder.releaseBottom(); }
-        );
+    forEachShardRun(
+        fqdns,
+        [this] (FQDN const& fqdn) -> core::Size
+        { return this->shardIndexOf(fqdn); },
+        [&] (core::Size const shard_index, core::Span<core::Size const> positions)
+        {
+            auto& shard{ this->shards[shard_index] };
+            if (nullptr == shard.impl)
+            { return; }
 
-        dictionary.setCreateCallback(
-            [this] (Node* created_node) -> DNSDictionary::CreateOrUpdateStatus
+            auto const lck{ this->lockShard(shard) };
+            for (core::Size offset{ 0 }; offset < positions.size(); offset += DNSCacheImpl::BATCH_WIDTH)
             {
-                if (nullptr == created_node)
-                { return DNSDictionary::CreateOrUpdateStatus::FATAL_ERROR; }
+                auto const width{ std::min(positions.size() - offset, DNSCacheImpl::BATCH_WIDTH) };
 
-                auto promoting_status{ this->ladder.promote(created_node, DNSLadder::TO_TOP) };
-                if (DNSLadder::PromotingStatus::ERROR == promoting_status)
-                { return DNSDictionary::CreateOrUpdateStatus::FATAL_ERROR; }
+                std::array<FQDN const*, DNSCacheImpl::BATCH_WIDTH> names;
+                std::array<IPV4Raw, DNSCacheImpl::BATCH_WIDTH>     raw_ips;
+                for (core::Size k{ 0 }; k < width; ++k)
+                {
+                    names[k]   = &(fqdns[positions[offset + k]]);
+                    raw_ips[k] = ipv4s[positions[offset + k]];
+                }
 
-                return DNSDictionary::CreateOrUpdateStatus::SUCCESS;
-            } // lambda
-        );
+                shard.impl->updateBatch(core::Span<FQDN const* const>{ names.data(), width },
+                                        core::Span<IPV4Raw const>{ raw_ips.data(), width },
+                                        ttl);
+            }
+        } // lambda
+    );
+}
 
-        auto use_or_update_cb{
-            [this] (Node* updated_node) -> DNSDictionary::CreateOrUpdateStatus
-            {
-                if (nullptr == updated_node)
-                { return DNSDictionary::CreateOrUpdateStatus::FATAL_ERROR; }
+auto DNSCache::resolve(FQDN const& fqdn) noexcept(true) -> IP
+{
+    if (auto const raw_ip{ this->resolveRaw(fqdn) })
+    { return IPV4RawToStr(*raw_ip).value_or(IP{}); }
+
+    return {};
+}
+
+auto DNSCache::lookupOf(std::optional<RecordBlock> const& records) noexcept(true) -> Lookup
+{
+    Lookup result{};
+    if (records.has_value())
+    {
+        result.negative = records->negative;
+        result.outcome  = (Negative::NONE == records->negative) ? Outcome::HIT : Outcome::NEGATIVE_HIT;
+        if (0 < records->ipv4_number)
+        { result.ipv4 = records->ipv4[0]; }
+    }
 
-                auto promoting_status{ this->ladder.promote(updated_node, DNSLadder::ONE_UP) };
-                if (DNSLadder::PromotingStatus::ERROR == promoting_status)
-                { return DNSDictionary::CreateOrUpdateStatus::FATAL_ERROR; }
+    return result;
+}
 
-                return DNSDictionary::CreateOrUpdateStatus::SUCCESS;
-            } // lambda
-        };
+auto DNSCache::lookup(FQDN const& fqdn) noexcept(true) -> Lookup
+{
+    return lookupOf(resolveRecords(this->shardOf(fqdn), fqdn));
+}
+
+auto DNSCache::lookupWildcard(std::string_view const fqdn) noexcept(true) -> Lookup
+{
+    if (auto const records{ resolveRecords(this->shardOf(fqdn), fqdn) })
+    { return lookupOf(records); }
 
-        dictionary.setUpdateCallback(use_or_update_cb);
-        dictionary.setUseCallback(use_or_update_cb);
+    // The closest first: `*.` and the name w/o its first label, then w/o the next one, and so on.
+    std::array<char, MAX_FQDN_LENGTH> candidate{ '*', '.' };
+    for (auto dot{ fqdn.find('.') }; std::string_view::npos != dot; dot = fqdn.find('.', dot + 1))
+    {
+        auto const parent{ fqdn.substr(dot + 1) };
+        if ((candidate.size() - 2) < parent.size())
+        { continue; }
+
+        std::memcpy(candidate.data() + 2, parent.data(), parent.size());
+        std::string_view const wildcard{ candidate.data(), parent.size() + 2 };
+        if (auto const records{ resolveRecords(this->shardOf(wildcard), wildcard) })
+        { return lookupOf(records); }
     }
 
-    auto size() const noexcept(true) -> core::Capacity
-    { return this->dictionary.size(); }
+    return Lookup{};
+}
 
-    [[nodiscard]]
-    auto maxSize() noexcept(true) -> core::Capacity
-    { return this->ladder.maxSize(); }
+auto DNSCache::resolveRaw(FQDN const& fqdn) noexcept(true) -> std::optional<IPV4Raw>
+{
+    return this->find(fqdn);
+}
 
-public:
-    auto update(FQDN const& fqdn, IP const& ip) noexcept(false) -> void;
+auto DNSCache::find(std::string_view const fqdn) noexcept(true) -> std::optional<IPV4Raw>
+{
+    if (auto const l1{ this->l1_enabled ? l1Of(this->id) : nullptr }; nullptr != l1)
+    { return this->resolveRawL1(fqdn, *l1); }
 
-    [[nodiscard]]
-    auto resolve(FQDN const& fqdn) noexcept(false) -> IP;
+    if (auto const records{ resolveRecords(this->shardOf(fqdn), fqdn) };
+        records.has_value() and (0 < records->ipv4_number))
+    { return records->ipv4[0]; }
 
-    DNSCacheImpl& operator = (DNSCacheImpl const&) = delete;
-    DNSCacheImpl& operator = (DNSCacheImpl&&)      = delete;
-    DNSCacheImpl(DNSCacheImpl const&)              = delete;
-    DNSCacheImpl(DNSCacheImpl&&)                   = delete;
+    return std::nullopt;
+}
 
-    ~DNSCacheImpl() noexcept(true)
-    {}
+auto DNSCache::resolveRawL1(std::string_view const fqdn, L1& l1) noexcept(true) -> std::optional<IPV4Raw>
+{
+    auto const mixed{ mixShardHash(std::hash<std::string_view>{}(fqdn)) };
+    auto& shard{ this->shards[shardIndexOfMixed(mixed, this->shards_number)] };
+    if (nullptr == shard.impl)
+    { return std::nullopt; }
 
-}; // DNSCache::DNSCacheImpl
+    // The shard index comes from the low bits, the slot from the high ones.
+    auto& entry{ l1.entries[(mixed >> 32) % L1_SLOTS] };
+
+    // Read before the lookup: a write in between makes the entry stale right away.
+    auto const generation{ shard.impl->generation() };
+    if ((generation == entry.generation) and entry.holds(fqdn))
+    {
+        if (not DNSCacheImpl::isExpired(entry.expires_at))
+        {
+            StatsCounters::add(this->counters.get(), StatsCounters::Counter::HITS);
+            StatsCounters::add(this->counters.get(), StatsCounters::Counter::L1_HITS);
+            return entry.ipv4;
+        }
+    }
+
+    RecordBlock records{};
+    DNSCacheImpl::Tick expires_at{};
+    switch (shard.impl->resolveLockFree(fqdn, records, &expires_at))
+    {
+        case DNSCacheImpl::ReadStatus::HIT:
+        break;
+
+        case DNSCacheImpl::ReadStatus::MISS:
+        { return std::nullopt; }
+
+        case DNSCacheImpl::ReadStatus::CONTENDED:
+        {
+            // Being written to, so not worth keeping in the L1.
+            if (auto const locked{ resolveRecords(shard, fqdn) };
+                locked.has_value() and (0 < locked->ipv4_number))
+            { return locked->ipv4[0]; }
+
+            return std::nullopt;
+        }
+    }
+
+    if (0 == records.ipv4_number)
+    { return std::nullopt; }
+
+    if ((not core::SeqLock::isWriting(generation)) and (fqdn.size() <= L1Entry::NAME_CAPACITY))
+    {
+        entry.generation  = generation;
+        entry.expires_at  = expires_at;
+        entry.ipv4        = records.ipv4[0];
+        entry.name_length = static_cast<std::uint8_t>(fqdn.size());
+        std::memcpy(entry.name.data(), fqdn.data(), fqdn.size());
+    }
+
+    return records.ipv4[0];
+}
 
-auto DNSCache::DNSCacheImpl::update(
-    FQDN const&  fqdn,
-    IP const& ip
+auto DNSCache::resolveBatch(
+    core::Span<FQDN const>             fqdns,
+    core::Span<std::optional<IPV4Raw>> ipv4s
 ) noexcept(false) -> void
 {
-    auto raw_ip = strToIPV4Raw(ip).value_or(0);
-    this->dictionary.insertOrUpdate(fqdn, raw_ip);
+    if (fqdns.size() != ipv4s.size())
+    { throw std::logic_error{ "BadArgs" }; }
+
+    forEachShardRun(
+        fqdns,
+        [this] (FQDN const& fqdn) -> core::Size
+        { return this->shardIndexOf(fqdn); },
+        [&] (core::Size const shard_index, core::Span<core::Size const> positions)
+        {
+            auto& shard{ this->shards[shard_index] };
+            if (nullptr == shard.impl)
+            {
+                for (auto const position : positions)
+                { ipv4s[position] = std::nullopt; }
+
+                return;
+            }
+
+            // Only taken if the writers keep interfering w/ the lock-free reads, then once for the rest.
+            std::unique_lock<std::mutex> lck{};
+            for (core::Size offset{ 0 }; offset < positions.size(); offset += DNSCacheImpl::BATCH_WIDTH)
+            {
+                auto const width{ std::min(positions.size() - offset, DNSCacheImpl::BATCH_WIDTH) };
+
+                std::array<FQDN const*, DNSCacheImpl::BATCH_WIDTH>              names;
+                std::array<RecordBlock, DNSCacheImpl::BATCH_WIDTH>              records;
+                std::array<DNSCacheImpl::ReadStatus, DNSCacheImpl::BATCH_WIDTH> statuses;
+                for (core::Size k{ 0 }; k < width; ++k)
+                { names[k] = &(fqdns[positions[offset + k]]); }
+
+                shard.impl->resolveLockFreeBatch(
+                    core::Span<FQDN const* const>{ names.data(), width },
+                    core::Span<RecordBlock>{ records.data(), width },
+                    core::Span<DNSCacheImpl::ReadStatus>{ statuses.data(), width }
+                );
+
+                for (core::Size k{ 0 }; k < width; ++k)
+                {
+                    if (DNSCacheImpl::ReadStatus::CONTENDED == statuses[k])
+                    {
+                        if (not lck.owns_lock())
+                        { lck = this->lockShardToRead(shard); }
+
+                        if (auto const found{ lck.owns_lock() ? shard.impl->find(*names[k]) : std::nullopt })
+                        {
+                            records[k]  = *found;
+                            statuses[k] = DNSCacheImpl::ReadStatus::HIT;
+                        }
+                        else
+                        {
+                            statuses[k] = DNSCacheImpl::ReadStatus::MISS;
+                        }
+                    }
+
+                    auto& ipv4{ ipv4s[positions[offset + k]] };
+                    if ((DNSCacheImpl::ReadStatus::HIT == statuses[k]) and (0 < records[k].ipv4_number))
+                    { ipv4 = records[k].ipv4[0]; }
+                    else
+                    { ipv4 = std::nullopt; }
+                }
+            }
+        } // lambda
+    );
 }
 
-[[nodiscard]]
-auto DNSCache::DNSCacheImpl::resolve(FQDN const& fqdn) noexcept(false) -> IP
+auto DNSCache::resolveAll(FQDN const& fqdn) noexcept(true) -> std::optional<RecordSetView>
 {
-    auto raw_ip_opt{ IPV4RawToStr(this->dictionary.at(fqdn)) };
-    return raw_ip_opt.value_or(IP{});
+    auto& shard{ this->shardOf(fqdn) };
+    if (nullptr == shard.impl)
+    { return std::nullopt; }
+
+    // Pinned before the lookup, so the overflow it finds stays put.
+    auto records_guard{ shard.impl->pinRecords() };
+    if (auto const records{ resolveRecords(shard, fqdn) };
+        records.has_value() and (Negative::NONE == records->negative))
+    { return RecordSetView{ *records, std::move(records_guard) }; }
+
+    return std::nullopt;
 }
 
-DNSCache::DNSCache(core::Capacity capacity)
-    : impl{std::make_unique<DNSCacheImpl>(capacity)}
-{}
+auto DNSCache::resolveRecords(Shard& shard, std::string_view const fqdn) const noexcept(true)
+    -> std::optional<RecordBlock>
+{
+    if (nullptr != shard.impl)
+    {
+        RecordBlock records{};
+        switch (shard.impl->resolveLockFree(fqdn, records))
+        {
+            case DNSCacheImpl::ReadStatus::HIT:
+            { return records; }
+
+            case DNSCacheImpl::ReadStatus::MISS:
+            { return std::nullopt; }
+
+            case DNSCacheImpl::ReadStatus::CONTENDED:
+            break;
+        }
+
+        if (auto const lck{ this->lockShardToRead(shard) };
+            lck.owns_lock())
+        { return shard.impl->find(fqdn); }
+    }
 
-auto DNSCache::update(FQDN const& fqdn, IP const& ip) noexcept(false) -> void
+    return std::nullopt;
+}
+
+auto DNSCache::enableL1(bool const enabled) noexcept(true) -> void
+{
+    this->l1_enabled = enabled;
+}
+
+auto DNSCache::enableSuffixIndex(bool const enabled) noexcept(false) -> void
 {
-    if (nullptr != this->impl)
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
     {
-        std::scoped_lock lck{this->mutex};
-        if (nullptr != this->impl)
-        { this->impl->update(fqdn, ip); }
+        auto& shard{ this->shards[i] };
+        if (nullptr != shard.impl)
+        {
+            auto const lck{ this->lockShard(shard) };
+            shard.impl->enableSuffixIndex(enabled);
+        }
     }
 }
 
-auto DNSCache::resolve(FQDN const& fqdn) noexcept(true) -> IP
+auto DNSCache::invalidateSuffix(std::string_view domain) noexcept(false) -> core::Size
 {
-    if (nullptr != this->impl)
+    if ((not domain.empty()) and ('.' == domain.back()))
+    { domain.remove_suffix(1); }
+
+    // The names are spread over the shards by their hashes, a domain's as much as any.
+    core::Size dropped{ 0 };
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
     {
-        std::scoped_lock lck{this->mutex};
-        if (nullptr != this->impl)
+        auto& shard{ this->shards[i] };
+        if (nullptr != shard.impl)
         {
-            try
-            {
-                return this->impl->resolve(fqdn);
-            }
-            catch (std::out_of_range const&)
+            auto const lck{ this->lockShard(shard) };
+            dropped += shard.impl->invalidateSuffix(domain);
+        }
+    }
+
+    return dropped;
+}
+
+auto DNSCache::setUpstream(Upstream upstream) noexcept(true) -> void
+{
+    this->upstream = std::move(upstream);
+}
+
+auto DNSCache::resolveOrFetch(FQDN const& fqdn) noexcept(false) -> std::shared_future<Lookup>
+{
+    return this->fetch(fqdn, {});
+}
+
+auto DNSCache::resolveOrFetch(FQDN const& fqdn, FetchCallback callback) noexcept(false) -> void
+{
+    (void)this->fetch(fqdn, std::move(callback));
+}
+
+auto DNSCache::fetch(FQDN const& fqdn, FetchCallback callback) noexcept(false) -> std::shared_future<Lookup>
+{
+    if (not this->upstream)
+    { throw std::logic_error{ "No upstream!" }; }
+
+    if (MAX_FQDN_LENGTH < fqdn.size())
+    { throw std::length_error{ "Too long to be cached!" }; }
+
+    auto const ready{
+        [&callback] (Lookup const& cached) -> std::shared_future<Lookup>
+        {
+            std::promise<Lookup> promise;
+            promise.set_value(cached);
+
+            auto result{ promise.get_future().share() };
+            callBack(callback, result);
+
+            return result;
+        } // lambda
+    };
+
+    if (auto const cached{ this->lookup(fqdn) }; Outcome::MISS != cached.outcome)
+    { return ready(cached); }
+
+    auto& shard{ this->shardOf(fqdn) };
+    auto fetch{ std::make_shared<Fetch>() };
+    {
+        std::unique_lock lck{ shard.fetches_mutex };
+        if (auto const in_flight{ shard.fetches.find(fqdn) }; shard.fetches.end() != in_flight)
+        {
+            if (callback)
+            { in_flight->second->callbacks.push_back(std::move(callback)); }
+
+            return in_flight->second->result;
+        }
+
+        // Looked up again: a fetch may have been done since the miss, then its answer's cached already.
+        if (auto const cached{ this->lookup(fqdn) }; Outcome::MISS != cached.outcome)
+        {
+            lck.unlock();
+            return ready(cached);
+        }
+
+        shard.fetches.emplace(fqdn, fetch);
+    }
+
+    try
+    {
+        auto const answer{ this->upstream(fqdn) };
+
+        Lookup fetched{};
+        if (Negative::NONE != answer.negative)
+        {
+            this->updateNegative(fqdn, answer.negative, answer.ttl);
+            fetched.outcome  = Outcome::NEGATIVE_HIT;
+            fetched.negative = answer.negative;
+        }
+        else
+        {
+            this->update(fqdn, answer.ipv4s, answer.ipv6s, answer.ttl);
+            fetched.outcome = Outcome::HIT;
+            if (not answer.ipv4s.empty())
+            { fetched.ipv4 = answer.ipv4s.front(); }
+        }
+
+        fetch->promise.set_value(fetched);
+    }
+    catch (...)
+    {
+        fetch->promise.set_exception(std::current_exception());
+    }
+
+    // The answer's cached by now, so whoever misses after this looks it up again and finds it.
+    std::vector<FetchCallback> callbacks;
+    {
+        std::lock_guard lck{ shard.fetches_mutex };
+        shard.fetches.erase(fqdn);
+        callbacks = std::move(fetch->callbacks);
+    }
+
+    callBack(callback, fetch->result);
+    for (auto const& waiting : callbacks)
+    { callBack(waiting, fetch->result); }
+
+    return fetch->result;
+}
+
+auto DNSCache::saveSnapshot(std::string const& path) const noexcept(false) -> void
+{
+    snapshot::Writer writer{};
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
+    {
+        auto const& shard{ this->shards[i] };
+        if (nullptr != shard.impl)
+        {
+            auto const lck{ this->lockShard(shard) };
+            shard.impl->save(writer);
+        }
+
+        writer.closeRun();
+    }
+
+    writer.write(path);
+}
+
+auto DNSCache::loadSnapshot(std::string const& path) noexcept(false) -> core::Size
+{
+    if (0 != this->size())
+    { throw std::logic_error{ "Not empty!" }; }
+
+    snapshot::Reader const reader{ path };
+    auto const all_entries{ reader.entries() };
+    auto const runs{ reader.runs() };
+    auto const ranks{ reader.ranks() };
+
+    // Every shard's entries in the index' order, and the ranks as positions in them.
+    std::vector<std::vector<std::uint32_t>> shard_entries(this->shards_number);
+    std::vector<std::vector<std::uint32_t>> shard_ranks(this->shards_number);
+    if (reader.shardedAs(this->shards_number))
+    {
+        for (core::Size i{ 0 }; i < this->shards_number; ++i)
+        {
+            shard_entries[i].resize(runs[i + 1] - runs[i]);
+            std::iota(shard_entries[i].begin(), shard_entries[i].end(), static_cast<std::uint32_t>(runs[i]));
+            shard_ranks[i].assign(ranks.begin() + runs[i], ranks.begin() + runs[i + 1]);
+        }
+    }
+    else
+    {
+        if (std::numeric_limits<std::uint32_t>::max() < all_entries.size())
+        { throw std::length_error{ "Too many entries to reshard!" }; }
+
+        std::vector<std::uint32_t> shard_of(all_entries.size());
+        std::vector<std::uint32_t> position_of(all_entries.size());
+        for (std::uint32_t entry{ 0 }; entry < all_entries.size(); ++entry)
+        {
+            auto const shard_index{ this->shardIndexOf(reader.key(all_entries[entry])) };
+            shard_of[entry]    = static_cast<std::uint32_t>(shard_index);
+            position_of[entry] = static_cast<std::uint32_t>(shard_entries[shard_index].size());
+            shard_entries[shard_index].push_back(entry);
+        }
+
+        for (core::Size run{ 0 }; (run + 1) < runs.size(); ++run)
+        {
+            for (auto i{ runs[run] }; i < runs[run + 1]; ++i)
             {
-                return {};
+                auto const entry{ runs[run] + ranks[i] };
+                shard_ranks[shard_of[entry]].push_back(position_of[entry]);
             }
         }
     }
 
-    return {};
+    // The shards are independent: each's restored under its own lock, in parallel.
+    auto const age{ reader.age() };
+    std::vector<core::Size> restored(this->shards_number, 0);
+    runInParallel(this->shards_number,
+                  [&] (core::Size const i)
+                  {
+                      auto& shard{ this->shards[i] };
+                      if (nullptr != shard.impl)
+                      {
+                          auto const lck{ this->lockShard(shard) };
+                          restored[i] = shard.impl->restore(reader, shard_entries[i], shard_ranks[i], age);
+                      }
+                  });
+
+    return std::accumulate(restored.begin(), restored.end(), core::Size{ 0 });
+}
+
+auto DNSCache::bulkLoad(std::string const& path, TTL ttl, BulkPriority const& priority) noexcept(false)
+    -> core::Size
+{
+    if (0 != this->size())
+    { throw std::logic_error{ "Not empty!" }; }
+
+    core::MappedFile const file{ path };
+    file.adviseSequential();
+    return this->bulkLoadText(
+        std::string_view{ reinterpret_cast<char const*>(file.data()), file.bytes() }, ttl, priority);
+}
+
+auto DNSCache::bulkLoad(std::istream& input, TTL ttl, BulkPriority const& priority) noexcept(false)
+    -> core::Size
+{
+    if (0 != this->size())
+    { throw std::logic_error{ "Not empty!" }; }
+
+    std::string text;
+    std::vector<char> buffer(1 << 16);
+    while (input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) or (0 < input.gcount()))
+    { text.append(buffer.data(), static_cast<core::Size>(input.gcount())); }
+
+    if (input.bad())
+    { throw std::runtime_error{ "Can't read the input!" }; }
+
+    return this->bulkLoadText(text, ttl, priority);
+}
+
+auto DNSCache::bulkLoadText(std::string_view const text, TTL ttl, BulkPriority const& priority) noexcept(false)
+    -> core::Size
+{
+    // Less than this a piece isn't worth a thread.
+    constexpr core::Size MIN_PIECE_SIZE{ 1 << 20 };
+
+    // A piece of whole lines per task, its records dealt to the shards right away: a task's staged records
+    // are in the text's order, and so are the pieces.
+    auto const pieces{
+        bulk_load::splitLines(text, std::clamp(text.size() / MIN_PIECE_SIZE, core::Size{ 1 }, threadsNumber()))
+    };
+
+    if (pieces.empty())
+    { return 0; }
+
+    std::vector<std::vector<std::vector<bulk_load::Record>>> staged(pieces.size());
+    runInParallel(pieces.size(),
+                  [&] (core::Size const piece)
+                  {
+                      // About a record a line.
+                      std::vector<bulk_load::Record> records;
+                      records.reserve(pieces[piece].size() / 32);
+                      bulk_load::parseLines(text, pieces[piece], records);
+
+                      auto& by_shard{ staged[piece] };
+                      by_shard.resize(this->shards_number);
+                      if (1 == this->shards_number)
+                      {
+                          by_shard.front() = std::move(records);
+                          return;
+                      }
+
+                      for (auto const& record : records)
+                      { by_shard[this->shardIndexOf(bulk_load::nameOf(text, record))].push_back(record); }
+                  });
+
+    // Then every shard's built from its records of all the pieces, in order.
+    std::vector<core::Size> loaded(this->shards_number, 0);
+    runInParallel(this->shards_number,
+                  [&] (core::Size const i)
+                  {
+                      auto& shard{ this->shards[i] };
+                      if (nullptr == shard.impl)
+                      { return; }
+
+                      std::vector<bulk_load::Record> records{ std::move(staged.front()[i]) };
+                      for (core::Size piece{ 1 }; piece < staged.size(); ++piece)
+                      {
+                          auto& by_shard{ staged[piece][i] };
+                          records.insert(records.end(), by_shard.begin(), by_shard.end());
+                          std::vector<bulk_load::Record>{}.swap(by_shard);
+                      }
+
+                      auto const lck{ this->lockShard(shard) };
+                      loaded[i] = shard.impl->bulkLoad(text, records, ttl, priority);
+                  });
+
+    return std::accumulate(loaded.begin(), loaded.end(), core::Size{ 0 });
 }
 
 DNSCache::~DNSCache() noexcept(true)
 {}
 
-auto DNSCache::maxSize() noexcept(true) -> core::Capacity
+auto DNSCache::maxSize() noexcept(false) -> core::Capacity
 {
-    return (nullptr != this->impl) ? this->impl->maxSize() : 0;
+    core::Capacity max_size{ 0 };
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
+    {
+        // Locked: resize() may be growing or shedding the queues.
+        if (auto const& shard{ this->shards[i] };
+            nullptr != shard.impl)
+        {
+            auto const lck{ this->lockShard(shard) };
+            max_size += shard.impl->maxSize();
+        }
+    }
+
+    return max_size;
 }
 
 auto DNSCache::minViableCapacity() noexcept(true) -> core::Capacity
 {
-    return DNSCacheImpl::DNSLadder::MINIMAL_VIABLE_CAPACITY;
+    return DNSCacheImpl::DNSReplacement::MINIMAL_VIABLE_CAPACITY;
 }
 
-auto DNSCache::size() const noexcept(true) -> core::Size
+auto DNSCache::size() const noexcept(false) -> core::Size
 {
-    if (nullptr != this->impl)
-    { return this->impl->size(); }
-    return {};
+    core::Size size{ 0 };
+    for (core::Size i{ 0 }; i < this->shards_number; ++i)
+    {
+        auto const& shard{ this->shards[i] };
+        if (nullptr != shard.impl)
+        {
+            auto const lck{ this->lockShard(shard) };
+            size += shard.impl->size();
+        }
+    }
+
+    return size;
+}
+
+auto DNSCache::shardsNumber() const noexcept(true) -> core::Size
+{
+    return this->shards_number;
+}
+
+auto DNSCache::stats() const noexcept(true) -> Stats
+{
+    if (nullptr == this->counters)
+    { return Stats{}; }
+
+    auto const sum{
+        [this] (StatsCounters::Counter const counter) -> std::uint64_t
+        { return this->counters->sum(counter); }
+    };
+
+    Stats stats{};
+    stats.hits              = sum(StatsCounters::Counter::HITS);
+    stats.l1_hits           = sum(StatsCounters::Counter::L1_HITS);
+    stats.negative_hits     = sum(StatsCounters::Counter::NEGATIVE_HITS);
+    stats.misses            = sum(StatsCounters::Counter::MISSES);
+    stats.inserts           = sum(StatsCounters::Counter::INSERTS);
+    stats.updates           = sum(StatsCounters::Counter::UPDATES);
+    stats.evictions         = sum(StatsCounters::Counter::EVICTIONS);
+    stats.expirations       = sum(StatsCounters::Counter::EXPIRATIONS);
+    stats.promotions_to_top = sum(StatsCounters::Counter::PROMOTIONS_TO_TOP);
+    stats.promotions_one_up = sum(StatsCounters::Counter::PROMOTIONS_ONE_UP);
+    stats.lock_contentions  = sum(StatsCounters::Counter::LOCK_CONTENTIONS);
+    stats.lock_wait         = std::chrono::nanoseconds{ sum(StatsCounters::Counter::LOCK_WAIT_NS) };
+    return stats;
+}
+
+auto DNSCache::statsEnabled() noexcept(true) -> bool
+{
+#if defined(DNS_CACHE_STATS)
+    return true;
+#else
+    return false;
+#endif
 }
 
 } // net
@@ -0,0 +1,380 @@
+#include "net/snapshot.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace net::snapshot
+{
+
+namespace
+{
+
+inline constexpr std::uint64_t SECTION_ALIGNMENT{ 8 };
+
+///
+/// \brief The Checksum class hashes a stream of bytes in four independent lanes of 64-bit words (xxHash64's
+/// round): it runs at about memory speed, so checking a file costs little more than reading it.
+///
+class Checksum
+{
+private:
+    inline static constexpr std::uint64_t PRIME_1{ 0x9E37'79B1'85EB'CA87ull };
+    inline static constexpr std::uint64_t PRIME_2{ 0xC2B2'AE3D'27D4'EB4Full };
+    inline static constexpr core::Size    BLOCK_SIZE{ 32 };
+
+    std::array<std::uint64_t, 4>      lanes{ PRIME_1 + PRIME_2, PRIME_2, 0, 0 - PRIME_1 };
+    std::array<std::byte, BLOCK_SIZE> pending{};
+    core::Size                        pending_size{ 0 };
+    std::uint64_t                     total_size{ 0 };
+
+    static auto round(std::uint64_t lane, std::uint64_t const word) noexcept(true) -> std::uint64_t
+    {
+        lane += word * PRIME_2;
+        lane  = (lane << 31) | (lane >> 33);
+        return lane * PRIME_1;
+    }
+
+    auto consume(std::byte const* block) noexcept(true) -> void
+    {
+        std::array<std::uint64_t, 4> words;
+        std::memcpy(words.data(), block, sizeof(words));
+        for (core::Size i{ 0 }; i < this->lanes.size(); ++i)
+        { this->lanes[i] = round(this->lanes[i], words[i]); }
+    }
+
+public:
+    auto update(std::byte const* bytes, core::Size size) noexcept(true) -> void
+    {
+        if (0 == size)
+        { return; } // An empty section's data may well be null.
+
+        this->total_size += size;
+
+        if (0 != this->pending_size)
+        {
+            auto const taken{ std::min(size, BLOCK_SIZE - this->pending_size) };
+            std::memcpy(this->pending.data() + this->pending_size, bytes, taken);
+            this->pending_size += taken;
+            bytes += taken;
+            size  -= taken;
+
+            if (BLOCK_SIZE != this->pending_size)
+            { return; }
+
+            this->consume(this->pending.data());
+            this->pending_size = 0;
+        }
+
+        for (; BLOCK_SIZE <= size; bytes += BLOCK_SIZE, size -= BLOCK_SIZE)
+        { this->consume(bytes); }
+
+        std::memcpy(this->pending.data(), bytes, size);
+        this->pending_size = size;
+    }
+
+    [[nodiscard]]
+    auto digest() const noexcept(true) -> std::uint64_t
+    {
+        auto hash{ this->total_size };
+        for (auto const lane : this->lanes)
+        { hash = round(hash, lane); }
+
+        for (core::Size i{ 0 }; i < this->pending_size; ++i)
+        { hash = round(hash, static_cast<std::uint64_t>(this->pending[i])); }
+
+        hash ^= (hash >> 33);
+        hash *= PRIME_2;
+        hash ^= (hash >> 29);
+        return hash;
+    }
+
+}; // Checksum
+
+auto alignUp(std::uint64_t offset) noexcept(true) -> std::uint64_t
+{
+    return ((offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT) * SECTION_ALIGNMENT;
+}
+
+auto hashProbe() noexcept(true) -> std::uint64_t
+{
+    return std::hash<std::string_view>{}(PROBE_KEY);
+}
+
+auto nowMs() noexcept(true) -> std::int64_t
+{
+    auto const since_epoch{ std::chrono::system_clock::now().time_since_epoch() };
+    return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count());
+}
+
+[[noreturn]]
+auto reject(char const* reason) noexcept(false) -> void
+{
+    throw std::runtime_error{ std::string{ "Bad snapshot: " } + reason };
+}
+
+} // anonymous
+
+Writer::Writer() noexcept(false)
+    : saved_at_ms{ nowMs() }
+{}
+
+auto Writer::add(std::string_view key, RecordBlock const& records, std::int64_t ttl_ms) noexcept(false)
+    -> std::uint32_t
+{
+    auto const position{ this->entries.size() - this->runs.back() };
+    if (std::numeric_limits<std::uint32_t>::max() <= position)
+    { throw std::length_error{ "Too many entries in a shard!" }; }
+
+    Entry entry{};
+    entry.key_offset  = this->keys.size();
+    entry.key_length  = static_cast<std::uint8_t>(key.size());
+    entry.ipv4_index  = this->ipv4s.size();
+    entry.ipv4_number = records.ipv4_number;
+    entry.ipv6_index  = this->ipv6s.size();
+    entry.ipv6_number = records.ipv6_number;
+    entry.ttl_ms      = ttl_ms;
+
+    this->keys.insert(this->keys.end(), key.begin(), key.end());
+
+    // The inline records first, then chunk by chunk: same as RecordSetView reads them.
+    auto const inline_ipv4{ std::min<core::Size>(records.ipv4_number, RecordBlock::IPV4_RECORDS) };
+    auto const inline_ipv6{ std::min<core::Size>(records.ipv6_number, RecordBlock::IPV6_RECORDS) };
+    this->ipv4s.insert(this->ipv4s.end(), records.ipv4.begin(), records.ipv4.begin() + inline_ipv4);
+    this->ipv6s.insert(this->ipv6s.end(), records.ipv6.begin(), records.ipv6.begin() + inline_ipv6);
+
+    auto ipv4_left{ records.ipv4_number - inline_ipv4 };
+    auto ipv6_left{ records.ipv6_number - inline_ipv6 };
+    for (auto chunk{ records.overflow }; nullptr != chunk; chunk = chunk->next)
+    {
+        auto const chunk_ipv4{ std::min(ipv4_left, RecordChunk::IPV4_RECORDS) };
+        auto const chunk_ipv6{ std::min(ipv6_left, RecordChunk::IPV6_RECORDS) };
+        this->ipv4s.insert(this->ipv4s.end(), chunk->ipv4.begin(), chunk->ipv4.begin() + chunk_ipv4);
+        this->ipv6s.insert(this->ipv6s.end(), chunk->ipv6.begin(), chunk->ipv6.begin() + chunk_ipv6);
+        ipv4_left -= chunk_ipv4;
+        ipv6_left -= chunk_ipv6;
+    }
+
+    this->entries.push_back(entry);
+    return static_cast<std::uint32_t>(position);
+}
+
+auto Writer::rank(std::uint32_t position) noexcept(false) -> void
+{
+    this->ranks.push_back(position);
+}
+
+auto Writer::closeRun() noexcept(false) -> void
+{
+    if (this->ranks.size() != this->entries.size())
+    { throw std::logic_error{ "Unranked entries!" }; }
+
+    this->runs.push_back(this->entries.size());
+}
+
+auto Writer::write(std::string const& path) const noexcept(false) -> void
+{
+    Header header{};
+    header.magic          = MAGIC;
+    header.version        = VERSION;
+    header.byte_order     = BYTE_ORDER_MARK;
+    header.saved_at_ms    = this->saved_at_ms;
+    header.hash_probe     = hashProbe();
+    header.shards_number  = this->runs.size() - 1;
+    header.entries_number = this->entries.size();
+    header.keys_size      = this->keys.size();
+    header.ipv4_number    = this->ipv4s.size();
+    header.ipv6_number    = this->ipv6s.size();
+
+    struct Section
+    {
+        std::uint64_t* offset;
+        void const*    data;
+        core::Size     size;
+    };
+
+    std::array<Section, 6> const sections{ {
+        { &header.runs_offset,    this->runs.data(),    this->runs.size() * sizeof(std::uint64_t) },
+        { &header.entries_offset, this->entries.data(), this->entries.size() * sizeof(Entry) },
+        { &header.ranks_offset,   this->ranks.data(),   this->ranks.size() * sizeof(std::uint32_t) },
+        { &header.keys_offset,    this->keys.data(),    this->keys.size() },
+        { &header.ipv4_offset,    this->ipv4s.data(),   this->ipv4s.size() * sizeof(IPV4Raw) },
+        { &header.ipv6_offset,    this->ipv6s.data(),   this->ipv6s.size() * sizeof(IPV6Raw) },
+    } };
+
+    std::uint64_t offset{ sizeof(Header) };
+    for (auto const& section : sections)
+    {
+        *section.offset = alignUp(offset);
+        offset          = *section.offset + section.size;
+    }
+
+    header.file_size = offset;
+
+    // The header goes last, once the checksum of the rest is known.
+    auto const temporary_path{ path + ".tmp" };
+    {
+        std::ofstream file{ temporary_path, std::ios::binary | std::ios::trunc };
+
+        Checksum checksum{};
+        std::array<std::byte, SECTION_ALIGNMENT> const padding{};
+        auto const append{
+            [&] (void const* data, core::Size size)
+            {
+                checksum.update(static_cast<std::byte const*>(data), size);
+                file.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+            } // lambda
+        };
+
+        file.seekp(sizeof(Header));
+        offset = sizeof(Header);
+        for (auto const& section : sections)
+        {
+            append(padding.data(), *section.offset - offset);
+            append(section.data, section.size);
+            offset = *section.offset + section.size;
+        }
+
+        header.checksum = checksum.digest();
+        file.seekp(0);
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.flush();
+
+        if (not file)
+        {
+            std::remove(temporary_path.c_str());
+            throw std::runtime_error{ "Couldn't write " + temporary_path };
+        }
+    }
+
+    if (0 != std::rename(temporary_path.c_str(), path.c_str()))
+    {
+        std::remove(temporary_path.c_str());
+        throw std::runtime_error{ "Couldn't replace " + path };
+    }
+}
+
+Reader::Reader(std::string const& path) noexcept(false)
+    : file{ path }
+{
+    this->file.adviseSequential();
+    this->validate();
+}
+
+auto Reader::validate() noexcept(false) -> void
+{
+    if (this->file.bytes() < sizeof(Header))
+    { reject("too short"); }
+
+    this->header = this->section<Header>(0);
+    auto const& header{ *this->header };
+
+    if (MAGIC != header.magic)
+    { reject("not a snapshot"); }
+
+    if ((VERSION != header.version) or (BYTE_ORDER_MARK != header.byte_order))
+    { reject("another version or byte order"); }
+
+    if (header.file_size != this->file.bytes())
+    { reject("truncated"); }
+
+    Checksum checksum{};
+    checksum.update(this->file.data() + sizeof(Header), this->file.bytes() - sizeof(Header));
+    if (header.checksum != checksum.digest())
+    { reject("checksum mismatch"); }
+
+    // Sound from here on, as far as the writer was: the rest only guards against its bugs.
+    auto const fits{
+        [this] (std::uint64_t offset, std::uint64_t number, std::uint64_t element_size) -> bool
+        {
+            auto const size{ this->file.bytes() };
+            return ((0 == (offset % SECTION_ALIGNMENT)) and (offset <= size) and
+                    (number <= ((size - offset) / element_size)));
+        } // lambda
+    };
+
+    if (not fits(header.runs_offset, header.shards_number + 1, sizeof(std::uint64_t)) or
+        not fits(header.entries_offset, header.entries_number, sizeof(Entry)) or
+        not fits(header.ranks_offset, header.entries_number, sizeof(std::uint32_t)) or
+        not fits(header.keys_offset, header.keys_size, 1) or
+        not fits(header.ipv4_offset, header.ipv4_number, sizeof(IPV4Raw)) or
+        not fits(header.ipv6_offset, header.ipv6_number, sizeof(IPV6Raw)))
+    { reject("sections out of bounds"); }
+
+    auto const runs{ this->runs() };
+    if ((0 != runs[0]) or (header.entries_number != runs[header.shards_number]) or
+        not std::is_sorted(runs.begin(), runs.end()))
+    { reject("bad runs"); }
+
+    for (auto const& entry : this->entries())
+    {
+        if ((header.keys_size < entry.key_offset) or
+            ((header.keys_size - entry.key_offset) < entry.key_length) or
+            (header.ipv4_number < entry.ipv4_index) or
+            ((header.ipv4_number - entry.ipv4_index) < entry.ipv4_number) or
+            (header.ipv6_number < entry.ipv6_index) or
+            ((header.ipv6_number - entry.ipv6_index) < entry.ipv6_number))
+        { reject("entry out of bounds"); }
+    }
+
+    // Every run's ranks have to be a permutation of its positions.
+    auto const ranks{ this->ranks() };
+    std::vector<bool> ranked;
+    for (core::Size shard{ 0 }; shard < header.shards_number; ++shard)
+    {
+        ranked.assign(runs[shard + 1] - runs[shard], false);
+        for (core::Size i{ runs[shard] }; i < runs[shard + 1]; ++i)
+        {
+            if ((ranked.size() <= ranks[i]) or ranked[ranks[i]])
+            { reject("bad ranks"); }
+
+            ranked[ranks[i]] = true;
+        }
+    }
+}
+
+auto Reader::shardedAs(core::Size shards_number) const noexcept(true) -> bool
+{
+    return ((shards_number == this->header->shards_number) and (hashProbe() == this->header->hash_probe));
+}
+
+auto Reader::age() const noexcept(true) -> std::chrono::milliseconds
+{
+    return std::chrono::milliseconds{ std::max<std::int64_t>(nowMs() - this->header->saved_at_ms, 0) };
+}
+
+auto Reader::entries() const noexcept(true) -> core::Span<Entry const>
+{
+    return { this->section<Entry>(this->header->entries_offset), this->header->entries_number };
+}
+
+auto Reader::runs() const noexcept(true) -> core::Span<std::uint64_t const>
+{
+    return { this->section<std::uint64_t>(this->header->runs_offset), this->header->shards_number + 1 };
+}
+
+auto Reader::ranks() const noexcept(true) -> core::Span<std::uint32_t const>
+{
+    return { this->section<std::uint32_t>(this->header->ranks_offset), this->header->entries_number };
+}
+
+auto Reader::key(Entry const& entry) const noexcept(true) -> std::string_view
+{
+    return { this->section<char>(this->header->keys_offset) + entry.key_offset, entry.key_length };
+}
+
+auto Reader::ipv4s(Entry const& entry) const noexcept(true) -> core::Span<IPV4Raw const>
+{
+    return { this->section<IPV4Raw>(this->header->ipv4_offset) + entry.ipv4_index, entry.ipv4_number };
+}
+
+auto Reader::ipv6s(Entry const& entry) const noexcept(true) -> core::Span<IPV6Raw const>
+{
+    return { this->section<IPV6Raw>(this->header->ipv6_offset) + entry.ipv6_index, entry.ipv6_number };
+}
+
+} // net::snapshot
@@ -36,4 +36,79 @@ auto IPV4RawToStr(IPV4Raw raw_ip) noexcept(true) -> IPV4StrResult
     return std::nullopt;
 }
 
+auto strToIPV6Raw(std::string const& str_ip) noexcept(true) -> IPV6RawResult
+{
+    constexpr auto INET_PTON_SUCCESS{ 1 };
+
+    IPV6Raw raw_ip{};
+    auto ip_convert_status{
+        ::inet_pton(AF_INET6, str_ip.c_str(), raw_ip.data())
+    };
+
+    if (INET_PTON_SUCCESS == ip_convert_status)
+    { return IPV6RawResult{raw_ip}; }
+
+    return std::nullopt;
+}
+
+auto IPV6RawToStr(IPV6Raw const& raw_ip) noexcept(true) -> IPV6StrResult
+{
+    std::array<char, INET6_ADDRSTRLEN> ip_buffer{};
+
+    if (::inet_ntop(AF_INET6, raw_ip.data(), ip_buffer.data(), INET6_ADDRSTRLEN))
+    { return IPV6StrResult{ ip_buffer.data() }; }
+
+    return std::nullopt;
+}
+
+namespace
+{
+
+///
+/// \brief popLabel cuts the last label off `name`; `more` is left false once it's been the first one.
+///
+auto popLabel(std::string_view& name, bool& more) noexcept(true) -> std::string_view
+{
+    auto const dot{ name.rfind('.') };
+    if (std::string_view::npos == dot)
+    {
+        more = false;
+        return name;
+    }
+
+    auto const label{ name.substr(dot + 1) };
+    name.remove_suffix(name.size() - dot);
+    return label;
+}
+
+} // anonymous
+
+auto compareReversedLabels(std::string_view lhs, std::string_view rhs) noexcept(true) -> int
+{
+    auto lhs_more{ true };
+    auto rhs_more{ true };
+    while (lhs_more and rhs_more)
+    {
+        auto const lhs_label{ popLabel(lhs, lhs_more) };
+        auto const rhs_label{ popLabel(rhs, rhs_more) };
+        if (auto const cmp_result{ lhs_label.compare(rhs_label) };
+            0 != cmp_result)
+        { return cmp_result; }
+    }
+
+    // A domain goes before the names under it.
+    return (lhs_more ? 1 : 0) - (rhs_more ? 1 : 0);
+}
+
+auto isUnderDomain(std::string_view const fqdn, std::string_view const domain) noexcept(true) -> bool
+{
+    if (domain.empty())
+    { return true; }
+
+    if ((fqdn.size() < domain.size()) or (0 != fqdn.compare(fqdn.size() - domain.size(), domain.size(), domain)))
+    { return false; }
+
+    return (fqdn.size() == domain.size()) or ('.' == fqdn[fqdn.size() - domain.size() - 1]);
+}
+
 } // net
@@ -0,0 +1,273 @@
+#include <core/clock.hpp>
+#include <core/ladder.hpp>
+#include <core/links.hpp>
+
+#include <boost/ut.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <set>
+#include <vector>
+
+struct ClockNode
+    : public core::Clock<ClockNode>::NodeTrait
+{}; // ClockNode
+
+struct LadderNode
+    : public core::Ladder<LadderNode>::NodeTrait
+{}; // LadderNode
+
+template <template <typename, typename> class Replacement>
+struct CompactNode
+    : public Replacement<CompactNode<Replacement>, core::CompactLinks<CompactNode<Replacement>>>::NodeTrait
+{
+    std::uint32_t slot{};
+
+}; // CompactNode
+
+///
+/// \brief checkSecondChance holds for both policies: they're interchangeable in the cache.
+///
+template <template <typename> class Replacement, typename Node>
+auto checkSecondChance() -> void
+{
+    using namespace boost::ut;
+    using Policy = Replacement<Node>;
+
+    constexpr std::size_t capacity{ 8 };
+    auto storage{ std::make_unique<Node[]>(capacity) };
+    Policy policy{ storage.get(), capacity };
+
+    // Every node but #2 and #5 is referenced: those two are the victims, in order.
+    for (std::size_t i{ 0 }; i < capacity; ++i)
+    {
+        if ((2 != i) and (5 != i))
+        { Policy::reference(&storage[i]); }
+    }
+
+    auto first{ policy.releaseBottom() };
+    auto second{ policy.releaseBottom() };
+    expect((&storage[2] == first) and (&storage[5] == second)) << "A referenced node was released!";
+
+    (void)policy.promote(first, Policy::TO_TOP);
+    (void)policy.promote(second, Policy::TO_TOP);
+
+    // All the marks are gone now: each node comes out exactly once, the re-inserted ones last.
+    std::set<Node*> released;
+    for (std::size_t i{ 0 }; i < capacity; ++i)
+    { released.insert(policy.releaseBottom()); }
+
+    expect(capacity == released.size()) << "A node was released twice!";
+
+    // A demoted node is the next victim, whatever its mark.
+    for (auto node : released)
+    { (void)policy.promote(node, Policy::TO_TOP); }
+
+    Policy::reference(&storage[7]);
+    (void)policy.demote(&storage[7], Policy::TO_BOTTOM);
+    expect(&storage[7] == policy.releaseBottom()) << "The demoted node isn't the next victim!";
+}
+
+///
+/// \brief checkResize holds for both policies: growing puts the new nodes under the next victim, and a node
+/// that takes another's place takes its turn as well.
+///
+template <template <typename> class Replacement, typename Node>
+auto checkResize() -> void
+{
+    using namespace boost::ut;
+    using Policy = Replacement<Node>;
+
+    constexpr std::size_t capacity{ 8 };
+    constexpr std::size_t added{ 4 };
+    auto storage{ std::make_unique<Node[]>(capacity) };
+    auto added_storage{ std::make_unique<Node[]>(added + 1) };
+    Policy policy{ storage.get(), capacity };
+
+    Node* added_nodes[added]{};
+    for (std::size_t i{ 0 }; i < added; ++i)
+    { added_nodes[i] = &added_storage[i]; }
+
+    policy.extend(core::Span<Node* const>{ added_nodes, added });
+    expect((capacity + added) == policy.maxSize()) << "Bad size after extending!";
+
+    for (std::size_t i{ 0 }; i < added; ++i)
+    {
+        auto const released{ policy.releaseBottom() };
+        expect(added_nodes[i] == released) << "The added nodes aren't the next victims!";
+        (void)policy.promote(released, Policy::TO_TOP);
+    }
+
+    // The first node is the next victim now: the spare one takes its place.
+    auto const spare{ &added_storage[added] };
+    policy.replace(&storage[0], spare);
+    expect(spare == policy.releaseBottom()) << "The replacing node hasn't taken the victim's turn!";
+    (void)policy.promote(spare, Policy::TO_TOP);
+
+    expect(&storage[1] == policy.shed()) << "Shed a node out of turn!";
+    expect((capacity + added - 1) == policy.maxSize()) << "Bad size after shedding!";
+}
+
+///
+/// \brief checkCompactLinks holds for both policies: w/ the links as slots, the nodes of two slabs are
+/// released in the same order as w/ the pointers.
+///
+template <template <typename, typename> class Replacement>
+auto checkCompactLinks() -> void
+{
+    using namespace boost::ut;
+    using Node   = CompactNode<Replacement>;
+    using Links  = core::CompactLinks<Node>;
+    using Policy = Replacement<Node, Links>;
+
+    using PointerPolicy = Replacement<Node, core::PointerLinks<Node>>;
+    static_assert(sizeof(typename Policy::NodeTrait) < sizeof(typename PointerPolicy::NodeTrait));
+
+    // More than a block, so the slots of the second slab don't follow on from the first's.
+    constexpr std::size_t capacity{ core::SlotTable<Node>::BLOCK_SIZE + 3 };
+    constexpr std::size_t added{ 2 };
+    auto storage{ std::make_unique<Node[]>(capacity) };
+    auto added_storage{ std::make_unique<Node[]>(added) };
+
+    core::SlotTable<Node> slots{};
+    for (auto const& [nodes, count] : { std::pair{ storage.get(), capacity },
+                                        std::pair{ added_storage.get(), added } })
+    {
+        auto const first{ slots.add(nodes, count) };
+        for (std::size_t i{ 0 }; i < count; ++i)
+        { nodes[i].slot = static_cast<std::uint32_t>(first + i); }
+    }
+
+    expect(&added_storage[1] == slots.at(added_storage[1].slot)) << "Bad node of a slot!";
+    expect(nullptr == slots.at(core::SlotTable<Node>::NO_SLOT)) << "A node of no slot!";
+
+    Policy policy{ storage.get(), capacity, Links{ &slots } };
+    Node* added_nodes[added]{ &added_storage[0], &added_storage[1] };
+    policy.extend(core::Span<Node* const>{ added_nodes, added });
+
+    Policy::reference(&storage[0]);
+    expect(&added_storage[0] == policy.releaseBottom()) << "The added nodes aren't the next victims!";
+    expect(&added_storage[1] == policy.releaseBottom()) << "The added nodes aren't the next victims!";
+    expect(&storage[1] == policy.releaseBottom()) << "A referenced node was released!";
+
+    // The last node's the one before the referenced one w/ its second chance.
+    for (std::size_t i{ 2 }; i < capacity; ++i)
+    { expect(&storage[i] == policy.releaseBottom()) << "Released out of order: " << i; }
+
+    expect(&storage[0] == policy.releaseBottom()) << "The referenced node hasn't come last!";
+}
+
+///
+/// \brief The LadderStep struct is a promotion or a demotion of a node of checkLadderRelinks()'s ladder.
+///
+struct LadderStep
+{
+    enum class Kind : std::uint8_t
+    {
+        TO_TOP,
+        ONE_UP,
+        TO_BOTTOM
+    };
+
+    Kind        kind;
+    std::size_t node;
+    bool        moves{ true }; // false for the top's promotions: NON_PROMOTABLE, nothing's relinked.
+};
+
+///
+/// \brief checkLadderRelinks takes the steps on a ladder of 5 nodes, #0 at the bottom up to #4 at the top,
+/// then releases them all: they have to come out in the `expected` order, from the bottom up.
+/// \details The releases follow the nodes' next links, the steps after the first one their prev links as well.
+///
+auto checkLadderRelinks(std::initializer_list<LadderStep> steps, std::vector<std::size_t> const& expected) -> void
+{
+    using namespace boost::ut;
+    using Policy = core::Ladder<LadderNode>;
+
+    constexpr std::size_t capacity{ 5 };
+    auto storage{ std::make_unique<LadderNode[]>(capacity) };
+    Policy policy{ storage.get(), capacity };
+
+    for (auto const& step : steps)
+    {
+        auto const node{ &storage[step.node] };
+        if (LadderStep::Kind::TO_BOTTOM == step.kind)
+        {
+            expect(Policy::DemotingStatus::SUCCESS == policy.demote(node, Policy::TO_BOTTOM))
+                << "Bad demoting status of #" << step.node;
+            continue;
+        }
+
+        auto const status{
+            (LadderStep::Kind::TO_TOP == step.kind) ? policy.promote(node, Policy::TO_TOP)
+                                                    : policy.promote(node, Policy::ONE_UP)
+        };
+
+        auto const expected_status{ step.moves ? Policy::PromotingStatus::SUCCESS
+                                               : Policy::PromotingStatus::NON_PROMOTABLE };
+        expect(expected_status == status) << "Bad promoting status of #" << step.node;
+    }
+
+    for (auto const i : expected)
+    { expect(&storage[i] == policy.releaseBottom()) << "Released out of order, expected #" << i; }
+}
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
+{
+    using namespace boost::ut::literals;
+    using namespace boost::ut;
+
+    "ladder_second_chance"_test = []
+    { checkSecondChance<core::Ladder, LadderNode>(); };
+
+    "clock_second_chance"_test = []
+    { checkSecondChance<core::Clock, ClockNode>(); };
+
+    "ladder_resize"_test = []
+    { checkResize<core::Ladder, LadderNode>(); };
+
+    "clock_resize"_test = []
+    { checkResize<core::Clock, ClockNode>(); };
+
+    "ladder_compact_links"_test = []
+    { checkCompactLinks<core::Ladder>(); };
+
+    "clock_compact_links"_test = []
+    { checkCompactLinks<core::Clock>(); };
+
+    "ladder_promote_relinks"_test = []
+    {
+        using Kind = LadderStep::Kind;
+
+        checkLadderRelinks({ { Kind::TO_TOP, 0 } }, { 1, 2, 3, 4, 0 });
+        checkLadderRelinks({ { Kind::TO_TOP, 2 } }, { 0, 1, 3, 4, 2 });
+        checkLadderRelinks({ { Kind::TO_TOP, 4, false } }, { 0, 1, 2, 3, 4 });
+
+        checkLadderRelinks({ { Kind::ONE_UP, 0 } }, { 1, 0, 2, 3, 4 });
+        checkLadderRelinks({ { Kind::ONE_UP, 2 } }, { 0, 1, 3, 2, 4 });
+        checkLadderRelinks({ { Kind::ONE_UP, 3 } }, { 0, 1, 2, 4, 3 });
+        checkLadderRelinks({ { Kind::ONE_UP, 4, false } }, { 0, 1, 2, 3, 4 });
+
+        // Every step starts from where the previous ones have left the links.
+        checkLadderRelinks(
+            { { Kind::ONE_UP, 0 }, { Kind::TO_TOP, 2 }, { Kind::ONE_UP, 4 }, { Kind::TO_TOP, 1 },
+              { Kind::ONE_UP, 0 }, { Kind::TO_BOTTOM, 4 }, { Kind::ONE_UP, 1, false } },
+            { 4, 3, 0, 2, 1 }
+        );
+    };
+
+    // A hit or an update must not relink: the hand only moves on releasing.
+    "clock_one_up_only_marks"_test = []
+    {
+        constexpr std::size_t capacity{ 4 };
+        auto storage{ std::make_unique<ClockNode[]>(capacity) };
+        core::Clock<ClockNode> clock{ storage.get(), capacity };
+
+        expect(core::Clock<ClockNode>::PromotingStatus::SUCCESS ==
+               clock.promote(&storage[0], core::Clock<ClockNode>::ONE_UP)) << "Bad promoting status!";
+        expect(&storage[1] == clock.releaseBottom()) << "The updated node wasn't skipped!";
+        expect(&storage[2] == clock.releaseBottom()) << "The ring order has changed!";
+    };
+}
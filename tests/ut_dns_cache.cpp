@@ -3,8 +3,20 @@
 
 #include <boost/ut.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
 #include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 auto generatePseudoDomain(net::IP const& ip) -> net::FQDN
@@ -102,13 +114,13 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
 
             for (i = 0 ; i < test_data_size; ++i)
             {
-                expect(current_size == dns_cache.size()) << "Bad size after creation!";
+                expect(std::min(current_size, capacity) == dns_cache.size()) << "Bad size after creation!";
                 expect(test_data[i].first != "subd0.subd0.subd0.subd0.test.domain");
 
                 dns_cache.update(test_data[i].first, test_data[i].second);
                 ++current_size;
 
-                expect((current_size % capacity) == dns_cache.size()) << "Bad size!";
+                expect(std::min(current_size, capacity) == dns_cache.size()) << "Bad size!";
 
                 auto result_ip{ dns_cache.resolve(test_data[i].first) };
 
@@ -124,7 +136,7 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
                 {
                     std::cout << "ex: " << test_data[i].first << std::endl;
                     auto result_ip{ dns_cache.resolve(test_data[i].first) };
-                    expect(result_ip == test_data[i].first);
+                    expect(result_ip == test_data[i].second);
                 }
             };
 
@@ -144,4 +156,1211 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
             expect(false) << "Got exception{" << i << "}: " << excp.what();
         }
     };
+
+    "sharded_non_overfilling"_test = []
+    {
+        constexpr Size shards{ 8 };
+        auto capacity{ shards * 64 * DNSCache::minViableCapacity() };
+        // Half the capacity, so an uneven hash spread doesn't make any shard evict.
+        auto test_data{ generateTestData(capacity / 2) };
+
+        try
+        {
+            DNSCache dns_cache{ capacity, shards };
+            expect(shards == dns_cache.shardsNumber()) << "Bad shards number!";
+            expect(capacity == dns_cache.maxSize()) << "Shards' max sizes don't add up!";
+
+            for (auto const& [fqdn, ip] : test_data)
+            { dns_cache.update(fqdn, ip); }
+
+            expect(test_data.size() == dns_cache.size()) << "Shards' sizes don't add up!";
+
+            for (auto const& [fqdn, ip] : test_data)
+            { expect(ip == dns_cache.resolve(fqdn)) << "Got wrong value for " << fqdn; }
+        }
+        catch (std::exception const& excp)
+        {
+            expect(false) << "Got exception: " << excp.what();
+        }
+    };
+
+    "too_long_fqdn"_test = []
+    {
+        DNSCache dns_cache{ DNSCache::minViableCapacity() };
+        FQDN const longest(MAX_FQDN_LENGTH, 'a');
+        FQDN const too_long(MAX_FQDN_LENGTH + 1, 'a');
+
+        dns_cache.update(longest, "1.2.3.4");
+        expect("1.2.3.4" == dns_cache.resolve(longest)) << "The longest name isn't cached!";
+
+        auto thrown{ false };
+        try
+        { dns_cache.update(too_long, "1.2.3.4"); }
+        catch (std::length_error const&)
+        { thrown = true; }
+
+        expect(thrown) << "A too long name is accepted!";
+        expect(dns_cache.resolve(too_long).empty()) << "A too long name is resolved!";
+    };
+
+    "raw_ipv4_round_trip"_test = []
+    {
+        DNSCache dns_cache{ DNSCache::minViableCapacity() };
+        FQDN const fqdn{ "subd1.subd2.subd3.subd4.test.domain" };
+        auto const raw_ip{ strToIPV4Raw("1.2.3.4").value_or(0) };
+
+        expect(not dns_cache.resolveRaw(fqdn).has_value()) << "Resolved before the update!";
+
+        dns_cache.update(fqdn, raw_ip);
+        expect(raw_ip == dns_cache.resolveRaw(fqdn).value_or(0)) << "Got wrong raw value!";
+        expect("1.2.3.4" == dns_cache.resolve(fqdn)) << "The raw and the textual APIs disagree!";
+
+        dns_cache.update(fqdn, IP{ "4.3.2.1" });
+        expect(strToIPV4Raw("4.3.2.1") == dns_cache.resolveRaw(fqdn)) << "The textual update isn't seen raw!";
+    };
+
+    "batches"_test = []
+    {
+        constexpr std::size_t capacity{ 1'000 };
+        constexpr std::size_t names_number{ 3 * capacity / 2 };
+
+        DNSCache dns_cache{ capacity, 4 };
+
+        // Overfilling, w/ the first name updated twice: the last one in the batch wins.
+        std::vector<FQDN> fqdns;
+        std::vector<IPV4Raw> raw_ips;
+        for (std::size_t i{ 0 }; i < names_number; ++i)
+        {
+            fqdns.push_back("batch" + std::to_string(i) + ".test.domain");
+            raw_ips.push_back(static_cast<IPV4Raw>(i + 1));
+        }
+        fqdns.push_back(fqdns.front());
+        raw_ips.push_back(0xFF'FF'FF'FF);
+
+        dns_cache.updateBatch(fqdns, raw_ips);
+        expect(capacity == dns_cache.size()) << "Bad size after a batch update!";
+
+        fqdns.push_back("absent.test.domain");
+        fqdns.push_back(FQDN(MAX_FQDN_LENGTH + 1, 'x'));
+
+        std::vector<std::optional<IPV4Raw>> resolved(fqdns.size());
+        dns_cache.resolveBatch(fqdns, resolved);
+
+        std::size_t mismatches{ 0 };
+        std::size_t hits{ 0 };
+        for (std::size_t i{ 0 }; i < fqdns.size(); ++i)
+        {
+            mismatches += ((dns_cache.resolveRaw(fqdns[i]) != resolved[i]) ? 1 : 0);
+            hits += (resolved[i].has_value() ? 1 : 0);
+        }
+
+        expect(0 == mismatches) << mismatches << " batched resolves disagree w/ the single ones!";
+        expect(capacity < hits) << "Too few hits: " << hits;
+        expect(IPV4Raw{ 0xFF'FF'FF'FF } == dns_cache.resolveRaw(fqdns.front()).value_or(0))
+            << "The batch's updates were applied out of order!";
+
+        auto mismatch_thrown{ false };
+        try
+        { dns_cache.resolveBatch(fqdns, Span<std::optional<IPV4Raw>>{}); }
+        catch (std::logic_error const&)
+        { mismatch_thrown = true; }
+
+        expect(mismatch_thrown) << "Spans of different sizes are accepted!";
+
+        auto too_long_thrown{ false };
+        try
+        { dns_cache.updateBatch(fqdns, std::vector<IPV4Raw>(fqdns.size())); }
+        catch (std::length_error const&)
+        { too_long_thrown = true; }
+
+        expect(too_long_thrown) << "A batch w/ a too long name is accepted!";
+        expect(not dns_cache.resolveRaw("absent.test.domain").has_value()) << "A rejected batch was applied!";
+    };
+
+    "stats"_test = []
+    {
+        DNSCache dns_cache{ 4 };
+        for (auto const fqdn : { "a.test.domain", "b.test.domain", "c.test.domain", "d.test.domain" })
+        { dns_cache.update(fqdn, IP{ "1.1.1.1" }); }
+
+        dns_cache.update("a.test.domain", IP{ "2.2.2.2" });
+        dns_cache.update("e.test.domain", IP{ "3.3.3.3" });
+
+        expect("3.3.3.3" == dns_cache.resolve("e.test.domain")) << "Just cached, yet not resolved!";
+        expect(dns_cache.resolve("absent.test.domain").empty()) << "Resolved a name never cached!";
+        expect(dns_cache.resolve(FQDN(MAX_FQDN_LENGTH + 1, 'x')).empty()) << "Resolved a too long name!";
+
+        auto const stats{ dns_cache.stats() };
+        if (not DNSCache::statsEnabled())
+        {
+            expect((0 == stats.hits) and (0 == stats.inserts)) << "Counting w/o DNS_CACHE_STATS!";
+            return;
+        }
+
+        expect(1 == stats.hits) << "Bad hits: " << stats.hits;
+        expect(2 == stats.misses) << "Bad misses: " << stats.misses;
+        expect(5 == stats.inserts) << "Bad inserts: " << stats.inserts;
+        expect(1 == stats.updates) << "Bad updates: " << stats.updates;
+        expect(1 == stats.evictions) << "Bad evictions: " << stats.evictions;
+        expect(0 == stats.expirations) << "Bad expirations: " << stats.expirations;
+        expect(5 == stats.promotions_to_top) << "Bad promotions to the top: " << stats.promotions_to_top;
+        expect(1 == stats.promotions_one_up) << "Bad promotions one up: " << stats.promotions_one_up;
+        expect(0 == stats.lock_contentions) << "Contended w/ a single thread!";
+    };
+
+    "record_sets"_test = []
+    {
+        DNSCache dns_cache{ DNSCache::minViableCapacity() };
+        FQDN const fqdn{ "subd1.subd2.subd3.subd4.test.domain" };
+
+        std::vector<IPV4Raw> ipv4s(100);
+        std::iota(ipv4s.begin(), ipv4s.end(), 0x01'01'01'01);
+        std::vector<IPV6Raw> ipv6s(10);
+        for (std::size_t i{ 0 }; i < ipv6s.size(); ++i)
+        { ipv6s[i] = strToIPV6Raw("2001:db8::" + std::to_string(i + 1)).value_or(IPV6Raw{}); }
+
+        expect(not dns_cache.resolveAll(fqdn).has_value()) << "Resolved before the update!";
+
+        dns_cache.update(fqdn, ipv4s, ipv6s);
+        auto const held{ dns_cache.resolveAll(fqdn) };
+        expect(held.has_value()) << "The record set is missing!";
+        if (not held.has_value())
+        { return; }
+
+        // Replacing the set while the view's held must leave the view intact.
+        dns_cache.update(fqdn, core::Span<IPV4Raw const>{ ipv4s.data(), 1 }, {});
+
+        expect(ipv4s.size() == held->ipv4Number()) << "Got wrong A records number!";
+        expect(ipv6s.size() == held->ipv6Number()) << "Got wrong AAAA records number!";
+        for (std::size_t i{ 0 }; i < ipv4s.size(); ++i)
+        { expect(ipv4s[i] == held->ipv4(i)) << "Got wrong A record #" << i; }
+        for (std::size_t i{ 0 }; i < ipv6s.size(); ++i)
+        { expect(ipv6s[i] == held->ipv6(i)) << "Got wrong AAAA record #" << i; }
+
+        auto const replaced{ dns_cache.resolveAll(fqdn) };
+        expect((1 == replaced->ipv4Number()) and (0 == replaced->ipv6Number())) << "The update wasn't seen!";
+        expect(ipv4s.front() == dns_cache.resolveRaw(fqdn).value_or(0)) << "Got wrong first A record!";
+    };
+
+    "ttl_expiry"_test = []
+    {
+        using namespace std::chrono_literals;
+
+        constexpr std::size_t capacity{ 16 };
+        constexpr std::size_t expiring_number{ capacity - 2 };
+        DNSCache dns_cache{ capacity };
+
+        dns_cache.update("zero.test.domain", IP{ "1.1.1.1" }, 0ms);
+        expect(dns_cache.resolve("zero.test.domain").empty()) << "A zero TTL has been cached!";
+
+        // The live entries go first, so they're the eviction candidates unless the expired nodes are reused.
+        dns_cache.update("long.test.domain", IP{ "3.3.3.3" }, 1h);
+        dns_cache.update("forever.test.domain", IP{ "4.4.4.4" });
+        for (std::size_t i{ 0 }; i < expiring_number; ++i)
+        { dns_cache.update("short" + std::to_string(i) + ".test.domain", IP{ "2.2.2.2" }, 20ms); }
+
+        expect("2.2.2.2" == dns_cache.resolve("short0.test.domain")) << "Expired too early!";
+
+        std::this_thread::sleep_for(30ms);
+
+        for (std::size_t i{ 0 }; i < expiring_number; ++i)
+        {
+            expect(dns_cache.resolve("short" + std::to_string(i) + ".test.domain").empty())
+                << "short" << i << " hasn't expired!";
+        }
+
+        // The first update reclaims the expired ones.
+        dns_cache.update("fresh0.test.domain", IP{ "5.5.5.5" });
+        expect(3 == dns_cache.size()) << "The expired entries haven't been reclaimed!";
+
+        for (std::size_t i{ 1 }; i < expiring_number; ++i)
+        { dns_cache.update("fresh" + std::to_string(i) + ".test.domain", IP{ "5.5.5.5" }); }
+
+        expect(capacity == dns_cache.size()) << "Bad size after refilling!";
+        expect("3.3.3.3" == dns_cache.resolve("long.test.domain")) << "A live entry was evicted first!";
+        expect("4.4.4.4" == dns_cache.resolve("forever.test.domain")) << "A live entry was evicted first!";
+
+        // Refreshing w/o a TTL cancels the expiry.
+        dns_cache.update("long.test.domain", IP{ "3.3.3.3" }, 10ms);
+        dns_cache.update("long.test.domain", IP{ "3.3.3.4" });
+        std::this_thread::sleep_for(20ms);
+        expect("3.3.3.4" == dns_cache.resolve("long.test.domain")) << "A refreshed entry has expired!";
+    };
+
+    "negative_caching"_test = []
+    {
+        using namespace std::chrono_literals;
+
+        constexpr std::size_t capacity{ 16 };
+        constexpr std::size_t negative_capacity{ 8 };
+        DNSCache dns_cache{ capacity, 1, DNSCache::Admission::ALWAYS, negative_capacity };
+
+        dns_cache.updateNegative("nxdomain.test.domain", Negative::NXDOMAIN, 1h);
+        dns_cache.updateNegative("nodata.test.domain", Negative::NODATA, 1h);
+
+        auto const nxdomain{ dns_cache.lookup("nxdomain.test.domain") };
+        expect(DNSCache::Outcome::NEGATIVE_HIT == nxdomain.outcome) << "NXDOMAIN isn't a negative hit!";
+        expect(Negative::NXDOMAIN == nxdomain.negative) << "Bad negative answer!";
+        expect(not nxdomain.ipv4.has_value()) << "A negative hit w/ a record!";
+        expect(Negative::NODATA == dns_cache.lookup("nodata.test.domain").negative) << "Bad negative answer!";
+        expect(DNSCache::Outcome::MISS == dns_cache.lookup("unknown.test.domain").outcome) << "Not a miss!";
+
+        // The other resolves don't tell a negative hit from a miss.
+        expect(dns_cache.resolve("nxdomain.test.domain").empty()) << "Resolved a negative entry!";
+        expect(not dns_cache.resolveAll("nxdomain.test.domain").has_value()) << "Resolved a negative entry!";
+
+        // An entry turns from positive to negative and back.
+        dns_cache.update("flip.test.domain", IP{ "1.1.1.1" });
+        auto const hit{ dns_cache.lookup("flip.test.domain") };
+        expect(DNSCache::Outcome::HIT == hit.outcome) << "Not a hit!";
+        expect(hit.ipv4.has_value() and ("1.1.1.1" == IPV4RawToStr(*hit.ipv4).value_or(IP{}))) << "Bad hit!";
+
+        dns_cache.updateNegative("flip.test.domain", Negative::NXDOMAIN, 1h);
+        expect(DNSCache::Outcome::NEGATIVE_HIT == dns_cache.lookup("flip.test.domain").outcome)
+            << "The records have outlived a negative answer!";
+
+        dns_cache.update("flip.test.domain", IP{ "2.2.2.2" });
+        expect("2.2.2.2" == dns_cache.resolve("flip.test.domain")) << "A negative entry has outlived the records!";
+        expect(3 == dns_cache.size()) << "Bad size w/ the negative entries!";
+
+        // A flood of names that don't exist evicts only the negative entries: flip.test.domain and these fill
+        // the positive budget.
+        for (std::size_t i{ 1 }; i < capacity; ++i)
+        { dns_cache.update("name" + std::to_string(i) + ".test.domain", IP{ "3.3.3.3" }); }
+
+        for (std::size_t i{ 0 }; i < 1000; ++i)
+        { dns_cache.updateNegative("junk" + std::to_string(i) + ".test.domain", Negative::NXDOMAIN, 1h); }
+
+        expect((capacity + negative_capacity) == dns_cache.size()) << "Bad size after the flood!";
+        for (std::size_t i{ 1 }; i < capacity; ++i)
+        {
+            expect("3.3.3.3" == dns_cache.resolve("name" + std::to_string(i) + ".test.domain"))
+                << "name" << i << " was evicted by the negative entries!";
+        }
+
+        // The negative TTL expires like any other.
+        dns_cache.updateNegative("short.test.domain", Negative::NODATA, 10ms);
+        std::this_thread::sleep_for(20ms);
+        expect(DNSCache::Outcome::MISS == dns_cache.lookup("short.test.domain").outcome) << "Hasn't expired!";
+
+        // W/o a budget, the negative answers aren't cached.
+        DNSCache positive_only{ capacity };
+        positive_only.update("name.test.domain", IP{ "4.4.4.4" });
+        positive_only.updateNegative("name.test.domain", Negative::NXDOMAIN, 1h);
+        expect(DNSCache::Outcome::HIT == positive_only.lookup("name.test.domain").outcome)
+            << "Cached a negative answer w/o a budget!";
+
+        auto refused{ false };
+        try
+        {
+            dns_cache.updateNegative("name.test.domain", Negative::NONE, 1h);
+        }
+        catch (std::logic_error const&)
+        { refused = true; }
+
+        expect(refused) << "Cached NONE as a negative answer!";
+
+        refused = false;
+        try
+        {
+            DNSCache too_small{ capacity, 1, DNSCache::Admission::ALWAYS, 1 };
+        }
+        catch (std::logic_error const&)
+        { refused = true; }
+
+        expect(refused) << "Accepted a negative budget too small for a queue!";
+
+        if (DNSCache::statsEnabled())
+        { expect(0 < dns_cache.stats().negative_hits) << "The negative hits haven't been counted!"; }
+    };
+
+    "l1_front_cache"_test = []
+    {
+        using namespace std::chrono_literals;
+
+        constexpr std::size_t capacity{ 16 };
+        DNSCache dns_cache{ capacity };
+        dns_cache.enableL1();
+
+        dns_cache.update("hot.test.domain", IP{ "1.1.1.1" });
+        expect("1.1.1.1" == dns_cache.resolve("hot.test.domain")) << "Bad IP!";
+        expect("1.1.1.1" == dns_cache.resolve("hot.test.domain")) << "Bad IP from the L1!";
+
+        // An update, of the name or of another one, leaves nothing stale behind.
+        dns_cache.update("hot.test.domain", IP{ "2.2.2.2" });
+        expect("2.2.2.2" == dns_cache.resolve("hot.test.domain")) << "A stale IP from the L1!";
+        dns_cache.update("other.test.domain", IP{ "3.3.3.3" });
+        expect("2.2.2.2" == dns_cache.resolve("hot.test.domain")) << "Bad IP!";
+        expect("2.2.2.2" == dns_cache.resolve("hot.test.domain")) << "Bad IP from the L1!";
+
+        // Nor does an eviction.
+        for (std::size_t i{ 0 }; i < (4 * capacity); ++i)
+        { dns_cache.update("name" + std::to_string(i) + ".test.domain", IP{ "4.4.4.4" }); }
+
+        expect(DNSCache::Outcome::MISS == dns_cache.lookup("hot.test.domain").outcome) << "Not evicted!";
+        expect(dns_cache.resolve("hot.test.domain").empty()) << "Resolved an evicted name from the L1!";
+
+        // Nor an expiry, though nothing's been written since.
+        dns_cache.update("short.test.domain", IP{ "5.5.5.5" }, 20ms);
+        expect("5.5.5.5" == dns_cache.resolve("short.test.domain")) << "Bad IP!";
+        expect("5.5.5.5" == dns_cache.resolve("short.test.domain")) << "Bad IP from the L1!";
+        std::this_thread::sleep_for(30ms);
+        expect(dns_cache.resolve("short.test.domain").empty()) << "Resolved an expired name from the L1!";
+
+        // The names too long for the L1 are resolved all the same.
+        FQDN const long_name{ std::string(100, 'x') + ".test.domain" };
+        dns_cache.update(long_name, IP{ "6.6.6.6" });
+        expect("6.6.6.6" == dns_cache.resolve(long_name)) << "Bad IP of a long name!";
+        expect("6.6.6.6" == dns_cache.resolve(long_name)) << "Bad IP of a long name!";
+
+        // A thread's L1 doesn't mix up the caches.
+        DNSCache another{ capacity, 2 };
+        another.enableL1();
+        another.update("name63.test.domain", IP{ "7.7.7.7" });
+        expect("7.7.7.7" == another.resolve("name63.test.domain")) << "Bad IP from another cache!";
+        expect("4.4.4.4" == dns_cache.resolve("name63.test.domain")) << "Bad IP after another cache's!";
+        expect("7.7.7.7" == another.resolve("name63.test.domain")) << "Bad IP from another cache!";
+
+        // Every thread has an L1 of its own.
+        auto all_resolved{ true };
+        std::thread reader{
+            [&]
+            {
+                for (std::size_t i{ 0 }; i < 4; ++i)
+                { all_resolved = all_resolved and ("4.4.4.4" == dns_cache.resolve("name62.test.domain")); }
+            } // lambda
+        };
+
+        reader.join();
+        expect(all_resolved) << "Bad IP in another thread!";
+
+        if (DNSCache::statsEnabled())
+        { expect(0 < dns_cache.stats().l1_hits) << "The L1 hits haven't been counted!"; }
+    };
+
+    // A thread that alternates between caches keeps an L1 for each, up to a few of them.
+    "l1_several_caches"_test = []
+    {
+        constexpr std::size_t caches_number{ 5 }; // One more than a thread keeps an L1 for.
+        constexpr std::size_t names_number{ 32 };
+        constexpr std::size_t rounds{ 8 };
+
+        auto const name{ [] (std::size_t i) { return "name" + std::to_string(i) + ".test.domain"; } };
+        auto const ipOf{
+            [] (std::size_t cache, std::size_t i) -> IP
+            { return std::to_string(cache + 1) + ".0.0." + std::to_string(i); }
+        };
+
+        std::vector<std::unique_ptr<DNSCache>> caches;
+        for (std::size_t cache{ 0 }; cache < caches_number; ++cache)
+        {
+            caches.push_back(std::make_unique<DNSCache>(4 * names_number, 2));
+            caches.back()->enableL1();
+            for (std::size_t i{ 0 }; i < names_number; ++i)
+            { caches.back()->update(name(i), ipOf(cache, i)); }
+        }
+
+        // Two of them in turn, then all of them round robin.
+        std::size_t bad{ 0 };
+        auto const resolveFrom{
+            [&] (std::size_t used)
+            {
+                for (std::size_t round{ 0 }; round < rounds; ++round)
+                {
+                    for (std::size_t cache{ 0 }; cache < used; ++cache)
+                    {
+                        for (std::size_t i{ 0 }; i < names_number; ++i)
+                        { bad += (ipOf(cache, i) == caches[cache]->resolve(name(i))) ? 0 : 1; }
+                    }
+                }
+            } // lambda
+        };
+
+        resolveFrom(2);
+        expect(0 == bad) << bad << " bad IPs alternating between two caches!";
+
+        if (DNSCache::statsEnabled())
+        {
+            // Only the first round's resolves have missed the L1.
+            for (std::size_t cache{ 0 }; cache < 2; ++cache)
+            {
+                expect(((rounds - 1) * names_number) <= caches[cache]->stats().l1_hits)
+                    << "The L1 has been dropped switching caches: " << caches[cache]->stats().l1_hits;
+            }
+        }
+
+        resolveFrom(caches_number);
+        expect(0 == bad) << bad << " bad IPs w/ more caches than L1s!";
+    };
+
+    // However fast the writer evicts and reuses the nodes, a reader never gets a name w/ another one's records.
+    "lock_free_readers_vs_evicting_writer"_test = []
+    {
+        constexpr std::size_t capacity{ 1024 };
+        constexpr std::size_t names_number{ 8 * capacity };
+        constexpr std::size_t rounds{ 8 };
+        constexpr std::size_t readers_number{ 3 };
+        constexpr std::size_t min_lookups{ 1000 }; // A reader's, after the writer's done as well.
+
+        // Name #i's records are i's, numbered in the lowest byte: every 8th one spills over.
+        auto const recordsOf{
+            [] (std::size_t const i) -> std::vector<IPV4Raw>
+            {
+                std::vector<IPV4Raw> records((0 == (i % 8)) ? 40 : 1);
+                std::iota(records.begin(), records.end(), static_cast<IPV4Raw>(i << 8));
+                return records;
+            } // lambda
+        };
+
+        std::vector<FQDN> names;
+        for (std::size_t i{ 0 }; i < names_number; ++i)
+        { names.push_back("name" + std::to_string(i) + ".evict.test.domain"); }
+
+        DNSCache dns_cache{ capacity, 2 };
+        std::atomic<bool> written{ false };
+        std::atomic<std::size_t> hits{ 0 };
+        std::atomic<std::size_t> bad{ 0 };
+
+        std::vector<std::thread> readers;
+        for (std::size_t r{ 0 }; r < readers_number; ++r)
+        {
+            readers.emplace_back(
+                [&, r]
+                {
+                    std::size_t own_hits{ 0 };
+                    std::size_t own_bad{ 0 };
+                    std::size_t pick{ r };
+                    for (std::size_t lookups{ 0 }; (not written) or (lookups < min_lookups); ++lookups)
+                    {
+                        pick = (pick * 7919 + 13) % names_number;
+                        auto const expected{ recordsOf(pick) };
+
+                        if (auto const ipv4{ dns_cache.resolveRaw(names[pick]) })
+                        {
+                            ++own_hits;
+                            own_bad += (expected.front() != *ipv4) ? 1 : 0;
+                        }
+
+                        if (auto const records{ dns_cache.resolveAll(names[pick]) })
+                        {
+                            ++own_hits;
+                            auto matches{ (expected.size() == records->ipv4Number()) };
+                            for (std::size_t k{ 0 }; matches and (k < expected.size()); ++k)
+                            { matches = (expected[k] == records->ipv4(k)); }
+
+                            own_bad += matches ? 0 : 1;
+                        }
+                    }
+
+                    hits += own_hits;
+                    bad += own_bad;
+                } // lambda
+            );
+        }
+
+        for (std::size_t round{ 0 }; round < rounds; ++round)
+        {
+            for (std::size_t i{ 0 }; i < names_number; ++i)
+            { dns_cache.update(names[i], recordsOf(i), {}); }
+        }
+
+        written = true;
+        for (auto& reader : readers)
+        { reader.join(); }
+
+        expect(0 < hits.load()) << "The readers haven't hit anything!";
+        expect(0 == bad.load()) << "Got another name's records " << bad.load() << " times!";
+        expect(dns_cache.size() <= capacity) << "Bad size: " << dns_cache.size();
+    };
+
+    "find_string_view"_test = []
+    {
+        DNSCache dns_cache{ 16, 2 };
+        dns_cache.update("view.test.domain", IP{ "1.1.1.1" });
+        dns_cache.updateNegative("gone.test.domain", Negative::NXDOMAIN, std::chrono::minutes{ 1 });
+
+        auto const expected{ dns_cache.resolveRaw("view.test.domain") };
+        expect(expected.has_value()) << "Not cached!";
+
+        // As it'd be in a request's buffer: not a string of its own, not NUL terminated.
+        std::string_view const wire{ "view.test.domain.local" };
+        expect(expected == dns_cache.find(wire.substr(0, 16))) << "Bad IP from a view!";
+        expect(not dns_cache.find(wire).has_value()) << "Resolved a longer name!";
+        expect(not dns_cache.find(wire.substr(0, 15)).has_value()) << "Resolved a prefix!";
+        expect(not dns_cache.find("gone.test.domain").has_value()) << "Resolved a negative entry!";
+
+        std::string const too_long(MAX_FQDN_LENGTH + 1, 'x');
+        expect(not dns_cache.find(too_long).has_value()) << "Resolved a name too long to be cached!";
+
+        dns_cache.enableL1();
+        expect(expected == dns_cache.find(wire.substr(0, 16))) << "Bad IP from a view!";
+        expect(expected == dns_cache.find(wire.substr(0, 16))) << "Bad IP from a view, from the L1!";
+    };
+
+    "invalidate_suffix"_test = []
+    {
+        using namespace std::chrono_literals;
+
+        expect(compareReversedLabels("example.com", "a.example.com") < 0) << "A domain after its names!";
+        expect(compareReversedLabels("b.example.com", "a.example.net") < 0) << "Not ordered from the right!";
+        expect(isUnderDomain("a.example.com", "example.com")) << "A name not under its domain!";
+        expect(not isUnderDomain("notexample.com", "example.com")) << "A name under a lookalike domain!";
+
+        // W/o the suffix index, w/ it from the start, and w/ it built over the cached names.
+        for (auto const indexing : { 0, 1, 2 })
+        {
+            DNSCache dns_cache{ 1'024, 4, DNSCache::Admission::ALWAYS, 64 };
+            if (1 == indexing)
+            { dns_cache.enableSuffixIndex(); }
+
+            for (auto const fqdn : { "example.com", "a.example.com", "b.a.example.com", "notexample.com",
+                                     "example.org", "x.com" })
+            { dns_cache.update(fqdn, IP{ "1.1.1.1" }); }
+
+            dns_cache.updateNegative("c.example.com", Negative::NXDOMAIN, 1h);
+            for (std::size_t i{ 0 }; i < 200; ++i)
+            {
+                dns_cache.update("host" + std::to_string(i) + ".zone.example.com", IP{ "2.2.2.2" });
+                dns_cache.update("host" + std::to_string(i) + ".other.test", IP{ "3.3.3.3" });
+            }
+
+            if (2 == indexing)
+            { dns_cache.enableSuffixIndex(); }
+
+            expect(200 == dns_cache.invalidateSuffix("zone.example.com")) << "Bad number dropped: " << indexing;
+            expect(4 == dns_cache.invalidateSuffix("example.com.")) << "Bad number dropped: " << indexing;
+            expect(0 == dns_cache.invalidateSuffix("example.com")) << "Dropped twice: " << indexing;
+
+            for (auto const fqdn : { "example.com", "a.example.com", "b.a.example.com", "c.example.com",
+                                     "host0.zone.example.com" })
+            { expect(DNSCache::Outcome::MISS == dns_cache.lookup(fqdn).outcome) << "Not dropped: " << fqdn; }
+
+            for (auto const fqdn : { "notexample.com", "example.org", "x.com", "host0.other.test" })
+            { expect(DNSCache::Outcome::HIT == dns_cache.lookup(fqdn).outcome) << "Dropped: " << fqdn; }
+
+            expect(203 == dns_cache.size()) << "Bad size after the invalidation: " << indexing;
+
+            // The dropped names' nodes are reused as any others.
+            dns_cache.update("a.example.com", IP{ "4.4.4.4" });
+            expect("4.4.4.4" == dns_cache.resolve("a.example.com")) << "Bad IP after the invalidation!";
+            expect(1 == dns_cache.invalidateSuffix("a.example.com")) << "Bad number dropped: " << indexing;
+
+            expect(203 == dns_cache.invalidateSuffix(".")) << "The root's not dropped it all: " << indexing;
+            expect(0 == dns_cache.size()) << "Not empty after the root's been dropped: " << indexing;
+        }
+
+        // The index keeps up w/ the evictions.
+        constexpr std::size_t capacity{ 64 };
+        DNSCache churned{ capacity };
+        churned.enableSuffixIndex();
+        for (std::size_t i{ 0 }; i < (8 * capacity); ++i)
+        {
+            auto const domain{ ((i % 3) == 0) ? ".odd.test" : ".even.test" };
+            churned.update("name" + std::to_string(i) + domain, IP{ "5.5.5.5" });
+        }
+
+        std::size_t odd_cached{ 0 };
+        for (std::size_t i{ 0 }; i < (8 * capacity); i += 3)
+        {
+            if (DNSCache::Outcome::HIT == churned.lookup("name" + std::to_string(i) + ".odd.test").outcome)
+            { ++odd_cached; }
+        }
+
+        expect(0 < odd_cached) << "Nothing to drop!";
+        expect(odd_cached == churned.invalidateSuffix("odd.test")) << "Bad number dropped after the evictions!";
+        expect((capacity - odd_cached) == churned.size()) << "Bad size after the invalidation!";
+
+        // So does it w/ the bulk loads.
+        DNSCache loaded{ capacity };
+        loaded.enableSuffixIndex();
+        std::istringstream hosts{ "10.0.0.1 a.zone.test b.zone.test\n10.0.0.2 other.test\n" };
+        expect(3 == loaded.bulkLoad(hosts)) << "Bad number loaded!";
+        expect(2 == loaded.invalidateSuffix("zone.test")) << "Bad number dropped after the bulk load!";
+        expect("10.0.0.2" == loaded.resolve("other.test")) << "Dropped a name of another domain!";
+    };
+
+    "wildcard_lookup"_test = []
+    {
+        DNSCache dns_cache{ 256, 2, DNSCache::Admission::ALWAYS, 64 };
+        dns_cache.update("*.example.com", IP{ "1.1.1.1" });
+        dns_cache.update("*.b.example.com", IP{ "2.2.2.2" });
+        dns_cache.update("exact.example.com", IP{ "3.3.3.3" });
+        dns_cache.updateNegative("*.gone.test", Negative::NXDOMAIN, std::chrono::minutes{ 1 });
+
+        auto const ipOf{
+            [&] (std::string_view const fqdn) -> std::optional<IPV4Raw>
+            { return dns_cache.lookupWildcard(fqdn).ipv4; }
+        };
+
+        expect(strToIPV4Raw("3.3.3.3") == ipOf("exact.example.com")) << "The wildcard's taken over a name!";
+        expect(strToIPV4Raw("1.1.1.1") == ipOf("x.example.com")) << "Bad wildcard's IP!";
+        expect(strToIPV4Raw("1.1.1.1") == ipOf("x.y.example.com")) << "Bad wildcard's IP, two labels down!";
+        expect(strToIPV4Raw("2.2.2.2") == ipOf("x.b.example.com")) << "Not the closest wildcard's IP!";
+
+        expect(DNSCache::Outcome::MISS == dns_cache.lookupWildcard("example.com").outcome)
+            << "A wildcard's matched its own domain!";
+        expect(DNSCache::Outcome::MISS == dns_cache.lookupWildcard("x.example.org").outcome)
+            << "Matched another domain's wildcard!";
+        expect(DNSCache::Outcome::MISS == dns_cache.lookup("x.example.com").outcome)
+            << "A plain lookup's fallen back on the wildcard!";
+
+        auto const gone{ dns_cache.lookupWildcard("a.gone.test") };
+        expect(DNSCache::Outcome::NEGATIVE_HIT == gone.outcome) << "A negative wildcard's not matched!";
+        expect(Negative::NXDOMAIN == gone.negative) << "Bad negative answer!";
+
+        // The name's as long as can be, the candidates are shorter still.
+        FQDN const longest{ std::string(MAX_FQDN_LENGTH - 12, 'x') + ".example.com" };
+        expect(strToIPV4Raw("1.1.1.1") == ipOf(longest)) << "Bad wildcard's IP for the longest name!";
+    };
+
+    // Whatever the host's got: what isn't there falls back, and the cache's the same either way.
+    "page_options"_test = []
+    {
+        auto const test_data{ generateTestData(1'000) };
+        for (auto const huge_pages : { HugePages::NONE, HugePages::TRANSPARENT, HugePages::EXPLICIT })
+        {
+            for (auto const numa : { NumaPlacement::FIRST_TOUCH, NumaPlacement::INTERLEAVE, NumaPlacement::NODE })
+            {
+                DNSCache dns_cache{ 2 * test_data.size(), 3, DNSCache::Admission::TINY_LFU, 64,
+                                    PageOptions{ huge_pages, numa, 1 } };
+                expect(dns_cache.hugePages() <= huge_pages) << "Got more than asked for!";
+
+                for (auto const& [fqdn, ip] : test_data)
+                { dns_cache.update(fqdn, ip); }
+
+                auto all_resolved{ true };
+                for (auto const& [fqdn, ip] : test_data)
+                { all_resolved = all_resolved and (ip == dns_cache.resolve(fqdn)); }
+
+                expect(all_resolved) << "Bad IPs w/ the nodes in the page region!";
+            }
+        }
+    };
+
+    "resize"_test = []
+    {
+        using namespace std::chrono_literals;
+
+        constexpr std::size_t capacity{ 2'048 };
+        constexpr std::size_t shards_number{ 4 };
+        auto const test_data{ generateTestData(4 * capacity) };
+        auto const countResolved{
+            [&] (DNSCache& dns_cache, std::size_t begin, std::size_t end)
+            {
+                std::size_t resolved{ 0 };
+                for (auto i{ begin }; i < end; ++i)
+                { resolved += (test_data[i].second == dns_cache.resolve(test_data[i].first)) ? 1 : 0; }
+
+                return resolved;
+            } // lambda
+        };
+
+        DNSCache dns_cache{ capacity, shards_number, DNSCache::Admission::TINY_LFU, 64 };
+        dns_cache.enableSuffixIndex();
+        dns_cache.updateNegative("nxdomain.test.domain", Negative::NXDOMAIN, 1h);
+        for (std::size_t i{ 0 }; i < capacity; ++i)
+        { dns_cache.update(test_data[i].first, test_data[i].second); }
+
+        auto const cached{ countResolved(dns_cache, 0, capacity) };
+
+        // Growing keeps what's cached, then makes room for as much again.
+        dns_cache.resize(4 * capacity);
+        expect(4 * capacity == dns_cache.maxSize()) << "Bad capacity after growing!";
+        expect(cached == countResolved(dns_cache, 0, capacity)) << "Lost entries growing!";
+        expect(DNSCache::Outcome::NEGATIVE_HIT == dns_cache.lookup("nxdomain.test.domain").outcome)
+            << "Lost a negative entry growing!";
+
+        for (auto i{ capacity }; i < test_data.size(); ++i)
+        { dns_cache.update(test_data[i].first, test_data[i].second); }
+
+        expect(dns_cache.size() > 2 * capacity) << "No room made growing: " << dns_cache.size();
+        expect(dns_cache.invalidateSuffix("subd9.subd1.subd1.test.domain") > 0)
+            << "The suffix index doesn't hold the new nodes!";
+
+        // Shrinking evicts down to the capacity (the negative entry's on a budget of its own), what's left
+        // is still there and in order.
+        dns_cache.resize(capacity);
+        expect(capacity == dns_cache.maxSize()) << "Bad capacity after shrinking!";
+        expect(dns_cache.size() <= capacity + 1) << "Not evicted down to the capacity: " << dns_cache.size();
+
+        auto const survived{ countResolved(dns_cache, 0, test_data.size()) };
+        expect(survived > 0) << "Nothing survived shrinking!";
+        expect(survived <= capacity) << "Resolved more than fits!";
+
+        for (std::size_t i{ 0 }; i < capacity; ++i)
+        { dns_cache.update(test_data[i].first, test_data[i].second); }
+
+        expect(dns_cache.size() <= capacity + 1) << "Grown over the capacity after shrinking!";
+        expect(dns_cache.resolve(test_data[capacity - 1].first) == test_data[capacity - 1].second)
+            << "Bad IP after shrinking!";
+
+        auto refused{ false };
+        try
+        {
+            dns_cache.resize(shards_number);
+        }
+        catch (std::logic_error const&)
+        { refused = true; }
+
+        expect(refused) << "Resized below the minimum!";
+        expect(capacity == dns_cache.maxSize()) << "Resized although refused!";
+    };
+
+    // The capacity's read while a resize() changes it, shard by shard and step by step.
+    "max_size_while_resizing"_test = []
+    {
+        constexpr std::size_t capacity{ 2'048 };
+        constexpr std::size_t shards_number{ 4 };
+        constexpr std::size_t rounds{ 8 };
+
+        DNSCache dns_cache{ capacity, shards_number };
+        std::atomic<bool> resizing{ true };
+        std::thread resizer{
+            [&]
+            {
+                for (std::size_t round{ 0 }; round < rounds; ++round)
+                { dns_cache.resize((0 == (round % 2)) ? (4 * capacity) : capacity); }
+
+                resizing = false;
+            } // lambda
+        };
+
+        std::size_t reads{ 0 };
+        std::size_t out_of_range{ 0 };
+        while (resizing or (0 == reads))
+        {
+            auto const max_size{ dns_cache.maxSize() };
+            out_of_range += ((max_size < capacity) or (4 * capacity < max_size)) ? 1 : 0;
+            ++reads;
+        }
+
+        resizer.join();
+        expect(0 == out_of_range) << out_of_range << " of " << reads << " capacities out of range!";
+        expect(capacity == dns_cache.maxSize()) << "Bad capacity after the last resize!";
+    };
+
+    "tiny_lfu_survives_scan"_test = []
+    {
+        constexpr std::size_t capacity{ 256 };
+        constexpr std::size_t hot_number{ capacity / 2 };
+        constexpr std::size_t scan_length{ 4 * capacity };
+
+        auto const hotName{ [] (std::size_t i) { return "hot" + std::to_string(i) + ".test.domain"; } };
+        auto const countHot{
+            [&] (DNSCache& dns_cache)
+            {
+                std::size_t cached{ 0 };
+                for (std::size_t i{ 0 }; i < hot_number; ++i)
+                { cached += (dns_cache.resolve(hotName(i)).empty() ? 0 : 1); }
+
+                return cached;
+            } // lambda
+        };
+
+        DNSCache lru{ capacity };
+        DNSCache tiny_lfu{ capacity, 1, DNSCache::Admission::TINY_LFU };
+
+        for (auto dns_cache : { &lru, &tiny_lfu })
+        {
+            for (std::size_t i{ 0 }; i < hot_number; ++i)
+            { dns_cache->update(hotName(i), IP{ "1.1.1.1" }); }
+
+            for (std::size_t round{ 0 }; round < 4; ++round)
+            { (void)countHot(*dns_cache); }
+
+            for (std::size_t i{ 0 }; i < scan_length; ++i)
+            { dns_cache->update("scan" + std::to_string(i) + ".test.domain", IP{ "2.2.2.2" }); }
+        }
+
+        expect(0 == countHot(lru)) << "The scan should have flushed the LRU!";
+        // Shorter than the sketch's aging period: the hot names' history is intact.
+        expect(hot_number == countHot(tiny_lfu)) << "The scan has pushed hot names out!";
+        expect(capacity == tiny_lfu.size()) << "Bad size!";
+    };
+
+    "snapshot"_test = []
+    {
+        using namespace std::chrono_literals;
+
+        auto const path{ (std::filesystem::temp_directory_path() / "ut_dns_cache.snapshot").string() };
+        auto const name{ [] (std::size_t i) { return "name" + std::to_string(i) + ".test.domain"; } };
+        constexpr std::size_t names_number{ 40 };
+
+        std::vector<IPV4Raw> ipv4s(100);
+        std::iota(ipv4s.begin(), ipv4s.end(), 0x01'01'01'01);
+        std::vector<IPV6Raw> ipv6s(10);
+        for (std::size_t i{ 0 }; i < ipv6s.size(); ++i)
+        { ipv6s[i] = strToIPV6Raw("2001:db8::" + std::to_string(i + 1)).value_or(IPV6Raw{}); }
+
+        DNSCache saved{ 64, 2 };
+        for (std::size_t i{ 0 }; i < names_number; ++i)
+        { saved.update(name(i), static_cast<IPV4Raw>(i), (0 == (i % 2)) ? 1h : NO_TTL); }
+
+        saved.update("records.test.domain", ipv4s, ipv6s);
+        saved.update("expired.test.domain", IP{ "1.1.1.1" }, 10ms);
+        std::this_thread::sleep_for(20ms);
+
+        saved.saveSnapshot(path);
+
+        auto const expectRestored{
+            [&] (DNSCache& dns_cache)
+            {
+                for (std::size_t i{ 0 }; i < names_number; ++i)
+                { expect(i == dns_cache.resolveRaw(name(i)).value_or(~IPV4Raw{ 0 })) << "Lost " << name(i); }
+
+                expect(dns_cache.resolve("expired.test.domain").empty()) << "An expired entry's been restored!";
+
+                auto const records{ dns_cache.resolveAll("records.test.domain") };
+                expect(records.has_value()) << "Lost the record set!";
+                if (not records.has_value())
+                { return; }
+
+                expect((ipv4s.size() == records->ipv4Number()) and (ipv6s.size() == records->ipv6Number()))
+                    << "Bad records number!";
+                for (std::size_t i{ 0 }; i < ipv4s.size(); ++i)
+                { expect(ipv4s[i] == records->ipv4(i)) << "Got wrong A record #" << i; }
+                for (std::size_t i{ 0 }; i < ipv6s.size(); ++i)
+                { expect(ipv6s[i] == records->ipv6(i)) << "Got wrong AAAA record #" << i; }
+            } // lambda
+        };
+
+        DNSCache same{ 64, 2 };
+        expect((names_number + 1) == same.loadSnapshot(path)) << "Bad number restored!";
+        expect((names_number + 1) == same.size()) << "Bad size!";
+        expectRestored(same);
+
+        DNSCache resharded{ 96, 3, DNSCache::Admission::TINY_LFU };
+        expect((names_number + 1) == resharded.loadSnapshot(path)) << "Bad number restored w/ other shards!";
+        expectRestored(resharded);
+
+        auto refused{ false };
+        try
+        { (void)same.loadSnapshot(path); }
+        catch (std::logic_error const&)
+        { refused = true; }
+
+        expect(refused) << "Loaded into a cache that isn't empty!";
+
+        // The bottom of the eviction order stays the bottom, the smaller cache keeps the top.
+        DNSCache ordered{ 8 };
+        for (std::size_t i{ 0 }; i < 8; ++i)
+        { ordered.update(name(i), static_cast<IPV4Raw>(i)); }
+
+        ordered.saveSnapshot(path);
+
+        DNSCache restored{ 8 };
+        expect(8 == restored.loadSnapshot(path)) << "Bad number restored!";
+        restored.update("new.test.domain", IP{ "2.2.2.2" });
+        expect(not restored.resolveRaw(name(0)).has_value()) << "The bottom entry hasn't been evicted!";
+        for (std::size_t i{ 1 }; i < 8; ++i)
+        { expect(restored.resolveRaw(name(i)).has_value()) << "Evicted " << name(i) << " first!"; }
+
+        DNSCache smaller{ 4 };
+        expect(4 == smaller.loadSnapshot(path)) << "Bad number restored into a smaller cache!";
+        for (std::size_t i{ 0 }; i < 8; ++i)
+        { expect((4 <= i) == smaller.resolveRaw(name(i)).has_value()) << "Kept the wrong " << name(i); }
+
+        // A flipped bit fails the checksum.
+        {
+            std::fstream file{ path, std::ios::in | std::ios::out | std::ios::binary };
+            file.seekg(-1, std::ios::end);
+            auto const last{ static_cast<char>(file.get()) };
+            file.seekp(-1, std::ios::end);
+            file.put(static_cast<char>(last ^ 0x01));
+        }
+
+        DNSCache corrupted{ 8 };
+        auto rejected{ false };
+        try
+        { (void)corrupted.loadSnapshot(path); }
+        catch (std::runtime_error const&)
+        { rejected = true; }
+
+        expect(rejected and (0 == corrupted.size())) << "Loaded a corrupted snapshot!";
+
+        std::filesystem::remove(path);
+    };
+
+    "bulk_load"_test = []
+    {
+        auto const path{ (std::filesystem::temp_directory_path() / "ut_dns_cache.hosts").string() };
+        {
+            std::ofstream file{ path };
+            file << "# A hosts file w/ a zone dump mixed in.\n"
+                 << "127.0.0.1\tlocalhost loopback.test.domain\n"
+                 << "::1 localhost # The other loopback.\n"
+                 << "10.0.0.1 first.test.domain\n"
+                 << "not-an-address bad.test.domain\n"
+                 << "010.0.0.1 leading-zero.test.domain\n"
+                 << "$TTL 3600\n"
+                 << "zone.test.domain. 3600 IN A 10.0.0.2\n"
+                 << "zone.test.domain. IN 3600 AAAA 2001:db8::2\n"
+                 << "zone.test.domain. 3600 IN MX 10 mail.test.domain.\n"
+                 << "zero-ttl.test.domain. 0 IN A 10.0.0.3\n"
+                 << std::string(MAX_FQDN_LENGTH + 1, 'a') << " 3600 IN A 10.0.0.4\n"
+                 << "10.0.0.5 last.test.domain";
+        }
+
+        DNSCache dns_cache{ 64, 2 };
+        expect(5 == dns_cache.bulkLoad(path)) << "Bad number loaded!";
+        expect(5 == dns_cache.size()) << "Bad size!";
+
+        auto const localhost{ dns_cache.resolveAll("localhost") };
+        expect(localhost.has_value() and (1 == localhost->ipv4Number()) and (1 == localhost->ipv6Number()))
+            << "The lines of a name haven't been merged!";
+        if (localhost.has_value())
+        {
+            expect(strToIPV4Raw("127.0.0.1") == localhost->ipv4(0)) << "Got wrong A record!";
+            expect(strToIPV6Raw("::1") == localhost->ipv6(0)) << "Got wrong AAAA record!";
+        }
+
+        auto const zone{ dns_cache.resolveAll("zone.test.domain") };
+        expect(zone.has_value() and (1 == zone->ipv4Number()) and (1 == zone->ipv6Number()))
+            << "Lost the zone records!";
+
+        expect("127.0.0.1" == dns_cache.resolve("loopback.test.domain")) << "Lost an alias!";
+        expect("10.0.0.1" == dns_cache.resolve("first.test.domain")) << "Lost a name!";
+        expect("10.0.0.5" == dns_cache.resolve("last.test.domain")) << "Lost the unterminated line!";
+        expect(dns_cache.resolve("bad.test.domain").empty()) << "Loaded a malformed line!";
+        expect(dns_cache.resolve("leading-zero.test.domain").empty()) << "Loaded a malformed address!";
+        expect(dns_cache.resolve("zero-ttl.test.domain").empty()) << "Loaded a zero TTL!";
+
+        auto refused{ false };
+        try
+        { (void)dns_cache.bulkLoad(path); }
+        catch (std::logic_error const&)
+        { refused = true; }
+
+        expect(refused) << "Loaded into a cache that isn't empty!";
+        std::filesystem::remove(path);
+
+        // The eviction order is the file's, or the priority's.
+        auto const name{ [] (std::size_t i) { return "name" + std::to_string(i) + ".test.domain"; } };
+        std::string hosts;
+        for (std::size_t i{ 0 }; i < 8; ++i)
+        { hosts += "10.0.0." + std::to_string(i) + " " + name(i) + "\n"; }
+
+        DNSCache ordered{ 8 };
+        std::istringstream ordered_input{ hosts };
+        expect(8 == ordered.bulkLoad(ordered_input)) << "Bad number loaded from a stream!";
+        ordered.update("new.test.domain", IP{ "2.2.2.2" });
+        expect(not ordered.resolveRaw(name(0)).has_value()) << "The first line hasn't been evicted first!";
+        for (std::size_t i{ 1 }; i < 8; ++i)
+        { expect(ordered.resolveRaw(name(i)).has_value()) << "Evicted " << name(i) << " first!"; }
+
+        DNSCache smaller{ 4 };
+        std::istringstream smaller_input{ hosts };
+        expect(4 == smaller.bulkLoad(smaller_input)) << "Bad number loaded into a smaller cache!";
+        for (std::size_t i{ 0 }; i < 8; ++i)
+        { expect((4 <= i) == smaller.resolveRaw(name(i)).has_value()) << "Kept the wrong " << name(i); }
+
+        DNSCache prioritized{ 4 };
+        std::istringstream prioritized_input{ hosts };
+        auto const priority{
+            [] (std::string_view const fqdn) -> std::uint64_t
+            { return '9' - static_cast<std::uint64_t>(fqdn[4]); }
+        };
+        expect(4 == prioritized.bulkLoad(prioritized_input, NO_TTL, priority)) << "Bad number loaded!";
+        for (std::size_t i{ 0 }; i < 8; ++i)
+        { expect((i < 4) == prioritized.resolveRaw(name(i)).has_value()) << "Kept the wrong " << name(i); }
+
+        // Enough for a few pieces, where there are the cores for them.
+        constexpr std::size_t names_number{ 100'000 };
+        auto const address{
+            [] (std::size_t i)
+            {
+                return "10." + std::to_string(i >> 16) + "." + std::to_string((i >> 8) & 0xFF) + "."
+                     + std::to_string(i & 0xFF);
+            } // lambda
+        };
+
+        std::string many;
+        for (std::size_t i{ 0 }; i < names_number; ++i)
+        { many += address(i) + " " + name(i) + "\n"; }
+
+        DNSCache large{ 2 * names_number, 4 };
+        std::istringstream many_input{ many };
+        expect(names_number == large.bulkLoad(many_input)) << "Bad number loaded!";
+        auto all_found{ true };
+        for (std::size_t i{ 0 }; i < names_number; ++i)
+        { all_found = all_found and (address(i) == large.resolve(name(i))); }
+
+        expect(all_found) << "Lost some of the names!";
+    };
+
+    "resolve_or_fetch"_test = []
+    {
+        using namespace std::chrono_literals;
+
+        DNSCache dns_cache{ 64, 1, DNSCache::Admission::ALWAYS, 8 };
+
+        auto refused{ false };
+        try
+        {
+            (void)dns_cache.resolveOrFetch("name.test.domain");
+        }
+        catch (std::logic_error const&)
+        { refused = true; }
+
+        expect(refused) << "Fetched w/o an upstream!";
+
+        // The fake upstream counts the fetches, and holds them until it's released.
+        std::atomic<std::size_t> fetches{ 0 };
+        std::promise<void> release;
+        std::shared_future<void> released{ release.get_future().share() };
+        dns_cache.setUpstream(
+            [&fetches, released] (FQDN const& fqdn) -> DNSCache::Answer
+            {
+                ++fetches;
+                released.wait();
+
+                if ("broken.test.domain" == fqdn)
+                { throw std::runtime_error{ "SERVFAIL" }; }
+
+                DNSCache::Answer answer{};
+                if ("missing.test.domain" == fqdn)
+                {
+                    answer.negative = Negative::NXDOMAIN;
+                    answer.ttl      = 1h;
+                }
+                else
+                { answer.ipv4s.push_back(*strToIPV4Raw("10.0.0.1")); }
+
+                return answer;
+            } // lambda
+        );
+
+        // The first miss fetches, the concurrent ones wait on it.
+        std::shared_future<DNSCache::Lookup> first;
+        std::thread leader{ [&] { first = dns_cache.resolveOrFetch("popular.test.domain"); } };
+        while (0 == fetches)
+        { std::this_thread::yield(); }
+
+        constexpr std::size_t waiting_number{ 8 };
+        std::vector<std::shared_future<DNSCache::Lookup>> waiting;
+        std::atomic<std::size_t> called_back{ 0 };
+        for (std::size_t i{ 0 }; i < waiting_number; ++i)
+        {
+            waiting.push_back(dns_cache.resolveOrFetch("popular.test.domain"));
+            dns_cache.resolveOrFetch(
+                "popular.test.domain",
+                [&called_back] (std::shared_future<DNSCache::Lookup> const& result)
+                {
+                    if (DNSCache::Outcome::HIT == result.get().outcome)
+                    { ++called_back; }
+                } // lambda
+            );
+        }
+
+        expect(0 == called_back) << "Called back before the answer!";
+        expect(std::future_status::timeout == waiting.front().wait_for(0ms)) << "Ready before the answer!";
+
+        release.set_value();
+        leader.join();
+
+        expect(1 == fetches) << "The concurrent misses weren't coalesced: " << fetches.load();
+        expect(waiting_number == called_back) << "Bad number of callbacks: " << called_back.load();
+        expect("10.0.0.1" == IPV4RawToStr(first.get().ipv4.value_or(0)).value_or(IP{})) << "Bad fetched IP!";
+        for (auto const& result : waiting)
+        { expect(DNSCache::Outcome::HIT == result.get().outcome) << "A waiting caller missed!"; }
+
+        // The answer's cached.
+        expect("10.0.0.1" == dns_cache.resolve("popular.test.domain")) << "The answer hasn't been cached!";
+        expect(DNSCache::Outcome::HIT == dns_cache.resolveOrFetch("popular.test.domain").get().outcome)
+            << "Not a hit!";
+        expect(1 == fetches) << "Fetched a cached name!";
+
+        // And so's a negative one.
+        expect(DNSCache::Outcome::NEGATIVE_HIT == dns_cache.resolveOrFetch("missing.test.domain").get().outcome)
+            << "Not a negative hit!";
+        expect(DNSCache::Outcome::NEGATIVE_HIT == dns_cache.resolveOrFetch("missing.test.domain").get().outcome)
+            << "Not a negative hit!";
+        expect(2 == fetches) << "Fetched a cached negative answer!";
+
+        // The upstream's failure is what the callers get, and the next miss tries again.
+        auto failed{ false };
+        try
+        {
+            (void)dns_cache.resolveOrFetch("broken.test.domain").get();
+        }
+        catch (std::runtime_error const&)
+        { failed = true; }
+
+        expect(failed) << "The upstream's failure hasn't been passed on!";
+        expect(DNSCache::Outcome::MISS == dns_cache.lookup("broken.test.domain").outcome) << "Cached a failure!";
+
+        failed = false;
+        dns_cache.resolveOrFetch(
+            "broken.test.domain",
+            [&failed] (std::shared_future<DNSCache::Lookup> const& result)
+            {
+                try
+                {
+                    (void)result.get();
+                }
+                catch (std::runtime_error const&)
+                { failed = true; }
+            } // lambda
+        );
+
+        expect(failed) << "The upstream's failure hasn't been passed on!";
+        expect(4 == fetches) << "A failed fetch hasn't been tried again!";
+
+        // A throwing callback doesn't keep the next waiters from theirs, nor escape the leader's call.
+        std::promise<void> release_slow;
+        std::shared_future<void> slow_released{ release_slow.get_future().share() };
+        std::atomic<bool> slow_fetching{ false };
+        dns_cache.setUpstream(
+            [&slow_fetching, slow_released] (FQDN const&) -> DNSCache::Answer
+            {
+                slow_fetching = true;
+                slow_released.wait();
+
+                DNSCache::Answer answer{};
+                answer.ipv4s.push_back(*strToIPV4Raw("10.0.0.2"));
+                return answer;
+            } // lambda
+        );
+
+        auto leader_threw{ false };
+        std::thread slow_leader{
+            [&]
+            {
+                try
+                {
+                    dns_cache.resolveOrFetch(
+                        "slow.test.domain",
+                        [] (std::shared_future<DNSCache::Lookup> const&) { throw std::runtime_error{ "Oops" }; }
+                    );
+                }
+                catch (...)
+                { leader_threw = true; }
+            } // lambda
+        };
+        while (not slow_fetching)
+        { std::this_thread::yield(); }
+
+        auto thrower_called{ false };
+        auto next_called{ false };
+        dns_cache.resolveOrFetch(
+            "slow.test.domain",
+            [&thrower_called] (std::shared_future<DNSCache::Lookup> const&)
+            {
+                thrower_called = true;
+                throw std::runtime_error{ "Oops" };
+            } // lambda
+        );
+        dns_cache.resolveOrFetch(
+            "slow.test.domain",
+            [&next_called] (std::shared_future<DNSCache::Lookup> const& result)
+            { next_called = (DNSCache::Outcome::HIT == result.get().outcome); }
+        );
+
+        release_slow.set_value();
+        slow_leader.join();
+
+        expect(not leader_threw) << "A callback's exception escaped the leader's call!";
+        expect(thrower_called) << "The throwing callback hasn't been called!";
+        expect(next_called) << "A throwing callback kept the next waiter from its own!";
+    };
 }
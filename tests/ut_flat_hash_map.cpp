@@ -0,0 +1,201 @@
+#include <core/flat_hash_map.hpp>
+
+#include <boost/ut.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+struct TestNode
+    : public core::FlatHashMap<std::string, std::uint32_t, TestNode>::NodeTrait
+{}; // TestNode
+
+using TestMap = core::FlatHashMap<std::string, std::uint32_t, TestNode>;
+
+auto generateKeys(std::size_t keys_number) -> std::vector<std::string>
+{
+    std::vector<std::string> keys;
+    keys.reserve(keys_number);
+
+    for (std::size_t i{ 0 }; i < keys_number; ++i)
+    { keys.emplace_back("subd" + std::to_string(i) + ".subd0.subd0.test.domain"); }
+
+    return keys;
+}
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
+{
+    using namespace boost::ut::literals;
+    using namespace boost::ut;
+
+    "insert_update_erase"_test = []
+    {
+        constexpr std::size_t keys_number{ 100'000 };
+        auto const keys{ generateKeys(keys_number) };
+
+        auto storage{ std::make_unique<TestNode[]>(keys_number) };
+        std::size_t allocated{ 0 };
+
+        TestMap map{ keys_number };
+        map.setAllocateCallback([&] () -> TestNode* { return &storage[allocated++]; });
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        { map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i)); }
+
+        expect(keys_number == map.size()) << "Bad size!";
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        { map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(2 * i)); }
+
+        expect(keys_number == map.size()) << "Updating has changed the size!";
+
+        for (std::size_t i{ 0 }; i < keys_number; i += 2)
+        { expect(map.erase(keys[i])) << "Haven't erased " << keys[i]; }
+
+        expect((keys_number / 2) == map.size()) << "Bad size after erasing!";
+        expect(not map.erase(keys[0])) << "Erased twice!";
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        {
+            auto const node{ map.findOptimistic(keys[i]) };
+            expect((nullptr != node) == (1 == (i % 2))) << "Bad lookup for " << keys[i];
+            expect((nullptr == node) or (node->second == (2 * i))) << "Bad value for " << keys[i];
+        }
+    };
+
+    // The cache's steady state: every insert evicts, which leaves tombstones behind until a rehash.
+    "full_table_churn"_test = []
+    {
+        constexpr std::size_t capacity{ 4'096 };
+        constexpr std::size_t keys_number{ 64 * capacity };
+        auto const keys{ generateKeys(keys_number) };
+
+        auto storage{ std::make_unique<TestNode[]>(capacity) };
+        std::vector<std::size_t> owners(capacity, keys_number);
+        std::size_t next_key{ 0 };
+
+        TestMap map{ capacity };
+        map.setAllocateCallback(
+            [&] () -> TestNode*
+            {
+                auto const slot{ next_key % capacity };
+                if (keys_number != owners[slot])
+                { map.erase(keys[owners[slot]]); }
+
+                owners[slot] = next_key;
+                return &storage[slot];
+            } // lambda
+        );
+
+        for (; next_key < keys_number; ++next_key)
+        { map.insertOrUpdate(keys[next_key], static_cast<std::uint32_t>(next_key)); }
+
+        expect(capacity == map.size()) << "Bad size!";
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        {
+            auto const node{ map.findOptimistic(keys[i]) };
+            expect((nullptr != node) == (i >= (keys_number - capacity))) << "Bad lookup for " << keys[i];
+        }
+    };
+
+    // Grown while it's full: the lookups have to find every node wherever it is meanwhile.
+    "reserve_migrates_incrementally"_test = []
+    {
+        constexpr std::size_t capacity{ 4'096 };
+        constexpr std::size_t grown_capacity{ 16 * capacity };
+        auto const keys{ generateKeys(grown_capacity) };
+
+        auto storage{ std::make_unique<TestNode[]>(grown_capacity + 1) };
+        std::size_t allocated{ 0 };
+
+        TestMap map{ capacity };
+        map.setAllocateCallback([&] () -> TestNode* { return &storage[allocated++]; });
+
+        for (std::size_t i{ 0 }; i < capacity; ++i)
+        { map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i)); }
+
+        map.reserve(grown_capacity);
+        expect(map.isMigrating()) << "Hasn't grown!";
+        expect(grown_capacity == map.maxSize()) << "Bad capacity!";
+
+        // An entry moves to another node, as the cache does w/ the nodes of the slabs it hands back.
+        auto const moved{ map.find(keys[1]) };
+        auto const spare{ &storage[grown_capacity] };
+        spare->first  = moved->first;
+        spare->second = moved->second;
+        expect(map.replace(moved, spare)) << "Haven't replaced!";
+        expect(not map.replace(moved, spare)) << "Replaced twice!";
+
+        // Every mutator migrates a bit, the erases included.
+        map.erase(keys[0]);
+        for (std::size_t i{ capacity }; i < grown_capacity; ++i)
+        {
+            map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i));
+            if (0 == (i % 1'024))
+            {
+                auto const node{ map.findOptimistic(keys[i - capacity + 1]) };
+                expect((nullptr != node) and (node->second == (i - capacity + 1))) << "Lost during the migration!";
+            }
+        }
+
+        expect(not map.isMigrating()) << "Still migrating!";
+        expect((grown_capacity - 1) == map.size()) << "Bad size!";
+
+        std::size_t synchronized{ 0 };
+        map.reclaimRetired([&] () { ++synchronized; });
+        map.reclaimRetired([&] () { ++synchronized; });
+        expect(1 == synchronized) << "The retired tables haven't been reclaimed once!";
+
+        for (std::size_t i{ 0 }; i < grown_capacity; ++i)
+        {
+            auto const node{ map.findOptimistic(keys[i]) };
+            expect((nullptr != node) == (0 != i)) << "Bad lookup for " << keys[i];
+            expect((nullptr == node) or (node->second == i)) << "Bad value for " << keys[i];
+        }
+
+        expect(spare == map.find(keys[1])) << "The replaced node is back!";
+    };
+
+    "rebuild"_test = []
+    {
+        constexpr std::size_t keys_number{ 100'000 };
+        auto const keys{ generateKeys(keys_number) };
+
+        auto storage{ std::make_unique<TestNode[]>(keys_number) };
+        std::size_t allocated{ 0 };
+
+        TestMap map{ keys_number };
+        map.setAllocateCallback([&] () -> TestNode* { return &storage[allocated++]; });
+
+        // Whatever was there before goes, tombstones included.
+        for (std::size_t i{ 0 }; i < keys_number; i += 3)
+        { map.insertOrUpdate(keys[i], 0); }
+        for (std::size_t i{ 0 }; i < keys_number; i += 6)
+        { map.erase(keys[i]); }
+
+        std::vector<TestNode*> nodes;
+        for (std::size_t i{ 0 }; i < keys_number; i += 2)
+        {
+            storage[i / 2].first  = keys[i];
+            storage[i / 2].second = static_cast<std::uint32_t>(i);
+            nodes.push_back(&storage[i / 2]);
+        }
+
+        map.rebuild(nodes);
+        expect((keys_number / 2) == map.size()) << "Bad size!";
+
+        std::size_t visited{ 0 };
+        map.forEach([&] (TestNode const*) { ++visited; });
+        expect((keys_number / 2) == visited) << "Bad walk!";
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        {
+            auto const node{ map.findOptimistic(keys[i]) };
+            expect((nullptr != node) == (0 == (i % 2))) << "Bad lookup for " << keys[i];
+            expect((nullptr == node) or (node->second == i)) << "Bad value for " << keys[i];
+        }
+
+        expect(map.erase(keys[0])) << "Haven't erased a rebuilt key!";
+    };
+}
@@ -0,0 +1,300 @@
+#include <core/flat_llrb_map.hpp>
+#include <core/links.hpp>
+
+#include <boost/ut.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+struct TestNode
+    : public core::FlatLLRBMap<std::string, std::uint32_t, TestNode>::NodeTrait
+{
+    using NodeKeyReference = std::string const&;
+
+    operator NodeKeyReference () const noexcept(true)
+    { return this->first; }
+
+}; // TestNode
+
+using TestMap = core::FlatLLRBMap<std::string, std::uint32_t, TestNode>;
+
+struct CompactNode;
+
+using CompactLinks = core::CompactLinks<CompactNode>;
+using CompactMap   = core::FlatLLRBMap<std::string, std::uint32_t, CompactNode, core::CallbackPolicy<CompactNode>,
+                                       CompactLinks>;
+
+struct CompactNode
+    : public CompactMap::NodeTrait
+{
+    using NodeKeyReference = std::string const&;
+
+    std::uint32_t slot{};
+
+    operator NodeKeyReference () const noexcept(true)
+    { return this->first; }
+
+}; // CompactNode
+
+///
+/// \brief The CountingPolicy struct is a policy wired at compile time: it counts what it's told.
+///
+struct CountingPolicy
+{
+    TestNode*   storage{};
+    std::size_t capacity{ 0 };
+    std::size_t allocated{ 0 };
+    std::size_t created{ 0 };
+    std::size_t updated{ 0 };
+
+    auto allocate() -> TestNode*
+    { return (this->allocated < this->capacity) ? &(this->storage[this->allocated++]) : nullptr; }
+
+    auto onCreate(TestNode*) -> core::CreateOrUpdateStatus
+    {
+        ++this->created;
+        return core::CreateOrUpdateStatus::SUCCESS;
+    }
+
+    auto onUpdate(TestNode*) -> core::CreateOrUpdateStatus
+    {
+        ++this->updated;
+        return core::CreateOrUpdateStatus::SUCCESS;
+    }
+
+}; // CountingPolicy
+
+///
+/// \brief generateSortedKeys makes `keys_number` keys that are inserted in the ascending order.
+///
+auto generateSortedKeys(std::size_t keys_number) -> std::vector<std::string>
+{
+    std::vector<std::string> keys;
+    keys.reserve(keys_number);
+
+    for (std::size_t i{ 0 }; i < keys_number; ++i)
+    {
+        char subd[32]{};
+        std::snprintf(subd, sizeof(subd), "%09zu", i);
+        keys.emplace_back(std::string{ "subd" } + subd + ".subd0.subd0.test.domain");
+    }
+
+    return keys;
+}
+
+auto maxBalancedDepth(std::size_t nodes_number) -> std::size_t
+{
+    return static_cast<std::size_t>(2 * std::ceil(std::log2(static_cast<double>(nodes_number) + 1)));
+}
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
+{
+    using namespace boost::ut::literals;
+    using namespace boost::ut;
+
+    "sequential_insert_stays_balanced"_test = []
+    {
+        constexpr std::size_t keys_number{ 1'000'000 };
+        auto const keys{ generateSortedKeys(keys_number) };
+
+        auto storage{ std::make_unique<TestNode[]>(keys_number) };
+        std::size_t allocated{ 0 };
+
+        TestMap map{ keys_number };
+        map.setAllocateCallback([&] () -> TestNode* { return &storage[allocated++]; });
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        { map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i)); }
+
+        expect(keys_number == map.size()) << "Bad size!";
+        expect(map.depth() <= maxBalancedDepth(keys_number)) << "Too deep: " << map.depth();
+
+        "erase_half"_test = [&]
+        {
+            for (std::size_t i{ 0 }; i < keys_number; i += 2)
+            { expect(map.erase(keys[i])) << "Haven't erased " << keys[i]; }
+
+            expect((keys_number / 2) == map.size()) << "Bad size after erasing!";
+            expect(map.depth() <= maxBalancedDepth(keys_number / 2)) << "Too deep: " << map.depth();
+            expect(not map.erase(keys[0])) << "Erased twice!";
+
+            for (std::size_t i{ 0 }; i < keys_number; ++i)
+            {
+                auto const found{ map.findExistingOrCandidate(keys[i]).second };
+                expect(found == (1 == (i % 2))) << "Bad lookup for " << keys[i];
+            }
+        };
+
+        // The odd keys are left: an even one's bound is the next key.
+        "lower_bound"_test = [&]
+        {
+            for (std::size_t i{ 0 }; i < keys_number; i += 997)
+            {
+                auto const bound{ map.lowerBound(keys[i]) };
+                auto const& expected{ keys[i + (1 - (i % 2))] };
+                expect((nullptr != bound) and (expected == bound->first)) << "Bad bound of " << keys[i];
+            }
+
+            expect(nullptr == map.lowerBound(keys.back() + "~")) << "A bound past the greatest key!";
+            expect(keys[1] == map.lowerBound(std::string{})->first) << "The least key isn't the bound of none!";
+        };
+    };
+
+    "rebuild_is_balanced"_test = []
+    {
+        constexpr std::size_t max_keys_number{ 100'000 };
+        auto const keys{ generateSortedKeys(max_keys_number) };
+        auto storage{ std::make_unique<TestNode[]>(max_keys_number) };
+
+        // Every size up to a few 2-3 tree levels, then a big one: the shapes differ w/ the size.
+        std::vector<std::size_t> sizes(300);
+        std::iota(sizes.begin(), sizes.end(), 0);
+        sizes.push_back(max_keys_number);
+
+        std::mt19937_64 rng{ 42 };
+        for (auto const keys_number : sizes)
+        {
+            std::vector<TestNode*> nodes(keys_number);
+            for (std::size_t i{ 0 }; i < keys_number; ++i)
+            {
+                storage[i].first  = keys[i];
+                storage[i].second = static_cast<std::uint32_t>(i);
+                nodes[i]          = &storage[i];
+            }
+
+            std::shuffle(nodes.begin(), nodes.end(), rng);
+
+            TestMap map{ max_keys_number };
+            map.rebuild(nodes);
+
+            expect(keys_number == map.size()) << "Bad size!";
+            expect(map.depth() <= maxBalancedDepth(keys_number)) << "Too deep: " << map.depth();
+
+            std::size_t visited{ 0 };
+            map.forEach(
+                [&] (TestNode const* node)
+                {
+                    expect(node == &storage[visited]) << "Out of order at " << visited;
+                    ++visited;
+                } // lambda
+            );
+            expect(keys_number == visited) << "Bad walk!";
+
+            // The rebuilt tree has to be a valid one for the updates that rebalance it as well.
+            for (std::size_t i{ 0 }; i < keys_number; i += 2)
+            { expect(map.erase(keys[i])) << "Haven't erased " << keys[i]; }
+
+            for (std::size_t i{ 0 }; i < keys_number; ++i)
+            {
+                auto const node{ map.findOptimistic(keys[i]) };
+                expect((nullptr != node) == (1 == (i % 2))) << "Bad lookup for " << keys[i];
+            }
+
+            expect(map.depth() <= maxBalancedDepth(keys_number / 2)) << "Too deep after erasing!";
+        }
+    };
+
+    "static_policy"_test = []
+    {
+        constexpr std::size_t keys_number{ 1'000 };
+        auto const keys{ generateSortedKeys(keys_number) };
+        auto storage{ std::make_unique<TestNode[]>(keys_number) };
+
+        // The same nodes as the callbacks' map: the node types don't depend on the policy.
+        core::FlatLLRBMap<std::string, std::uint32_t, TestNode, CountingPolicy> map{
+            keys_number,
+            CountingPolicy{ storage.get(), keys_number }
+        };
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        { map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i)); }
+
+        for (std::size_t i{ 0 }; i < keys_number; i += 2)
+        { map.insertOrUpdate(keys[i], 0); }
+
+        expect(keys_number == map.size()) << "Bad size!";
+        expect(keys_number == map.getPolicy().created) << "Bad number of creates!";
+        expect((keys_number / 2) == map.getPolicy().updated) << "Bad number of updates!";
+        expect(0 == map.at(keys[0])) << "Not updated!";
+        expect(1 == map.at(keys[1])) << "Bad value!";
+
+        auto refused{ false };
+        try
+        {
+            map.insertOrUpdate("one.too.many", 0);
+        }
+        catch (std::bad_alloc const&)
+        { refused = true; }
+
+        expect(refused) << "Inserted w/o a node!";
+        expect(keys_number == map.getPolicy().created) << "Created w/o a node!";
+    };
+
+    "compact_links"_test = []
+    {
+        static_assert(sizeof(CompactMap::NodeTrait) < sizeof(TestMap::NodeTrait));
+
+        // Two slabs, the first one over more than a block: the second's slots don't follow on from it.
+        constexpr std::size_t keys_number{ 10'000 };
+        constexpr std::size_t first_slab{ 3 * core::SlotTable<CompactNode>::BLOCK_SIZE / 2 };
+        auto const keys{ generateSortedKeys(keys_number) };
+
+        std::unique_ptr<CompactNode[]> slabs[]{
+            std::make_unique<CompactNode[]>(first_slab),
+            std::make_unique<CompactNode[]>(keys_number - first_slab)
+        };
+
+        core::SlotTable<CompactNode> slots{};
+        std::vector<CompactNode*> free_nodes{};
+        for (auto const& [slab, count] : { std::pair{ slabs[0].get(), first_slab },
+                                           std::pair{ slabs[1].get(), keys_number - first_slab } })
+        {
+            auto const first{ slots.add(slab, count) };
+            for (std::size_t i{ 0 }; i < count; ++i)
+            {
+                slab[i].slot = static_cast<std::uint32_t>(first + i);
+                free_nodes.push_back(&slab[i]);
+            }
+        }
+
+        // Shuffled: the links cross from a slab to the other all the time.
+        std::shuffle(free_nodes.begin(), free_nodes.end(), std::mt19937_64{ 42 });
+
+        CompactMap map{ keys_number, core::CallbackPolicy<CompactNode>{}, CompactLinks{ &slots } };
+        map.setAllocateCallback([&] () -> CompactNode*
+        {
+            auto const node{ free_nodes.back() };
+            free_nodes.pop_back();
+            return node;
+        });
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        { map.insertOrUpdate(keys[i], static_cast<std::uint32_t>(i)); }
+
+        expect(keys_number == map.size()) << "Bad size!";
+        expect(map.depth() <= maxBalancedDepth(keys_number)) << "Too deep: " << map.depth();
+
+        for (std::size_t i{ 0 }; i < keys_number; i += 2)
+        { expect(map.erase(keys[i])) << "Haven't erased " << keys[i]; }
+
+        expect((keys_number / 2) == map.size()) << "Bad size after erasing!";
+        expect(map.depth() <= maxBalancedDepth(keys_number / 2)) << "Too deep: " << map.depth();
+
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        {
+            auto const found{ map.findExistingOrCandidate(keys[i]).second };
+            expect(found == (1 == (i % 2))) << "Bad lookup for " << keys[i];
+        }
+
+        expect(keys[1] == map.lowerBound(keys[0])->first) << "Bad bound of " << keys[0];
+        expect(static_cast<std::uint32_t>(keys_number - 1) == map.at(keys.back())) << "Bad value!";
+    };
+}
@@ -0,0 +1,56 @@
+#include <core/frequency_sketch.hpp>
+
+#include <boost/ut.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+auto keyHash(std::size_t i) -> std::uint64_t
+{ return std::hash<std::string>{}("subd" + std::to_string(i) + ".test.domain"); }
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
+{
+    using namespace boost::ut::literals;
+    using namespace boost::ut;
+
+    "estimates"_test = []
+    {
+        constexpr std::size_t keys_number{ 1'024 };
+        core::FrequencySketch sketch{ keys_number };
+
+        // Key i is seen i % 16 times.
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        {
+            for (std::size_t times{ 0 }; times < (i % 16); ++times)
+            { sketch.increment(keyHash(i)); }
+        }
+
+        std::size_t overestimated{ 0 };
+        for (std::size_t i{ 0 }; i < keys_number; ++i)
+        {
+            auto const estimate{ sketch.estimate(keyHash(i)) };
+            expect(estimate >= (i % 16)) << "Key #" << i << " is underestimated!";
+            overestimated += ((estimate > (i % 16)) ? 1 : 0);
+        }
+
+        expect(overestimated < (keys_number / 20)) << overestimated << " keys are overestimated!";
+    };
+
+    "saturates_and_ages"_test = []
+    {
+        constexpr std::size_t keys_number{ 64 };
+        core::FrequencySketch sketch{ keys_number };
+
+        for (std::size_t times{ 0 }; times < 100; ++times)
+        { sketch.increment(keyHash(0)); }
+
+        expect(15 == sketch.estimate(keyHash(0))) << "A 4-bit counter hasn't saturated at 15!";
+
+        // Enough distinct keys to reach the sample size (10 per tracked key) halves everything.
+        for (std::size_t i{ 1 }; i <= (10 * keys_number); ++i)
+        { sketch.increment(keyHash(i)); }
+
+        expect(sketch.estimate(keyHash(0)) <= 7) << "The counters haven't aged!";
+    };
+}
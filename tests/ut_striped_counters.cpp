@@ -0,0 +1,43 @@
+#include <core/striped_counters.hpp>
+
+#include <boost/ut.hpp>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
+{
+    using namespace boost::ut::literals;
+    using namespace boost::ut;
+
+    // More threads than stripes, so some of them share one.
+    "sums_over_threads"_test = []
+    {
+        constexpr std::size_t stripes_number{ 4 };
+        constexpr std::size_t threads_number{ 2 * stripes_number + 1 };
+        constexpr std::uint64_t adds_per_thread{ 100'000 };
+
+        core::StripedCounters<2, stripes_number> counters;
+        std::vector<std::thread> threads;
+        for (std::size_t t{ 0 }; t < threads_number; ++t)
+        {
+            threads.emplace_back(
+                [&counters]
+                {
+                    for (std::uint64_t i{ 0 }; i < adds_per_thread; ++i)
+                    {
+                        counters.add(0);
+                        counters.add(1, 3);
+                    }
+                } // lambda
+            );
+        }
+
+        for (auto& thread : threads)
+        { thread.join(); }
+
+        expect(threads_number * adds_per_thread == counters.sum(0)) << "Lost adds: " << counters.sum(0);
+        expect(3 * threads_number * adds_per_thread == counters.sum(1)) << "Lost adds: " << counters.sum(1);
+    };
+}
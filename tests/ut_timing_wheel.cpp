@@ -0,0 +1,159 @@
+#include <core/links.hpp>
+#include <core/timing_wheel.hpp>
+
+#include <boost/ut.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+struct TestNode
+    : public core::TimingWheel<TestNode>::NodeTrait
+{
+    std::uint64_t due{};
+    bool          fired{ false };
+}; // TestNode
+
+using TestWheel = core::TimingWheel<TestNode>;
+
+struct CompactNode
+    : public core::TimingWheel<CompactNode, core::CompactLinks<CompactNode>>::NodeTrait
+{
+    std::uint32_t slot{};
+    std::uint64_t due{};
+    bool          fired{ false };
+}; // CompactNode
+
+using CompactWheel = core::TimingWheel<CompactNode, core::CompactLinks<CompactNode>>;
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) -> int
+{
+    using namespace boost::ut::literals;
+    using namespace boost::ut;
+
+    // Delays spread over all the levels, checked against the exact due ticks.
+    "fires_on_time"_test = []
+    {
+        constexpr std::size_t timers_number{ 10'000 };
+        constexpr std::uint64_t start{ 1'234'567 };
+
+        auto nodes{ std::make_unique<TestNode[]>(timers_number) };
+        TestWheel wheel{ start };
+
+        std::mt19937_64 rng{ 42 };
+        for (std::size_t i{ 0 }; i < timers_number; ++i)
+        {
+            auto const delay_bits{ rng() % 40 };
+            nodes[i].due = start + 1 + (rng() % (std::uint64_t{ 1 } << delay_bits));
+            wheel.schedule(&nodes[i], nodes[i].due);
+        }
+
+        // Cancel every tenth, reschedule every seventh.
+        for (std::size_t i{ 0 }; i < timers_number; i += 10)
+        { wheel.cancel(&nodes[i]); }
+        for (std::size_t i{ 3 }; i < timers_number; i += 7)
+        {
+            nodes[i].due = start + 1 + (rng() % 100'000);
+            wheel.schedule(&nodes[i], nodes[i].due);
+        }
+
+        std::size_t late_or_early{ 0 };
+        auto const expire{
+            [&] (TestNode* node)
+            {
+                late_or_early += ((node->due != wheel.now()) ? 1 : 0);
+                node->fired = true;
+            } // lambda
+        };
+
+        // Irregular steps, including long idle gaps.
+        for (auto now{ start }; 0 < wheel.size(); )
+        {
+            now += 1 + (rng() % 3 == 0 ? (rng() % (std::uint64_t{ 1 } << (rng() % 40))) : (rng() % 50));
+            wheel.advance(now, expire);
+            expect(wheel.now() == now) << "The wheel hasn't got to " << now;
+        }
+
+        expect(0 == late_or_early) << late_or_early << " timers fired at a wrong tick!";
+
+        for (std::size_t i{ 0 }; i < timers_number; ++i)
+        {
+            auto const cancelled{ (0 == (i % 10)) and (3 != (i % 7)) };
+            expect(cancelled != nodes[i].fired) << "Timer #" << i << " was wrongly (not) fired!";
+        }
+    };
+
+    "past_and_far_future"_test = []
+    {
+        TestNode past{};
+        TestNode far{};
+        TestWheel wheel{ 1'000 };
+
+        past.due = 1'001;
+        wheel.schedule(&past, 10);
+
+        far.due = std::uint64_t{ 1 } << 50;
+        wheel.schedule(&far, far.due);
+
+        std::vector<std::uint64_t> fired_at;
+        auto const expire{ [&] (TestNode*) { fired_at.push_back(wheel.now()); } };
+
+        wheel.advance(1'001, expire);
+        expect((1 == fired_at.size()) and (1'001 == fired_at.back())) << "A past due timer isn't fired next!";
+
+        wheel.advance((std::uint64_t{ 1 } << 50) - 1, expire);
+        expect(1 == fired_at.size()) << "A timer beyond the horizon has fired early!";
+
+        wheel.advance(std::uint64_t{ 1 } << 51, expire);
+        expect((2 == fired_at.size()) and (far.due == fired_at.back())) << "A far timer is late or lost!";
+    };
+
+    // W/ the links as slots, over two slabs whose slots don't follow on from each other's.
+    "compact_links"_test = []
+    {
+        static_assert(sizeof(CompactWheel::NodeTrait) < sizeof(TestWheel::NodeTrait));
+
+        constexpr std::size_t slab_size{ core::SlotTable<CompactNode>::BLOCK_SIZE + 3 };
+        constexpr std::uint64_t start{ 1'000 };
+        std::unique_ptr<CompactNode[]> slabs[]{ std::make_unique<CompactNode[]>(slab_size),
+                                                std::make_unique<CompactNode[]>(slab_size) };
+
+        core::SlotTable<CompactNode> slots{};
+        CompactWheel wheel{ start, core::CompactLinks<CompactNode>{ &slots } };
+
+        std::mt19937_64 rng{ 42 };
+        for (auto const& slab : slabs)
+        {
+            auto const first{ slots.add(slab.get(), slab_size) };
+            for (std::size_t i{ 0 }; i < slab_size; ++i)
+            {
+                slab[i].slot = static_cast<std::uint32_t>(first + i);
+                slab[i].due  = start + 1 + (rng() % 10'000);
+                wheel.schedule(&slab[i], slab[i].due);
+            }
+        }
+
+        // Cancelled from the middle of the slots' lists, the first slab's every third.
+        for (std::size_t i{ 0 }; i < slab_size; i += 3)
+        { wheel.cancel(&slabs[0][i]); }
+
+        std::size_t late_or_early{ 0 };
+        wheel.advance(
+            start + 10'000,
+            [&] (CompactNode* node)
+            {
+                late_or_early += ((node->due != wheel.now()) ? 1 : 0);
+                node->fired = true;
+            } // lambda
+        );
+
+        expect(0 == wheel.size()) << "Timers left: " << wheel.size();
+        expect(0 == late_or_early) << late_or_early << " timers fired at a wrong tick!";
+        for (std::size_t i{ 0 }; i < slab_size; ++i)
+        {
+            expect((0 != (i % 3)) == slabs[0][i].fired) << "Timer #" << i << " was wrongly (not) fired!";
+            expect(slabs[1][i].fired) << "Timer #" << i << " of the second slab wasn't fired!";
+        }
+    };
+}
@@ -0,0 +1,617 @@
+#include <net/dns_cache.hpp>
+#include <net/util.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// The binary traces' first bytes, see TraceReader.
+constexpr char BINARY_MAGIC[]{ 'D', 'N', 'S', 'R', 'P', 'L', 'Y', '1' };
+
+// The queries parsed ahead of the cache at once: the replay's timed w/o the parsing.
+constexpr std::size_t BATCH_SIZE{ 4096 };
+
+enum class AnswerKind : std::uint8_t
+{
+    A,
+    AAAA,
+    NXDOMAIN,
+    NODATA
+
+}; // AnswerKind
+
+///
+/// \brief The Query struct is a trace's line: the name asked for, when, and what upstream answered.
+///
+struct Query
+{
+    std::uint64_t timestamp_us{};
+    AnswerKind    kind{ AnswerKind::A };
+    net::IPV6Raw  address{}; // An A's in the first 4 bytes.
+    net::FQDN     fqdn{};
+};
+
+///
+/// \brief The TraceReader class streams the queries of a trace, a line at a time, in either format:
+///  - text: `timestamp fqdn answer` lines, the timestamp in seconds (w/ a fraction, if need be), the answer
+///    an IPv4 or IPv6 address, `NXDOMAIN` or `NODATA`. The blank lines and the `#` ones are ignored, the
+///    malformed ones (and the names longer than net::MAX_FQDN_LENGTH) skipped and counted;
+///  - binary: BINARY_MAGIC, then the records one after another: the timestamp in microseconds (8 bytes),
+///    the AnswerKind (1 byte), the name's length (1 byte), the address (4 bytes for A, 16 for AAAA, none
+///    for the negative answers) and the name. The numbers are in the host's byte order: see --convert.
+///
+/// The format's told by the first bytes.
+///
+class TraceReader
+{
+private:
+    std::ifstream input;
+    bool          binary{ false };
+    std::string   line{};
+    std::string   answer{};
+    std::uint64_t skipped{ 0 };
+
+public:
+    ///
+    /// \throws std::runtime_error if the trace can't be opened.
+    ///
+    explicit TraceReader(std::string const& path)
+        : input{ path, std::ios::binary }
+    {
+        if (not this->input)
+        { throw std::runtime_error{ "Can't open " + path }; }
+
+        char magic[sizeof(BINARY_MAGIC)]{};
+        this->input.read(magic, sizeof(magic));
+        this->binary = (sizeof(magic) == static_cast<std::size_t>(this->input.gcount())) and
+                       (0 == std::memcmp(magic, BINARY_MAGIC, sizeof(magic)));
+
+        if (not this->binary)
+        {
+            this->input.clear();
+            this->input.seekg(0);
+        }
+    }
+
+    ///
+    /// \return Whether there was a query left to read into `query`.
+    /// \throws std::runtime_error if a binary trace's malformed: there's no telling where the next record is.
+    ///
+    auto read(Query& query) -> bool
+    { return this->binary ? this->readBinary(query) : this->readText(query); }
+
+    [[nodiscard]]
+    auto skippedNumber() const -> std::uint64_t
+    { return this->skipped; }
+
+private:
+    auto readText(Query& query) -> bool
+    {
+        while (std::getline(this->input, this->line))
+        {
+            auto const first{ this->line.find_first_not_of(" \t\r") };
+            if ((std::string::npos == first) or ('#' == this->line[first]))
+            { continue; }
+
+            if (this->parseLine(first, query))
+            { return true; }
+
+            ++this->skipped;
+        }
+
+        return false;
+    }
+
+    auto parseLine(std::size_t const first, Query& query) -> bool
+    {
+        constexpr std::string_view BLANKS{ " \t\r" };
+        std::string_view const text{ this->line };
+
+        char* end{};
+        auto const seconds{ std::strtod(this->line.c_str() + first, &end) };
+        auto const seconds_end{ static_cast<std::size_t>(end - this->line.c_str()) };
+        if ((first == seconds_end) or (std::string_view::npos == BLANKS.find(*end)) or not (0 <= seconds))
+        { return false; }
+
+        auto const name_begin{ text.find_first_not_of(BLANKS, seconds_end) };
+        if (std::string::npos == name_begin)
+        { return false; }
+
+        auto const name_end{ std::min(text.find_first_of(BLANKS, name_begin), text.size()) };
+        auto const answer_begin{ text.find_first_not_of(BLANKS, name_end) };
+        if (std::string::npos == answer_begin)
+        { return false; }
+
+        auto name{ text.substr(name_begin, name_end - name_begin) };
+        if ((1 < name.size()) and ('.' == name.back()))
+        { name.remove_suffix(1); }
+
+        if (net::MAX_FQDN_LENGTH < name.size())
+        { return false; }
+
+        auto const answer_end{ std::min(text.find_first_of(BLANKS, answer_begin), text.size()) };
+        this->answer.assign(text.substr(answer_begin, answer_end - answer_begin));
+        if (not this->parseAnswer(query))
+        { return false; }
+
+        query.timestamp_us = static_cast<std::uint64_t>(std::llround(seconds * 1'000'000.0));
+        query.fqdn.assign(name);
+        return true;
+    }
+
+    auto parseAnswer(Query& query) -> bool
+    {
+        if ("NXDOMAIN" == this->answer)
+        { query.kind = AnswerKind::NXDOMAIN; }
+        else if ("NODATA" == this->answer)
+        { query.kind = AnswerKind::NODATA; }
+        else if (std::string::npos != this->answer.find(':'))
+        {
+            auto const ipv6{ net::strToIPV6Raw(this->answer) };
+            if (not ipv6.has_value())
+            { return false; }
+
+            query.kind    = AnswerKind::AAAA;
+            query.address = *ipv6;
+        }
+        else
+        {
+            auto const ipv4{ net::strToIPV4Raw(this->answer) };
+            if (not ipv4.has_value())
+            { return false; }
+
+            query.kind = AnswerKind::A;
+            std::memcpy(query.address.data(), &*ipv4, sizeof(*ipv4));
+        }
+
+        return true;
+    }
+
+    auto readBinary(Query& query) -> bool
+    {
+        std::uint8_t header[sizeof(query.timestamp_us) + 2]{};
+        this->input.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (0 == this->input.gcount())
+        { return false; }
+
+        if (sizeof(header) != static_cast<std::size_t>(this->input.gcount()))
+        { throw std::runtime_error{ "Truncated binary trace!" }; }
+
+        std::memcpy(&query.timestamp_us, header, sizeof(query.timestamp_us));
+        auto const kind{ header[sizeof(query.timestamp_us)] };
+        auto const name_length{ header[sizeof(query.timestamp_us) + 1] };
+        if (static_cast<std::uint8_t>(AnswerKind::NODATA) < kind)
+        { throw std::runtime_error{ "Bad answer kind in the binary trace!" }; }
+
+        query.kind = static_cast<AnswerKind>(kind);
+        std::size_t const address_size{
+            (AnswerKind::A == query.kind) ? 4 : ((AnswerKind::AAAA == query.kind) ? query.address.size() : 0)
+        };
+
+        query.fqdn.resize(name_length);
+        auto const address{ reinterpret_cast<char*>(query.address.data()) };
+        this->input.read(address, static_cast<std::streamsize>(address_size));
+        this->input.read(query.fqdn.data(), name_length);
+        if (not this->input)
+        { throw std::runtime_error{ "Truncated binary trace!" }; }
+
+        return true;
+    }
+
+}; // TraceReader
+
+auto writeBinary(std::ostream& output, Query const& query) -> void
+{
+    auto const kind{ static_cast<std::uint8_t>(query.kind) };
+    auto const name_length{ static_cast<std::uint8_t>(query.fqdn.size()) };
+    std::size_t const address_size{
+        (AnswerKind::A == query.kind) ? 4 : ((AnswerKind::AAAA == query.kind) ? query.address.size() : 0)
+    };
+
+    output.write(reinterpret_cast<char const*>(&query.timestamp_us), sizeof(query.timestamp_us));
+    output.write(reinterpret_cast<char const*>(&kind), sizeof(kind));
+    output.write(reinterpret_cast<char const*>(&name_length), sizeof(name_length));
+    output.write(reinterpret_cast<char const*>(query.address.data()), static_cast<std::streamsize>(address_size));
+    output.write(query.fqdn.data(), name_length);
+}
+
+///
+/// \brief The Config struct is a cache to replay a trace against: `capacity[:shards[:admission[:negative]]]`,
+/// the admission `always` or `tiny-lfu`, the negative capacity the negative answers' budget.
+///
+struct Config
+{
+    std::string               spec{};
+    core::Capacity            capacity{};
+    core::Size                shards{ 1 };
+    net::DNSCache::Admission  admission{ net::DNSCache::Admission::ALWAYS };
+    core::Capacity            negative_capacity{ 0 };
+};
+
+auto parseConfig(std::string const& spec) -> Config
+{
+    Config config{};
+    config.spec = spec;
+
+    std::vector<std::string> fields{};
+    std::istringstream stream{ spec };
+    for (std::string field{}; std::getline(stream, field, ':'); )
+    { fields.push_back(field); }
+
+    auto const number{
+        [&] (std::size_t const i) -> std::size_t
+        {
+            char* end{};
+            auto const value{ std::strtoull(fields[i].c_str(), &end, 10) };
+            if (fields[i].empty() or ('\0' != *end))
+            { throw std::invalid_argument{ "Bad number in config " + spec + ": " + fields[i] }; }
+
+            return static_cast<std::size_t>(value);
+        } // lambda
+    };
+
+    if (fields.empty() or (4 < fields.size()))
+    { throw std::invalid_argument{ "Bad config: " + spec }; }
+
+    config.capacity = number(0);
+    if (1 < fields.size())
+    { config.shards = number(1); }
+
+    if (2 < fields.size())
+    {
+        if ("tiny-lfu" == fields[2])
+        { config.admission = net::DNSCache::Admission::TINY_LFU; }
+        else if ("always" != fields[2])
+        { throw std::invalid_argument{ "Bad admission in config " + spec + ": " + fields[2] }; }
+    }
+
+    if (3 < fields.size())
+    { config.negative_capacity = number(3); }
+
+    return config;
+}
+
+///
+/// \brief The Totals struct is what a replay's come to, over an interval or the whole trace.
+///
+struct Totals
+{
+    std::uint64_t            queries{};
+    std::uint64_t            hits{};
+    std::uint64_t            evictions{};
+    std::chrono::nanoseconds elapsed{};
+};
+
+auto operator - (Totals const& lhs, Totals const& rhs) -> Totals
+{
+    return Totals{ lhs.queries - rhs.queries, lhs.hits - rhs.hits, lhs.evictions - rhs.evictions,
+                   lhs.elapsed - rhs.elapsed };
+}
+
+auto hitRatioOf(Totals const& totals) -> double
+{
+    return (0 == totals.queries) ? 0.0 : (static_cast<double>(totals.hits) / static_cast<double>(totals.queries));
+}
+
+// The replays' threads print their rows as they go.
+std::mutex output_mutex{};
+
+auto printRow(std::string const& label, std::string const& when, Totals const& totals, double const total_ratio)
+    -> void
+{
+    auto const ratio{ hitRatioOf(totals) };
+    auto const seconds{ std::chrono::duration<double>(totals.elapsed).count() };
+
+    std::lock_guard<std::mutex> const lock{ output_mutex };
+    std::cout << std::left << std::setw(28) << label << std::right << std::setw(12) << when
+              << std::setw(14) << totals.queries << std::fixed << std::setprecision(4)
+              << std::setw(10) << ratio << std::setw(10) << total_ratio << std::setw(14);
+
+    if (net::DNSCache::statsEnabled())
+    { std::cout << totals.evictions; }
+    else
+    { std::cout << "n/a"; }
+
+    std::cout << std::setprecision(0) << std::setw(14)
+              << ((0.0 < seconds) ? (static_cast<double>(totals.queries) / seconds) : 0.0) << '\n';
+}
+
+auto printHeader() -> void
+{
+    std::cout << std::left << std::setw(28) << "config" << std::right << std::setw(12) << "trace time"
+              << std::setw(14) << "queries" << std::setw(10) << "hits" << std::setw(10) << "hits all"
+              << std::setw(14) << "evictions" << std::setw(14) << "ops/s" << '\n';
+}
+
+///
+/// \brief The Replay class drives a cache w/ a trace the way a resolver would: a query that misses is
+/// answered upstream, and the answer's cached.
+/// \details The trace's TTLs aren't known and the cache expires by the wall clock, which the replay runs
+/// far ahead of: the positive answers are cached w/o a TTL, the negative ones w/ MAX_NEGATIVE_TTL. What's
+/// measured is what the capacity and the admission leave cached.
+///
+class Replay
+{
+private:
+    Config                 config;
+    net::DNSCache          dns_cache;
+    std::chrono::seconds   interval;
+    Totals                 totals{};
+    Totals                 reported{};
+    std::uint64_t          skipped{ 0 };
+
+public:
+    Replay(Config config, std::chrono::seconds const interval)
+        : config{ std::move(config) }
+        , dns_cache{ this->config.capacity, this->config.shards, this->config.admission,
+                     this->config.negative_capacity }
+        , interval{ interval }
+    {}
+
+    ///
+    /// \brief run streams the trace through the cache, printing a row every `interval` of the trace's time.
+    ///
+    auto run(std::string const& path) -> void
+    {
+        TraceReader reader{ path };
+        std::vector<Query> batch(BATCH_SIZE);
+
+        auto const interval_us{ static_cast<std::uint64_t>(this->interval.count()) * 1'000'000 };
+        std::uint64_t start_us{ 0 };
+        std::uint64_t next_report_us{ 0 };
+
+        for (auto count{ this->readBatch(reader, batch) }; 0 < count; count = this->readBatch(reader, batch))
+        {
+            if (0 == this->totals.queries)
+            {
+                start_us       = batch[0].timestamp_us;
+                next_report_us = start_us + interval_us;
+            }
+
+            for (std::size_t begin{ 0 }; begin < count; )
+            {
+                auto end{ begin };
+                while ((end < count) and (batch[end].timestamp_us < next_report_us))
+                { ++end; }
+
+                this->replay(batch.data() + begin, batch.data() + end);
+                begin = end;
+
+                if (end < count)
+                {
+                    this->report(next_report_us - start_us);
+
+                    // Past a quiet spell, if there's been one: the row covers it.
+                    auto const since_start{ batch[end].timestamp_us - start_us };
+                    next_report_us = start_us + (since_start - since_start % interval_us) + interval_us;
+                }
+            }
+        }
+
+        this->skipped = reader.skippedNumber();
+        if (this->totals.queries != this->reported.queries)
+        { this->report(std::nullopt); }
+    }
+
+    [[nodiscard]]
+    auto getConfig() const -> Config const&
+    { return this->config; }
+
+    [[nodiscard]]
+    auto getTotals() const -> Totals const&
+    { return this->totals; }
+
+    [[nodiscard]]
+    auto skippedNumber() const -> std::uint64_t
+    { return this->skipped; }
+
+private:
+    static auto readBatch(TraceReader& reader, std::vector<Query>& batch) -> std::size_t
+    {
+        std::size_t count{ 0 };
+        while ((count < batch.size()) and reader.read(batch[count]))
+        { ++count; }
+
+        return count;
+    }
+
+    auto replay(Query const* begin, Query const* end) -> void
+    {
+        auto const started{ std::chrono::steady_clock::now() };
+        for (auto query{ begin }; query != end; ++query)
+        {
+            if (net::DNSCache::Outcome::MISS != this->dns_cache.lookup(query->fqdn).outcome)
+            {
+                ++this->totals.hits;
+                continue;
+            }
+
+            this->answer(*query);
+        }
+
+        this->totals.elapsed += std::chrono::steady_clock::now() - started;
+        this->totals.queries += static_cast<std::uint64_t>(end - begin);
+    }
+
+    auto answer(Query const& query) -> void
+    {
+        switch (query.kind)
+        {
+            case AnswerKind::A:
+            {
+                net::IPV4Raw ipv4{};
+                std::memcpy(&ipv4, query.address.data(), sizeof(ipv4));
+                this->dns_cache.update(query.fqdn, ipv4);
+                break;
+            }
+
+            case AnswerKind::AAAA:
+            {
+                this->dns_cache.update(query.fqdn, core::Span<net::IPV4Raw const>{},
+                                       core::Span<net::IPV6Raw const>{ &query.address, 1 });
+                break;
+            }
+
+            case AnswerKind::NXDOMAIN:
+            { this->dns_cache.updateNegative(query.fqdn, net::Negative::NXDOMAIN, net::MAX_NEGATIVE_TTL); break; }
+
+            case AnswerKind::NODATA:
+            { this->dns_cache.updateNegative(query.fqdn, net::Negative::NODATA, net::MAX_NEGATIVE_TTL); break; }
+        }
+    }
+
+    auto report(std::optional<std::uint64_t> const trace_time_us) -> void
+    {
+        this->totals.evictions = this->dns_cache.stats().evictions;
+
+        std::string when{ "end" };
+        if (trace_time_us.has_value())
+        { when = std::to_string(*trace_time_us / 1'000'000) + "s"; }
+
+        printRow(this->config.spec, when, this->totals - this->reported, hitRatioOf(this->totals));
+        this->reported = this->totals;
+    }
+
+}; // Replay
+
+auto convert(std::string const& text_path, std::string const& binary_path) -> int
+{
+    TraceReader reader{ text_path };
+    std::ofstream output{ binary_path, std::ios::binary | std::ios::trunc };
+    output.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+
+    Query query{};
+    std::uint64_t queries{ 0 };
+    while (reader.read(query))
+    {
+        writeBinary(output, query);
+        ++queries;
+    }
+
+    output.flush();
+    if (not output)
+    {
+        std::cerr << "Can't write " << binary_path << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "converted " << queries << " queries, skipped " << reader.skippedNumber() << " lines\n";
+    return EXIT_SUCCESS;
+}
+
+auto printUsage() -> void
+{
+    std::cerr << "usage: dns_cache_replay [--interval seconds] <trace> <config>...\n"
+                 "       dns_cache_replay --convert <text trace> <binary trace>\n"
+                 "config: capacity[:shards[:always|tiny-lfu[:negative capacity]]]\n";
+}
+
+} // anonymous
+
+///
+/// Usage: dns_cache_replay [--interval seconds] <trace> <config>...
+///        dns_cache_replay --convert <text trace> <binary trace>
+///
+/// Replays a recorded query log (see TraceReader for the formats) against a cache per config, all of them at
+/// once, a thread each: e.g. `dns_cache_replay queries.log 100000 1000000:4:tiny-lfu:10000`. Every interval of
+/// the trace's time (60s by default), and at the end, a row per config: the queries, their hit ratio, the
+/// overall one so far, the evictions (w/ DNS_CACHE_STATS) and the cache's ops/s, w/o the trace's parsing.
+/// A config's reader streams the trace itself, so the memory doesn't grow w/ the trace, whatever its length.
+///
+/// --convert turns a text trace into a binary one, which is parsed a lot faster.
+///
+auto main(int argc, char const* argv[]) -> int
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    try
+    {
+        if ((3 == args.size()) and ("--convert" == args[0]))
+        { return convert(args[1], args[2]); }
+
+        std::chrono::seconds interval{ 60 };
+        if ((2 <= args.size()) and ("--interval" == args[0]))
+        {
+            interval = std::chrono::seconds{ std::max(1LL, std::atoll(args[1].c_str())) };
+            args.erase(args.begin(), args.begin() + 2);
+        }
+
+        if (2 > args.size())
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+
+        auto const& path{ args[0] };
+        (void)TraceReader{ path }; // Not to find out it can't be opened once the rows have started.
+
+        std::vector<std::unique_ptr<Replay>> replays{};
+        for (auto arg{ args.begin() + 1 }; arg != args.end(); ++arg)
+        { replays.push_back(std::make_unique<Replay>(parseConfig(*arg), interval)); }
+
+        printHeader();
+
+        std::vector<std::exception_ptr> errors(replays.size());
+        std::vector<std::thread> threads{};
+        for (std::size_t i{ 0 }; i < replays.size(); ++i)
+        {
+            threads.emplace_back(
+                [&, i] ()
+                {
+                    try
+                    {
+                        replays[i]->run(path);
+                    }
+                    catch (...)
+                    { errors[i] = std::current_exception(); }
+                } // lambda
+            );
+        }
+
+        for (auto& thread : threads)
+        { thread.join(); }
+
+        for (auto const& error : errors)
+        {
+            if (nullptr != error)
+            { std::rethrow_exception(error); }
+        }
+
+        std::cout << "\ntotals:\n";
+        printHeader();
+        for (auto const& replay : replays)
+        {
+            auto const& totals{ replay->getTotals() };
+            printRow(replay->getConfig().spec, "all", totals, hitRatioOf(totals));
+        }
+
+        if (auto const skipped{ replays.front()->skippedNumber() };
+            0 < skipped)
+        { std::cout << "skipped " << skipped << " malformed lines\n"; }
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << e.what() << '\n';
+        printUsage();
+        return EXIT_FAILURE;
+    }
+}